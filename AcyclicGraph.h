@@ -0,0 +1,376 @@
+// ---------------------------------
+// projects/c++/graph/AcyclicGraph.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// ---------------------------------
+
+#ifndef AcyclicGraph_h
+#define AcyclicGraph_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // copy, max, sort
+#include <cassert>   // assert
+#include <cstddef>   // size_t
+#include <set>       // set
+#include <utility>   // make_pair, pair
+#include <vector>    // vector
+
+#include "BidirectionalGraph.h"
+#include "Graph.h"
+
+// ----------
+// namespaces
+// ----------
+
+namespace cs {
+
+  template <typename AdjacencySet>
+  class BasicAcyclicGraph;
+
+  template <typename AdjacencySet, typename OI>
+  void topological_sort (const BasicAcyclicGraph<AdjacencySet>&, OI);
+
+  // -----------------
+  // BasicAcyclicGraph
+  // -----------------
+
+  /**
+   * a BasicBidirectionalGraph that stays acyclic: every insertion that
+   * would close a cycle is refused, and a topological order of the
+   * vertices is kept up to date as edges arrive (Pearce and Kelly,
+   * "A Dynamic Topological Sort Algorithm for Directed Acyclic Graphs")
+   * an edge (x, y) with x already before y costs one lookup; otherwise
+   * only the vertices whose position lies between y and x are searched,
+   * forward from y and backward (through the in edges) from x, and the
+   * two sets found are swapped into the positions they already hold
+   * the graph is seeded with the vertices in insertion order, so edges
+   * from older to newer vertices never reorder anything
+   * removing an edge keeps the order valid, so remove_edge is inherited
+   */
+  template <typename AdjacencySet>
+  class BasicAcyclicGraph : public BasicBidirectionalGraph<AdjacencySet> {
+  public:
+    // --------
+    // typedefs
+    // --------
+
+    typedef BasicBidirectionalGraph<AdjacencySet> base_type;
+
+    typedef typename base_type::adjacency_set          adjacency_set;
+    typedef typename base_type::vertex_descriptor      vertex_descriptor;
+    typedef typename base_type::edge_descriptor        edge_descriptor;
+    typedef typename base_type::adjacency_iterator     adjacency_iterator;
+    typedef typename base_type::inv_adjacency_iterator inv_adjacency_iterator;
+    typedef typename base_type::vertices_size_type     vertices_size_type;
+    typedef typename base_type::edges_size_type        edges_size_type;
+
+    // ----------------
+    // add_edge_acyclic
+    // ----------------
+
+    /**
+     * time: O(log d) if x is already before y, otherwise
+     *       O(A log A + the degrees of A) for the A vertices reordered
+     * space: O(A)
+     * adds the edge (x, y) unless it would close a cycle
+     * @return true if the edge is in the graph afterwards, false if it
+     * was refused (x == y, or y already reaches x)
+     */
+    friend bool
+    add_edge_acyclic (vertex_descriptor x, vertex_descriptor y, BasicAcyclicGraph& myG) {
+      assert(x < myG.position.size());
+      assert(y < myG.position.size());
+      if (x == y)
+	return false;
+      if ((myG.position[y] < myG.position[x]) && !myG.reorder(x, y))
+	return false;
+      add_edge(x, y, static_cast<base_type&>(myG));
+      assert(myG.position[x] < myG.position[y]);
+      return true;
+    }
+
+    // --------
+    // add_edge
+    // --------
+
+    /**
+     * time: that of add_edge_acyclic
+     * @return std::pair<edge_descriptor, bool>
+     * bool = false, if the edge already exist inside the graph or would
+     * close a cycle
+     */
+    friend std::pair<edge_descriptor, bool>
+    add_edge (vertex_descriptor x, vertex_descriptor y, BasicAcyclicGraph& myG) {
+      const bool existed = edge(x, y, myG).second;
+      const bool added   = add_edge_acyclic(x, y, myG) && !existed;
+      return std::make_pair(edge_descriptor(x, y), added);
+    }
+
+    // ---------
+    // add_edges
+    // ---------
+
+    /**
+     * time: one add_edge_acyclic per element of [first, last)
+     * vertices are added as needed to cover every endpoint
+     * the edges that would close a cycle are skipped, so the result
+     * depends on the order of the range
+     * @return the number of edges that were not already in the graph
+     */
+    template <typename FI>
+    friend edges_size_type
+    add_edges (FI first, FI last, BasicAcyclicGraph& myG) {
+      edges_size_type inserted = 0;
+      for (; first != last; ++first) {
+	const vertex_descriptor m = std::max(first->first, first->second);
+	while (m >= myG.position.size())
+	  add_vertex(myG);
+	inserted += add_edge(first->first, first->second, myG).second;
+      }
+      return inserted;
+    }
+
+    // ----------
+    // add_vertex
+    // ----------
+
+    /**
+     * time:O(1) amortized
+     * the new vertex goes last in the topological order
+     */
+    friend vertex_descriptor
+    add_vertex (BasicAcyclicGraph& myG) {
+      const vertex_descriptor v = add_vertex(static_cast<base_type&>(myG));
+      myG.position.push_back(v);
+      myG.order.push_back(v);
+      myG.visited.push_back(false);
+      return v;
+    }
+
+    // ----------------
+    // reserve_vertices
+    // ----------------
+
+    friend void
+    reserve_vertices (vertices_size_type n, BasicAcyclicGraph& myG) {
+      reserve_vertices(n, static_cast<base_type&>(myG));
+      myG.position.reserve(n);
+      myG.order.reserve(n);
+      myG.visited.reserve(n);
+    }
+
+    // -----------------
+    // topological_index
+    // -----------------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     * @return the position of v in the maintained topological order;
+     * every edge (u, v) has topological_index(u) < topological_index(v)
+     */
+    friend vertices_size_type
+    topological_index (vertex_descriptor v, const BasicAcyclicGraph& myG) {
+      assert(v < myG.position.size());
+      return myG.position[v];
+    }
+
+    template <typename AS, typename OI>
+    friend void topological_sort (const BasicAcyclicGraph<AS>&, OI);
+
+  private:
+    // ----
+    // data
+    // ----
+
+    std::vector<vertex_descriptor> position; // the place of each vertex in order
+    std::vector<vertex_descriptor> order;    // the vertices, sources first
+
+    // scratch space of reorder, kept between calls to avoid reallocation
+    std::vector<bool>              visited;
+    std::vector<vertex_descriptor> forward;
+    std::vector<vertex_descriptor> backward;
+    std::vector<vertex_descriptor> stack;
+    std::vector<vertex_descriptor> slots;
+
+    // --------
+    // by_order
+    // --------
+
+    struct by_order {
+      const std::vector<vertex_descriptor>& position;
+
+      explicit by_order (const std::vector<vertex_descriptor>& position) : position(position) {}
+
+      bool operator () (vertex_descriptor u, vertex_descriptor v) const {
+	return position[u] < position[v];
+      }
+    };
+
+    // -------
+    // reorder
+    // -------
+
+    /**
+     * makes room for the edge (x, y), with y before x in the order
+     * forward: the descendants of y up to x's position
+     * backward: the ancestors of x down to y's position
+     * if forward reaches x, the edge would close a cycle and nothing moves
+     * otherwise the positions held by both sets are handed out again,
+     * backward first, each set keeping its own relative order
+     * @return false if the edge would close a cycle
+     */
+    bool reorder (vertex_descriptor x, vertex_descriptor y) {
+      const vertex_descriptor lower = position[y];
+      const vertex_descriptor upper = position[x];
+      forward.clear();
+      backward.clear();
+
+      stack.push_back(y);
+      visited[y] = true;
+      while (!stack.empty()) {
+	const vertex_descriptor u = stack.back();
+	stack.pop_back();
+	forward.push_back(u);
+	std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(u, *this);
+	for (; p.first != p.second; ++p.first) {
+	  const vertex_descriptor w = *p.first;
+	  if (w == x) {
+	    unvisit(stack);
+	    unvisit(forward);
+	    stack.clear();
+	    return false;
+	  }
+	  if (!visited[w] && (position[w] < upper)) {
+	    visited[w] = true;
+	    stack.push_back(w);
+	  }
+	}
+      }
+
+      stack.push_back(x);
+      visited[x] = true;
+      while (!stack.empty()) {
+	const vertex_descriptor u = stack.back();
+	stack.pop_back();
+	backward.push_back(u);
+	std::pair<inv_adjacency_iterator, inv_adjacency_iterator> p = inv_adjacent_vertices(u, *this);
+	for (; p.first != p.second; ++p.first) {
+	  const vertex_descriptor w = *p.first;
+	  if (!visited[w] && (position[w] > lower)) {
+	    visited[w] = true;
+	    stack.push_back(w);
+	  }
+	}
+      }
+
+      std::sort(forward.begin(),  forward.end(),  by_order(position));
+      std::sort(backward.begin(), backward.end(), by_order(position));
+      slots.clear();
+      for (std::size_t i = 0; i != backward.size(); ++i)
+	slots.push_back(position[backward[i]]);
+      for (std::size_t i = 0; i != forward.size(); ++i)
+	slots.push_back(position[forward[i]]);
+      std::sort(slots.begin(), slots.end());
+      std::size_t k = 0;
+      for (std::size_t i = 0; i != backward.size(); ++i, ++k)
+	place(backward[i], slots[k]);
+      for (std::size_t i = 0; i != forward.size(); ++i, ++k)
+	place(forward[i], slots[k]);
+      unvisit(backward);
+      unvisit(forward);
+      return true;
+    }
+
+    void place (vertex_descriptor v, vertex_descriptor i) {
+      position[v] = i;
+      order[i]    = v;
+    }
+
+    void unvisit (const std::vector<vertex_descriptor>& vs) {
+      for (std::size_t i = 0; i != vs.size(); ++i)
+	visited[vs[i]] = false;
+    }
+
+    // -----
+    // valid
+    // -----
+
+    bool valid () const {
+      return (position.size() == num_vertices(*this)) && (order.size() == position.size());
+    }
+
+  public:
+    // ------------
+    // constructors
+    // ------------
+
+    BasicAcyclicGraph () {
+      assert(valid());
+    }
+
+    /**
+     * every vertex starts as a copy of prototype
+     */
+    explicit BasicAcyclicGraph (const adjacency_set& prototype) :
+	base_type(prototype) {
+      assert(valid());
+    }
+
+    /**
+     * n vertices plus the edges of [first, last) that keep it acyclic
+     */
+    template <typename FI>
+    BasicAcyclicGraph (vertices_size_type n, FI first, FI last) {
+      reserve_vertices(n, *this);
+      for (vertices_size_type i = 0; i != n; ++i)
+	add_vertex(*this);
+      add_edges(first, last, *this);
+      assert(valid());
+    }
+
+    // Default copy, destructor, and copy assignment
+  };
+
+  // ------------
+  // AcyclicGraph
+  // ------------
+
+  /**
+   * BidirectionalGraph that refuses cycles and keeps a topological order
+   */
+  typedef BasicAcyclicGraph< std::set<unsigned int> > AcyclicGraph;
+
+  // ---------
+  // has_cycle
+  // ---------
+
+  /**
+   * time: O(1)
+   */
+  template <typename AdjacencySet>
+  bool has_cycle (const BasicAcyclicGraph<AdjacencySet>&) {
+    return false;
+  }
+
+  // ----------------
+  // topological_sort
+  // ----------------
+
+  /**
+   * time: O(V)
+   * space: O(1)
+   * the maintained order, without a traversal; like the general
+   * topological_sort, each vertex is written after its descendants
+   */
+  template <typename AdjacencySet, typename OI>
+  void topological_sort (const BasicAcyclicGraph<AdjacencySet>& myG, OI x) {
+    std::copy(myG.order.rbegin(), myG.order.rend(), x);
+  }
+
+} // cs
+
+#endif // AcyclicGraph_h
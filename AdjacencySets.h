@@ -0,0 +1,302 @@
+// ----------------------------------
+// projects/c++/graph/AdjacencySets.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// ----------------------------------
+
+#ifndef AdjacencySets_h
+#define AdjacencySets_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // binary_search, find, inplace_merge, lower_bound, sort, unique
+#include <cstddef>   // size_t
+#include <utility>   // make_pair, pair
+#include <vector>    // vector
+
+// ----------
+// namespaces
+// ----------
+
+namespace cs {
+
+  /*
+   * adjacency sets are the per-vertex containers of cs::BasicGraph
+   * besides std::set, any class with the following subset of the set
+   * interface can be plugged in:
+   *   value_type, size_type, iterator, const_iterator
+   *   std::pair<iterator, bool> insert (const value_type&)
+   *   void insert (first, last), a range of values (used by add_edges)
+   *   size_type erase (const value_type&)
+   *   size_type count (const value_type&) const
+   *   begin (), end (), size (), empty ()
+   */
+
+  // -------
+  // FlatSet
+  // -------
+
+  /**
+   * a sorted, duplicate free std::vector
+   * iteration is a linear walk through contiguous memory and count()
+   * is a binary search; insert and erase shift the tail, O(out degree)
+   * one allocation per vertex instead of one per edge
+   */
+  template <typename T>
+  class FlatSet {
+  public:
+    // --------
+    // typedefs
+    // --------
+
+    typedef T                                        value_type;
+    typedef std::size_t                              size_type;
+    typedef typename std::vector<T>::const_iterator  const_iterator;
+    typedef const_iterator                           iterator;
+
+  private:
+    // ----
+    // data
+    // ----
+
+    std::vector<T> items;
+
+  public:
+    std::pair<iterator, bool> insert (const value_type& v) {
+      typename std::vector<T>::iterator i = std::lower_bound(items.begin(), items.end(), v);
+      if ((i != items.end()) && !(v < *i))
+	return std::make_pair(iterator(i), false);
+      return std::make_pair(iterator(items.insert(i, v)), true);
+    }
+
+    /**
+     * appends the range, then one merge and one dedupe pass
+     * O(size + k log k) instead of k shifting inserts
+     */
+    template <typename II>
+    void insert (II first, II last) {
+      const size_type n = items.size();
+      items.insert(items.end(), first, last);
+      std::sort(items.begin() + n, items.end());
+      std::inplace_merge(items.begin(), items.begin() + n, items.end());
+      items.erase(std::unique(items.begin(), items.end()), items.end());
+    }
+
+    size_type erase (const value_type& v) {
+      typename std::vector<T>::iterator i = std::lower_bound(items.begin(), items.end(), v);
+      if ((i == items.end()) || (v < *i))
+	return 0;
+      items.erase(i);
+      return 1;
+    }
+
+    size_type count (const value_type& v) const {
+      return std::binary_search(items.begin(), items.end(), v);
+    }
+
+    const_iterator begin () const {
+      return items.begin();
+    }
+
+    const_iterator end () const {
+      return items.end();
+    }
+
+    size_type size () const {
+      return items.size();
+    }
+
+    bool empty () const {
+      return items.empty();
+    }
+  };
+
+  // -------
+  // HashSet
+  // -------
+
+  /**
+   * the elements live in a dense std::vector (iteration stays contiguous)
+   * indexed by an open-addressing, linear-probing table of positions
+   * small sets (the common case) skip the table and scan the vector;
+   * the table is only built once a vertex has more than linear_limit
+   * neighbours, which makes count() O(1) for hub vertices
+   * iteration follows insertion order until an erase, which moves the
+   * last element into the hole
+   */
+  template <typename T>
+  class HashSet {
+  public:
+    // --------
+    // typedefs
+    // --------
+
+    typedef T                                        value_type;
+    typedef std::size_t                              size_type;
+    typedef typename std::vector<T>::const_iterator  const_iterator;
+    typedef const_iterator                           iterator;
+
+  private:
+    // ----
+    // data
+    // ----
+
+    enum {linear_limit = 8};
+
+    std::vector<T>            items;
+    std::vector<unsigned int> slots; // 0 is empty, otherwise index into items + 1
+    unsigned int              shift; // 32 - log2(slots.size())
+
+    // ----
+    // home
+    // ----
+
+    /**
+     * Fibonacci hashing, the top bits of v * 2^32 / phi
+     */
+    size_type home (const value_type& v) const {
+      return (static_cast<unsigned int>(v) * 2654435769u) >> shift;
+    }
+
+    // ---------
+    // find_slot
+    // ---------
+
+    /**
+     * @return the slot holding v, or the empty slot ending its probe sequence
+     */
+    size_type find_slot (const value_type& v) const {
+      const size_type mask = slots.size() - 1;
+      size_type       i    = home(v);
+      while (slots[i] && !(items[slots[i] - 1] == v))
+	i = (i + 1) & mask;
+      return i;
+    }
+
+    // ------
+    // rehash
+    // ------
+
+    void rehash (size_type capacity) {
+      slots.assign(capacity, 0);
+      shift = 32;
+      while (capacity > 1) {
+	capacity >>= 1;
+	--shift;
+      }
+      for (size_type j = 0; j != items.size(); ++j)
+	slots[find_slot(items[j])] = static_cast<unsigned int>(j + 1);
+    }
+
+    // ----------
+    // erase_slot
+    // ----------
+
+    /**
+     * backward-shift deletion, keeps every probe sequence unbroken
+     * without tombstones
+     */
+    void erase_slot (size_type i) {
+      const size_type mask = slots.size() - 1;
+      size_type       j    = i;
+      while (true) {
+	j = (j + 1) & mask;
+	if (!slots[j])
+	  break;
+	const size_type k = home(items[slots[j] - 1]);
+	// the entry at j may only move back if its home is not in (i, j]
+	if ((i <= j) ? ((i < k) && (k <= j)) : ((i < k) || (k <= j)))
+	  continue;
+	slots[i] = slots[j];
+	i = j;
+      }
+      slots[i] = 0;
+    }
+
+  public:
+    // ------------
+    // constructors
+    // ------------
+
+    HashSet () : shift(32) {}
+
+    // Default copy, destructor, and copy assignment
+
+    std::pair<iterator, bool> insert (const value_type& v) {
+      if (slots.empty()) {
+	const_iterator i = std::find(begin(), end(), v);
+	if (i != end())
+	  return std::make_pair(i, false);
+	items.push_back(v);
+	if (items.size() > linear_limit)
+	  rehash(4 * linear_limit);
+	return std::make_pair(end() - 1, true);
+      }
+      const size_type i = find_slot(v);
+      if (slots[i])
+	return std::make_pair(begin() + (slots[i] - 1), false);
+      items.push_back(v);
+      if (2 * items.size() > slots.size())
+	rehash(2 * slots.size());
+      else
+	slots[i] = static_cast<unsigned int>(items.size());
+      return std::make_pair(end() - 1, true);
+    }
+
+    template <typename II>
+    void insert (II first, II last) {
+      for (; first != last; ++first)
+	insert(*first);
+    }
+
+    size_type erase (const value_type& v) {
+      size_type j;
+      if (slots.empty()) {
+	j = std::find(begin(), end(), v) - begin();
+	if (j == items.size())
+	  return 0;
+      }
+      else {
+	const size_type i = find_slot(v);
+	if (!slots[i])
+	  return 0;
+	j = slots[i] - 1;
+	erase_slot(i);
+      }
+      if (j != items.size() - 1) {
+	if (!slots.empty())
+	  slots[find_slot(items.back())] = static_cast<unsigned int>(j + 1);
+	items[j] = items.back();
+      }
+      items.pop_back();
+      return 1;
+    }
+
+    size_type count (const value_type& v) const {
+      if (slots.empty())
+	return std::find(begin(), end(), v) != end();
+      return slots[find_slot(v)] != 0;
+    }
+
+    const_iterator begin () const {
+      return items.begin();
+    }
+
+    const_iterator end () const {
+      return items.end();
+    }
+
+    size_type size () const {
+      return items.size();
+    }
+
+    bool empty () const {
+      return items.empty();
+    }
+  };
+
+} // cs
+
+#endif // AdjacencySets_h
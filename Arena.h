@@ -0,0 +1,357 @@
+// --------------------------
+// projects/c++/graph/Arena.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// --------------------------
+
+#ifndef Arena_h
+#define Arena_h
+
+// --------
+// includes
+// --------
+
+#include <cstddef> // ptrdiff_t, size_t
+#include <new>     // new, operator delete, operator new
+#include <vector>  // vector
+
+// ----------
+// namespaces
+// ----------
+
+namespace cs {
+
+  template <typename T>
+  class ArenaAllocator;
+
+  // -----
+  // Arena
+  // -----
+
+  /**
+   * a pool of small blocks carved out of large chunks
+   * requests up to max_small bytes are rounded up to a multiple of
+   * granularity and served from one free list per size, refilled by
+   * bumping a cursor through the current chunk; larger requests go
+   * straight to operator new
+   * chunks start at 4 KB and double up to chunk_limit, so small graphs
+   * stay small; all chunks are returned at once when the arena dies,
+   * whatever was or was not deallocated
+   * allocate and deallocate take a spin lock, so the adjacency sets of
+   * one graph may be filled in parallel (add_edges does)
+   * while discarding, small blocks are dropped instead of going back on
+   * their free list, without the lock; a container that is being torn
+   * down then hands its nodes back for the cost of a branch each, and
+   * their memory goes with the chunks (or is never reused, if other
+   * containers keep the arena alive)
+   */
+  class Arena {
+  private:
+    template <typename T>
+    friend class ArenaAllocator;
+
+    enum {granularity = 8, classes = 32, max_small = granularity * classes, first_chunk = 4096};
+
+    struct free_block {
+      free_block* next;
+    };
+
+    // ----
+    // data
+    // ----
+
+    std::vector<char*> chunks;
+    char*              cursor;
+    char*              limit;
+    std::size_t        chunk_bytes;        // the size of the next chunk
+    std::size_t        chunk_limit;
+    free_block*        free_lists[classes];
+    std::size_t        reserved;           // bytes in chunks
+    long               refs;               // the ArenaAllocators sharing this arena
+    long               discarding;         // the teardowns under way
+    volatile int       busy;
+
+    void lock () {
+      while (__sync_lock_test_and_set(&busy, 1))
+	while (busy) {}
+    }
+
+    void unlock () {
+      __sync_lock_release(&busy);
+    }
+
+    void attach () {
+      __sync_fetch_and_add(&refs, 1);
+    }
+
+    /**
+     * @return true if that was the last reference
+     */
+    bool detach () {
+      return __sync_sub_and_fetch(&refs, 1) == 0;
+    }
+
+    // ----
+    // grow
+    // ----
+
+    /**
+     * the unused tail of the current chunk (less than max_small) is abandoned
+     */
+    void grow () {
+      chunks.push_back(static_cast<char*>(::operator new(chunk_bytes)));
+      cursor      = chunks.back();
+      limit       = cursor + chunk_bytes;
+      reserved   += chunk_bytes;
+      chunk_bytes = (2 * chunk_bytes <= chunk_limit) ? 2 * chunk_bytes : chunk_limit;
+    }
+
+    // no copies, the chunks have a single owner
+    Arena (const Arena&);
+    Arena& operator = (const Arena&);
+
+  public:
+    // ------------
+    // constructors
+    // ------------
+
+    /**
+     * @param chunk_limit the largest chunk requested from operator new
+     */
+    explicit Arena (std::size_t chunk_limit = 1 << 20) :
+	cursor(0), limit(0), chunk_bytes(first_chunk),
+	chunk_limit((chunk_limit < first_chunk) ? first_chunk : chunk_limit),
+	reserved(0), refs(0), discarding(0), busy(0) {
+      for (int i = 0; i != classes; ++i)
+	free_lists[i] = 0;
+    }
+
+    /**
+     * time: O(chunks)
+     */
+    ~Arena () {
+      for (std::size_t i = 0; i != chunks.size(); ++i)
+	::operator delete(chunks[i]);
+    }
+
+    // --------
+    // allocate
+    // --------
+
+    /**
+     * time: O(1)
+     */
+    void* allocate (std::size_t bytes) {
+      if (bytes > max_small)
+	return ::operator new(bytes);
+      const std::size_t c = (bytes == 0) ? 0 : (bytes - 1) / granularity;
+      void*             p;
+      lock();
+      if (free_lists[c]) {
+	p = free_lists[c];
+	free_lists[c] = free_lists[c]->next;
+      }
+      else {
+	const std::size_t size = (c + 1) * granularity;
+	if (static_cast<std::size_t>(limit - cursor) < size)
+	  grow();
+	p = cursor;
+	cursor += size;
+      }
+      unlock();
+      return p;
+    }
+
+    // ----------
+    // deallocate
+    // ----------
+
+    /**
+     * time: O(1)
+     * small blocks go back on their free list, or are dropped while
+     * discarding; the memory stays in the arena
+     */
+    void deallocate (void* p, std::size_t bytes) {
+      if (bytes > max_small) {
+	::operator delete(p);
+	return;
+      }
+      if (discarding)
+	return;
+      const std::size_t c = (bytes == 0) ? 0 : (bytes - 1) / granularity;
+      free_block*       b = static_cast<free_block*>(p);
+      lock();
+      b->next = free_lists[c];
+      free_lists[c] = b;
+      unlock();
+    }
+
+    // -------
+    // discard
+    // -------
+
+    /**
+     * time: O(1)
+     * starts (on) or ends (!on) a stretch of discarding; stretches may
+     * nest and overlap, the arena discards until the last one ends
+     */
+    void discard (bool on) {
+      __sync_fetch_and_add(&discarding, on ? 1 : -1);
+    }
+
+    // --------------
+    // bytes_reserved
+    // --------------
+
+    /**
+     * @return the bytes obtained from operator new for chunks
+     */
+    std::size_t bytes_reserved () const {
+      return reserved;
+    }
+  };
+
+  // --------------
+  // ArenaAllocator
+  // --------------
+
+  /**
+   * a standard allocator drawing from a reference counted Arena
+   * a default constructed allocator creates a new arena; copies and
+   * rebound copies share it, and the arena is destroyed, releasing all
+   * of its chunks at once, with the last allocator referring to it
+   * so every node of a container, and of every container copied from
+   * it, lives in the same arena
+   */
+  template <typename T>
+  class ArenaAllocator {
+  public:
+    // --------
+    // typedefs
+    // --------
+
+    typedef T              value_type;
+    typedef T*             pointer;
+    typedef const T*       const_pointer;
+    typedef T&             reference;
+    typedef const T&       const_reference;
+    typedef std::size_t    size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template <typename U>
+    struct rebind {
+      typedef ArenaAllocator<U> other;
+    };
+
+  private:
+    template <typename U>
+    friend class ArenaAllocator;
+
+    // ----
+    // data
+    // ----
+
+    Arena* arena;
+
+    void detach () {
+      if (arena->detach())
+	delete arena;
+    }
+
+  public:
+    // ------------
+    // constructors
+    // ------------
+
+    ArenaAllocator () : arena(new Arena) {
+      arena->attach();
+    }
+
+    /**
+     * @param chunk_limit the largest chunk the new arena requests
+     */
+    explicit ArenaAllocator (std::size_t chunk_limit) : arena(new Arena(chunk_limit)) {
+      arena->attach();
+    }
+
+    ArenaAllocator (const ArenaAllocator& that) : arena(that.arena) {
+      arena->attach();
+    }
+
+    template <typename U>
+    ArenaAllocator (const ArenaAllocator<U>& that) : arena(that.arena) {
+      arena->attach();
+    }
+
+    ~ArenaAllocator () {
+      detach();
+    }
+
+    ArenaAllocator& operator = (const ArenaAllocator& that) {
+      that.arena->attach();
+      detach();
+      arena = that.arena;
+      return *this;
+    }
+
+    // ---------
+    // allocator
+    // ---------
+
+    pointer address (reference x) const {
+      return &x;
+    }
+
+    const_pointer address (const_reference x) const {
+      return &x;
+    }
+
+    pointer allocate (size_type n, const void* = 0) {
+      return static_cast<pointer>(arena->allocate(n * sizeof(T)));
+    }
+
+    void deallocate (pointer p, size_type n) {
+      arena->deallocate(p, n * sizeof(T));
+    }
+
+    size_type max_size () const {
+      return static_cast<size_type>(-1) / sizeof(T);
+    }
+
+    void construct (pointer p, const T& v) {
+      new (static_cast<void*>(p)) T(v);
+    }
+
+    void destroy (pointer p) {
+      p->~T();
+    }
+
+    // -----
+    // arena
+    // -----
+
+    const Arena& get_arena () const {
+      return *arena;
+    }
+
+    /**
+     * Arena::discard on the shared arena
+     */
+    void discard (bool on) const {
+      arena->discard(on);
+    }
+
+    template <typename U>
+    bool operator == (const ArenaAllocator<U>& that) const {
+      return arena == that.arena;
+    }
+
+    template <typename U>
+    bool operator != (const ArenaAllocator<U>& that) const {
+      return arena != that.arena;
+    }
+  };
+
+} // cs
+
+#endif // Arena_h
@@ -0,0 +1,276 @@
+// ------------------------------
+// projects/c++/graph/Benchmark.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// ------------------------------
+
+#ifndef Benchmark_h
+#define Benchmark_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // swap
+#include <cassert>   // assert
+#include <cstddef>   // size_t
+#include <ostream>   // ostream
+#include <string>    // string
+#include <utility>   // pair
+#include <vector>    // vector
+
+#include <stdint.h>   // uint64_t
+#include <sys/time.h> // gettimeofday
+
+// ----------
+// namespaces
+// ----------
+
+namespace cs {
+
+  /*
+   * support for bench.c++ and benchmark.c++, and the random graphs of
+   * the tests: a wall clock, a portable random number generator and
+   * synthetic graph generators, all deterministic for a given seed
+   */
+
+  namespace bench {
+
+    typedef std::pair<unsigned int, unsigned int> edge_type;
+    typedef std::vector<edge_type>                edge_list;
+
+    // -------
+    // seconds
+    // -------
+
+    /**
+     * wall clock time, in seconds
+     */
+    inline double seconds () {
+      timeval tv;
+      gettimeofday(&tv, 0);
+      return tv.tv_sec + tv.tv_usec / 1e6;
+    }
+
+    // ------
+    // Random
+    // ------
+
+    /**
+     * splitmix64, so the generated graphs are identical on every platform
+     * (std::rand differs between C libraries)
+     */
+    class Random {
+    private:
+      uint64_t state;
+
+    public:
+      explicit Random (uint64_t seed) : state(seed) {}
+
+      uint64_t next () {
+	uint64_t z = (state += 0x9e3779b97f4a7c15u);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9u;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebu;
+	return z ^ (z >> 31);
+      }
+
+      /**
+       * uniform in [0, n)
+       */
+      unsigned int below (unsigned int n) {
+	return static_cast<unsigned int>(next() % n);
+      }
+
+      /**
+       * uniform in [0, 1)
+       */
+      double uniform () {
+	return (next() >> 11) * (1.0 / 9007199254740992.0);
+      }
+    };
+
+    // -------
+    // forward
+    // -------
+
+    /**
+     * orients u -> v from the lower to the higher id, which makes any
+     * edge set acyclic
+     */
+    inline edge_type forward (unsigned int u, unsigned int v) {
+      if (u > v)
+	std::swap(u, v);
+      return edge_type(u, v);
+    }
+
+    // -----------
+    // erdos_renyi
+    // -----------
+
+    /**
+     * G(n, m): m uniformly random edges over n vertices, self loops dropped
+     * duplicates are kept, the graph loaders remove them
+     * Precondition: (n >= 2) || (m == 0), fewer vertices have no edge to draw
+     * @param acyclic orient every edge from the lower to the higher id
+     */
+    inline edge_list erdos_renyi (unsigned int n, std::size_t m, bool acyclic, uint64_t seed) {
+      assert((n >= 2) || (m == 0));
+      Random    r(seed);
+      edge_list es;
+      es.reserve(m);
+      while (es.size() != m) {
+	const unsigned int u = r.below(n);
+	const unsigned int v = r.below(n);
+	if (u != v)
+	  es.push_back(acyclic ? forward(u, v) : edge_type(u, v));
+      }
+      return es;
+    }
+
+    // ----
+    // rmat
+    // ----
+
+    /**
+     * R-MAT (Chakrabarti, Zhan, Faloutsos 2004): each edge descends the
+     * adjacency matrix quadrant by quadrant with probabilities a, b, c
+     * and 1 - a - b - c, giving a power-law degree distribution
+     * the vertex count is rounded up to a power of two, 2^scale
+     * Precondition: scale >= 1, a single vertex has no edge to draw
+     */
+    inline edge_list rmat (unsigned int scale, std::size_t m, double a, double b, double c,
+			   bool acyclic, uint64_t seed) {
+      assert(scale >= 1);
+      Random    r(seed);
+      edge_list es;
+      es.reserve(m);
+      while (es.size() != m) {
+	unsigned int u = 0;
+	unsigned int v = 0;
+	for (unsigned int bit = 0; bit != scale; ++bit) {
+	  const double p = r.uniform();
+	  u <<= 1;
+	  v <<= 1;
+	  if (p < a)
+	    continue;
+	  if (p < a + b)
+	    v |= 1;
+	  else if (p < a + b + c)
+	    u |= 1;
+	  else {
+	    u |= 1;
+	    v |= 1;
+	  }
+	}
+	if (u != v)
+	  es.push_back(acyclic ? forward(u, v) : edge_type(u, v));
+      }
+      return es;
+    }
+
+    /**
+     * R-MAT with the Graph500 parameters a = 0.57, b = c = 0.19
+     */
+    inline edge_list rmat (unsigned int scale, std::size_t m, bool acyclic, uint64_t seed) {
+      return rmat(scale, m, 0.57, 0.19, 0.19, acyclic, seed);
+    }
+
+    // -----
+    // chain
+    // -----
+
+    /**
+     * the path 0 -> 1 -> ... -> n - 1
+     */
+    inline edge_list chain (unsigned int n) {
+      edge_list es;
+      es.reserve(n);
+      for (unsigned int v = 1; v < n; ++v)
+	es.push_back(edge_type(v - 1, v));
+      return es;
+    }
+
+    // ---------
+    // dense_dag
+    // ---------
+
+    /**
+     * every pair u < v is an edge u -> v with probability p
+     */
+    inline edge_list dense_dag (unsigned int n, double p, uint64_t seed) {
+      Random    r(seed);
+      edge_list es;
+      es.reserve(static_cast<std::size_t>(p * n * (n - 1) / 2) + n);
+      for (unsigned int u = 0; u < n; ++u)
+	for (unsigned int v = u + 1; v < n; ++v)
+	  if (r.uniform() < p)
+	    es.push_back(edge_type(u, v));
+      return es;
+    }
+
+    // -------
+    // Results
+    // -------
+
+    /**
+     * collects (workload, implementation, operation, time) rows and
+     * writes them as CSV or as a JSON array
+     */
+    class Results {
+    private:
+      struct row {
+	std::string graph;
+	std::size_t vertices;
+	std::size_t edges;
+	std::string implementation;
+	std::string operation;
+	std::size_t items;   // how many operations the time covers
+	double      seconds;
+      };
+
+      std::vector<row> rows;
+
+    public:
+      void add (const std::string& graph, std::size_t vertices, std::size_t edges,
+		const std::string& implementation, const std::string& operation,
+		std::size_t items, double seconds) {
+	row r;
+	r.graph          = graph;
+	r.vertices       = vertices;
+	r.edges          = edges;
+	r.implementation = implementation;
+	r.operation      = operation;
+	r.items          = items;
+	r.seconds        = seconds;
+	rows.push_back(r);
+      }
+
+      void write_csv (std::ostream& out) const {
+	out << "graph,vertices,edges,implementation,operation,items,seconds,ns_per_item\n";
+	for (std::size_t i = 0; i != rows.size(); ++i) {
+	  const row& r = rows[i];
+	  out << r.graph << ',' << r.vertices << ',' << r.edges << ',' << r.implementation << ','
+	      << r.operation << ',' << r.items << ',' << r.seconds << ','
+	      << (r.items ? r.seconds * 1e9 / r.items : 0.0) << '\n';
+	}
+      }
+
+      void write_json (std::ostream& out) const {
+	out << "[\n";
+	for (std::size_t i = 0; i != rows.size(); ++i) {
+	  const row& r = rows[i];
+	  out << "  {\"graph\": \"" << r.graph << "\", \"vertices\": " << r.vertices
+	      << ", \"edges\": " << r.edges << ", \"implementation\": \"" << r.implementation
+	      << "\", \"operation\": \"" << r.operation << "\", \"items\": " << r.items
+	      << ", \"seconds\": " << r.seconds << ", \"ns_per_item\": "
+	      << (r.items ? r.seconds * 1e9 / r.items : 0.0) << "}"
+	      << ((i + 1 != rows.size()) ? ",\n" : "\n");
+	}
+	out << "]\n";
+      }
+    };
+  }
+
+} // cs
+
+#endif // Benchmark_h
@@ -0,0 +1,282 @@
+// ---------------------------------------
+// projects/c++/graph/BidirectionalGraph.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// ---------------------------------------
+
+#ifndef BidirectionalGraph_h
+#define BidirectionalGraph_h
+
+// --------
+// includes
+// --------
+
+#include <cassert>  // assert
+#include <cstddef>  // ptrdiff_t
+#include <iterator> // forward_iterator_tag, iterator
+#include <set>      // set
+#include <utility>  // make_pair, pair
+#include <vector>   // vector
+
+#include "Graph.h"
+
+// ----------
+// namespaces
+// ----------
+
+namespace cs {
+
+  // -----------------------
+  // BasicBidirectionalGraph
+  // -----------------------
+
+  /**
+   * a BasicGraph that also keeps, for every vertex, the set of its
+   * predecessors, so in_degree and inv_adjacent_vertices are as cheap as
+   * out_degree and adjacent_vertices
+   * the predecessors are held in a second BasicGraph, the transpose,
+   * which every mutator below keeps in step with the out edges
+   * memory: each edge is stored twice, once per direction, and each
+   * vertex has a second (empty or not) adjacency set; for std::set that
+   * is about 40 more bytes per edge and 48 more per vertex, roughly
+   * double the footprint of Graph
+   * all the queries of BasicGraph are inherited; the mutators must be
+   * called on the BasicBidirectionalGraph itself, never through a
+   * reference to its BasicGraph base, or the transpose goes stale
+   */
+  template <typename AdjacencySet>
+  class BasicBidirectionalGraph : public BasicGraph<AdjacencySet> {
+  public:
+    // --------
+    // typedefs
+    // --------
+
+    typedef BasicGraph<AdjacencySet> base_type;
+
+    typedef typename base_type::adjacency_set      adjacency_set;
+    typedef typename base_type::vertex_descriptor  vertex_descriptor;
+    typedef typename base_type::edge_descriptor    edge_descriptor;
+    typedef typename base_type::adjacency_iterator adjacency_iterator;
+    typedef typename base_type::vertices_size_type vertices_size_type;
+    typedef typename base_type::edges_size_type    edges_size_type;
+    typedef typename base_type::degree_size_type   degree_size_type;
+
+    typedef adjacency_iterator inv_adjacency_iterator;
+
+    // ----------------
+    // in_edge_iterator
+    // ----------------
+
+    /**
+     * the edges (u, v) into a fixed vertex v, one per predecessor u
+     */
+    class in_edge_iterator :
+      public std::iterator<std::forward_iterator_tag, edge_descriptor,
+			   std::ptrdiff_t, const edge_descriptor*, edge_descriptor> {
+    private:
+      inv_adjacency_iterator pos;
+      vertex_descriptor      v;
+    public:
+      in_edge_iterator (inv_adjacency_iterator pos, vertex_descriptor v) : pos(pos), v(v) {}
+
+      in_edge_iterator& operator ++ () {
+	++pos;
+	return *this;
+      }
+
+      in_edge_iterator operator ++ (int) {
+	in_edge_iterator tmp(*this);
+	++pos;
+	return tmp;
+      }
+
+      edge_descriptor operator * () const {
+	return edge_descriptor(*pos, v);
+      }
+
+      bool operator == (const in_edge_iterator& rhs) const {
+	return pos == rhs.pos;
+      }
+
+      bool operator != (const in_edge_iterator& rhs) const {
+	return pos != rhs.pos;
+      }
+    };
+
+    // -----------
+    // remove_edge
+    // -----------
+
+    /**
+     * time: O(log d) for std::set
+     * removing an edge that does not exist leaves the graph unchanged
+     */
+    friend void remove_edge
+    (vertex_descriptor u, vertex_descriptor v, BasicBidirectionalGraph& myG) {
+      remove_edge(u, v, static_cast<base_type&>(myG));
+      remove_edge(v, u, myG.transpose);
+    }
+
+    // --------
+    // add_edge
+    // --------
+
+    /**
+     * time: O(log d) for std::set
+     * @return std::pair<edge_descriptor, bool>
+     * bool = false, if the edge already exist inside the graph
+     */
+    friend std::pair<edge_descriptor, bool>
+    add_edge (vertex_descriptor x, vertex_descriptor y, BasicBidirectionalGraph& myG) {
+      std::pair<edge_descriptor, bool> p = add_edge(x, y, static_cast<base_type&>(myG));
+      if (p.second)
+	add_edge(y, x, myG.transpose);
+      return p;
+    }
+
+    // ---------
+    // add_edges
+    // ---------
+
+    /**
+     * time: twice that of BasicGraph's add_edges
+     * space: O(V + E), the range is copied once, reversed, for the transpose
+     * @return the number of edges that were not already in the graph
+     */
+    template <typename FI>
+    friend edges_size_type
+    add_edges (FI first, FI last, BasicBidirectionalGraph& myG) {
+      std::vector<edge_descriptor> reversed;
+      for (FI i = first; i != last; ++i)
+	reversed.push_back(edge_descriptor(i->second, i->first));
+      const edges_size_type inserted = add_edges(first, last, static_cast<base_type&>(myG));
+      add_edges(reversed.begin(), reversed.end(), myG.transpose);
+      return inserted;
+    }
+
+    // ----------
+    // add_vertex
+    // ----------
+
+    /**
+     * time:O(1) amortized
+     */
+    friend vertex_descriptor
+    add_vertex (BasicBidirectionalGraph& myG) {
+      add_vertex(myG.transpose);
+      return add_vertex(static_cast<base_type&>(myG));
+    }
+
+    // ----------------
+    // reserve_vertices
+    // ----------------
+
+    friend void
+    reserve_vertices (vertices_size_type n, BasicBidirectionalGraph& myG) {
+      reserve_vertices(n, static_cast<base_type&>(myG));
+      reserve_vertices(n, myG.transpose);
+    }
+
+    // ---------
+    // in_degree
+    // ---------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     * @return the number of edges entering x
+     */
+    friend degree_size_type
+    in_degree (vertex_descriptor x, const BasicBidirectionalGraph& myG) {
+      return out_degree(x, myG.transpose);
+    }
+
+    // ---------------------
+    // inv_adjacent_vertices
+    // ---------------------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     * @return the predecessors of x, the sources of its in edges
+     */
+    friend std::pair<inv_adjacency_iterator, inv_adjacency_iterator>
+    inv_adjacent_vertices (vertex_descriptor x, const BasicBidirectionalGraph& myG) {
+      return adjacent_vertices(x, myG.transpose);
+    }
+
+    // --------
+    // in_edges
+    // --------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     * @return the edges (u, x) entering x
+     */
+    friend std::pair<in_edge_iterator, in_edge_iterator>
+    in_edges (vertex_descriptor x, const BasicBidirectionalGraph& myG) {
+      std::pair<inv_adjacency_iterator, inv_adjacency_iterator> p = inv_adjacent_vertices(x, myG);
+      return std::make_pair(in_edge_iterator(p.first, x), in_edge_iterator(p.second, x));
+    }
+
+  private:
+    // ----
+    // data
+    // ----
+
+    base_type transpose; // the edge v -> u for every edge u -> v
+
+    // -----
+    // valid
+    // -----
+
+    bool valid () const {
+      return (num_vertices(transpose) == num_vertices(static_cast<const base_type&>(*this))) &&
+	(num_edges(transpose) == num_edges(static_cast<const base_type&>(*this)));
+    }
+
+  public:
+    // ------------
+    // constructors
+    // ------------
+
+    BasicBidirectionalGraph () {
+      assert(valid());
+    }
+
+    /**
+     * both directions start every vertex as a copy of prototype
+     */
+    explicit BasicBidirectionalGraph (const adjacency_set& prototype) :
+	base_type(prototype), transpose(prototype) {
+      assert(valid());
+    }
+
+    /**
+     * n vertices plus the edges of [first, last), built by add_edges
+     */
+    template <typename FI>
+    BasicBidirectionalGraph (vertices_size_type n, FI first, FI last) {
+      reserve_vertices(n, *this);
+      for (vertices_size_type i = 0; i != n; ++i)
+	add_vertex(*this);
+      add_edges(first, last, *this);
+      assert(valid());
+    }
+
+    // Default copy, destructor, and copy assignment
+  };
+
+  // ------------------
+  // BidirectionalGraph
+  // ------------------
+
+  /**
+   * Graph plus in-edge storage
+   */
+  typedef BasicBidirectionalGraph< std::set<unsigned int> > BidirectionalGraph;
+
+} // cs
+
+#endif // BidirectionalGraph_h
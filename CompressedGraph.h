@@ -0,0 +1,695 @@
+// ------------------------------------
+// projects/c++/graph/CompressedGraph.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// ------------------------------------
+
+#ifndef CompressedGraph_h
+#define CompressedGraph_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // min, sort, unique
+#include <cassert>   // assert
+#include <cstddef>   // ptrdiff_t, size_t
+#include <cstring>   // memcpy
+#include <iterator>  // forward_iterator_tag, iterator
+#include <utility>   // make_pair, pair
+#include <vector>    // vector
+
+#ifdef __SSSE3__
+#include <tmmintrin.h> // __m128i, _mm_loadu_si128, _mm_shuffle_epi8, _mm_storeu_si128
+#endif
+
+#include "CsrGraph.h"
+
+// ----------
+// namespaces
+// ----------
+
+namespace cs {
+
+  // ----------
+  // compressed
+  // ----------
+
+  /**
+   * the codecs of BasicCompressedGraph
+   * a row u -> t0 < t1 < ... < tk is stored as the sequence
+   * zigzag(t0 - u), t1 - t0, ..., tk - tk-1, so a graph whose edges are
+   * short (after rcm_ordering or dfs_ordering) or whose rows are dense
+   * becomes a sequence of small numbers
+   * a codec packs such a sequence into bytes and unpacks it a block of
+   * values at a time
+   */
+  namespace compressed {
+
+    // bytes of zeros after the last row, so a decoder may load a whole
+    // 16 byte word at any position of a row without a bounds check
+    enum {slack = 16};
+
+    inline unsigned int zigzag (int x) {
+      return (static_cast<unsigned int>(x) << 1) ^ static_cast<unsigned int>(x >> 31);
+    }
+
+    inline int unzigzag (unsigned int x) {
+      return static_cast<int>(x >> 1) ^ -static_cast<int>(x & 1);
+    }
+
+    /**
+     * 7 bits per byte, least significant group first, the high bit set
+     * on every byte but the last
+     */
+    inline void put_varint (unsigned int x, std::vector<unsigned char>& out) {
+      while (x >= 0x80) {
+	out.push_back(static_cast<unsigned char>(x | 0x80));
+	x >>= 7;
+      }
+      out.push_back(static_cast<unsigned char>(x));
+    }
+
+    inline const unsigned char* get_varint (const unsigned char* p, unsigned int& x) {
+      x = *p & 0x7f;
+      for (unsigned int shift = 7; *p++ & 0x80; shift += 7)
+	x |= static_cast<unsigned int>(*p & 0x7f) << shift;
+      return p;
+    }
+
+    // -----------
+    // VarintCodec
+    // -----------
+
+    /**
+     * one varint per value: 1 byte below 128, 2 below 16384, ...
+     * the smallest encoding, one data-dependent branch per byte to decode
+     */
+    struct VarintCodec {
+      enum {block = 1};
+
+      static void encode (const unsigned int* values, std::size_t n, std::vector<unsigned char>& out) {
+	for (std::size_t i = 0; i != n; ++i)
+	  put_varint(values[i], out);
+      }
+
+      static const unsigned char* decode (const unsigned char* p, std::size_t, unsigned int* out) {
+	return get_varint(p, *out);
+      }
+    };
+
+    // ----------------
+    // GroupVarintCodec
+    // ----------------
+
+    /**
+     * group varint: four values behind one tag byte holding their
+     * lengths (1 to 4 bytes, 2 bits each), the tail of a row that does
+     * not fill a group as plain varints
+     * a group decodes without a branch per byte: with SSSE3 a single
+     * shuffle of 16 loaded bytes through a mask looked up by the tag,
+     * otherwise an unaligned 4 byte load and a mask per value
+     */
+    struct GroupVarintCodec {
+      enum {block = 4};
+
+      static unsigned int length (unsigned int x) {
+	return (x < (1u << 8)) ? 1 : (x < (1u << 16)) ? 2 : (x < (1u << 24)) ? 3 : 4;
+      }
+
+      static void encode (const unsigned int* values, std::size_t n, std::vector<unsigned char>& out) {
+	std::size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+	  unsigned int tag = 0;
+	  for (unsigned int j = 0; j != 4; ++j)
+	    tag |= (length(values[i + j]) - 1) << (2 * j);
+	  out.push_back(static_cast<unsigned char>(tag));
+	  for (unsigned int j = 0; j != 4; ++j)
+	    for (unsigned int b = 0; b != length(values[i + j]); ++b)
+	      out.push_back(static_cast<unsigned char>(values[i + j] >> (8 * b)));
+	}
+	VarintCodec::encode(values + i, n - i, out);
+      }
+
+#ifdef __SSSE3__
+      /**
+       * for every tag, the shuffle that spreads its four values over
+       * four 32 bit lanes, and the number of data bytes it consumes
+       */
+      struct Shuffles {
+	__m128i       masks[256];
+	unsigned char lengths[256];
+
+	Shuffles () {
+	  for (unsigned int tag = 0; tag != 256; ++tag) {
+	    unsigned char m[16];
+	    unsigned int  pos = 0;
+	    for (unsigned int j = 0; j != 4; ++j) {
+	      const unsigned int n = ((tag >> (2 * j)) & 3) + 1;
+	      for (unsigned int b = 0; b != 4; ++b)
+		m[4 * j + b] = static_cast<unsigned char>((b < n) ? pos + b : 0x80);
+	      pos += n;
+	    }
+	    masks[tag]   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m));
+	    lengths[tag] = static_cast<unsigned char>(pos);
+	  }
+	}
+      };
+
+      static const Shuffles& shuffles () {
+	static const Shuffles s;
+	return s;
+      }
+#else
+      static unsigned int load (const unsigned char* p, unsigned int n) {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+	unsigned int x;
+	std::memcpy(&x, p, sizeof(x));
+	return x & (0xffffffffu >> (32 - 8 * n));
+#else
+	unsigned int x = 0;
+	for (unsigned int b = 0; b != n; ++b)
+	  x |= static_cast<unsigned int>(p[b]) << (8 * b);
+	return x;
+#endif
+      }
+#endif
+
+      /**
+       * decodes a group if count is 4, otherwise count varints
+       */
+      static const unsigned char* decode (const unsigned char* p, std::size_t count, unsigned int* out) {
+	if (count < 4) {
+	  for (std::size_t i = 0; i != count; ++i)
+	    p = get_varint(p, out[i]);
+	  return p;
+	}
+	const unsigned int tag = *p++;
+#ifdef __SSSE3__
+	const Shuffles& s = shuffles();
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+			 _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), s.masks[tag]));
+	return p + s.lengths[tag];
+#else
+	for (unsigned int j = 0; j != 4; ++j) {
+	  const unsigned int n = ((tag >> (2 * j)) & 3) + 1;
+	  out[j] = load(p, n);
+	  p += n;
+	}
+	return p;
+#endif
+      }
+    };
+
+    // -----------------
+    // AdjacencyIterator
+    // -----------------
+
+    /**
+     * decodes a row on the fly, a block of the codec at a time
+     * a row starts with its length as a varint, so the end of a row is
+     * the iterator with nothing left
+     */
+    template <typename Codec>
+    class AdjacencyIterator :
+      public std::iterator<std::forward_iterator_tag, unsigned int,
+			   std::ptrdiff_t, const unsigned int*, unsigned int> {
+    private:
+      const unsigned char* p;    // the next undecoded byte
+      std::size_t          left; // the values from the current one to the end of the row
+      unsigned int         index;
+      unsigned int         value;
+      unsigned int         buffer[Codec::block];
+
+      void refill () {
+	p     = Codec::decode(p, std::min<std::size_t>(left, Codec::block), buffer);
+	index = 0;
+      }
+
+    public:
+      /**
+       * the end of any row
+       */
+      AdjacencyIterator () : p(0), left(0), index(0), value(0) {}
+
+      /**
+       * the first target of the row of u that starts at p
+       */
+      AdjacencyIterator (const unsigned char* p, unsigned int u) : p(p), left(0), index(0), value(0) {
+	unsigned int n;
+	this->p = get_varint(p, n);
+	left    = n;
+	if (left != 0) {
+	  refill();
+	  value = static_cast<unsigned int>(static_cast<int>(u) + unzigzag(buffer[0]));
+	}
+      }
+
+      /**
+       * the number of targets of the row of an iterator fresh from the
+       * constructor
+       */
+      std::size_t size () const {
+	return left;
+      }
+
+      AdjacencyIterator& operator ++ () {
+	assert(left != 0);
+	if (--left == 0)
+	  return *this;
+	if (++index == static_cast<unsigned int>(Codec::block))
+	  refill();
+	value += buffer[index];
+	return *this;
+      }
+
+      AdjacencyIterator operator ++ (int) {
+	AdjacencyIterator tmp(*this);
+	++(*this);
+	return tmp;
+      }
+
+      unsigned int operator * () const {
+	assert(left != 0);
+	return value;
+      }
+
+      bool operator == (const AdjacencyIterator& rhs) const {
+	return left == rhs.left;
+      }
+
+      bool operator != (const AdjacencyIterator& rhs) const {
+	return left != rhs.left;
+      }
+    };
+
+  } // compressed
+
+  // --------------------
+  // BasicCompressedGraph
+  // --------------------
+
+  /**
+   * an immutable directed graph whose rows are delta encoded by Codec
+   * (see cs::compressed) in one byte array, with the byte offset of
+   * every row beside it (4 bytes per vertex)
+   * adjacent_vertices decodes as it goes and edge() scans the row, so
+   * the graph trades a little time per edge for several times less
+   * memory than CsrGraph's 4 bytes per edge (and tens of times less
+   * than the 40 or so of cs::Graph); how much less depends on the
+   * numbering: renumber with Reordering.h first
+   * parallel edges collapse; at most 2^31 - 1 vertices
+   * it exposes the same free functions as CsrGraph, so the templates in
+   * GraphAlgorithms.h run on it unmodified
+   */
+  template <typename Codec>
+  class BasicCompressedGraph {
+  public:
+    // --------
+    // typedefs
+    // --------
+
+    typedef unsigned int vertex_descriptor;
+    typedef std::pair<vertex_descriptor, vertex_descriptor>
+    edge_descriptor;
+
+    typedef Codec codec_type;
+
+    typedef compressed::AdjacencyIterator<Codec> adjacency_iterator;
+    typedef CsrGraph::vertex_iterator            vertex_iterator;
+
+    typedef std::size_t vertices_size_type;
+    typedef std::size_t edges_size_type;
+    typedef std::size_t degree_size_type;
+
+    // -------------
+    // edge_iterator
+    // -------------
+
+    /**
+     * the rows one after another, skipping the empty ones
+     */
+    class edge_iterator :
+      public std::iterator<std::forward_iterator_tag, edge_descriptor,
+			   std::ptrdiff_t, const edge_descriptor*, edge_descriptor> {
+    private:
+      const BasicCompressedGraph* g;
+      vertex_descriptor           u;
+      adjacency_iterator          pos;
+
+      void skip_exhausted () {
+	while ((pos == adjacency_iterator()) && (u != g->num_rows()))
+	  if (++u != g->num_rows())
+	    pos = g->row(u);
+      }
+    public:
+      edge_iterator (const BasicCompressedGraph* g, vertex_descriptor u) : g(g), u(u) {
+	if (u != g->num_rows()) {
+	  pos = g->row(u);
+	  skip_exhausted();
+	}
+      }
+
+      edge_iterator& operator ++ () {
+	++pos;
+	skip_exhausted();
+	return *this;
+      }
+
+      edge_iterator operator ++ (int) {
+	edge_iterator tmp(*this);
+	++(*this);
+	return tmp;
+      }
+
+      edge_descriptor operator * () const {
+	return edge_descriptor(u, *pos);
+      }
+
+      bool operator == (const edge_iterator& rhs) const {
+	return (u == rhs.u) && (pos == rhs.pos);
+      }
+
+      bool operator != (const edge_iterator& rhs) const {
+	return !(*this == rhs);
+      }
+    };
+
+    // -----------------
+    // adjacent_vertices
+    // -----------------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     * @return iterators decoding the sorted targets of x
+     */
+    friend std::pair<adjacency_iterator, adjacency_iterator>
+    adjacent_vertices (vertex_descriptor x, const BasicCompressedGraph& myG) {
+      assert(x < myG.num_rows());
+      return std::make_pair(myG.row(x), adjacency_iterator());
+    }
+
+    // ----------
+    // out_degree
+    // ----------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     * the length at the head of the row
+     */
+    friend degree_size_type
+    out_degree (vertex_descriptor x, const BasicCompressedGraph& myG) {
+      assert(x < myG.num_rows());
+      unsigned int n;
+      compressed::get_varint(&myG.bytes[myG.position(x)], n);
+      return n;
+    }
+
+    // ----
+    // edge
+    // ----
+
+    /**
+     * time:O(out degree of x)
+     * space:  O(1)
+     * decodes the row of x up to y
+     */
+    friend std::pair<edge_descriptor, bool>
+    edge (vertex_descriptor x, vertex_descriptor y, const BasicCompressedGraph& myG) {
+      std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(x, myG);
+      while ((p.first != p.second) && (*p.first < y))
+	++p.first;
+      return std::make_pair(edge_descriptor(x, y), (p.first != p.second) && (*p.first == y));
+    }
+
+    // -----
+    // edges
+    // -----
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     */
+    friend std::pair<edge_iterator, edge_iterator>
+    edges (const BasicCompressedGraph& myG) {
+      const vertex_descriptor rows = static_cast<vertex_descriptor>(myG.num_rows());
+      return std::make_pair(edge_iterator(&myG, 0), edge_iterator(&myG, rows));
+    }
+
+    // ------
+    // vertex
+    // ------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     */
+    friend vertex_descriptor
+    vertex (vertices_size_type n, const BasicCompressedGraph& myG) {
+      assert(n < myG.num_rows());
+      return static_cast<vertex_descriptor>(n);
+    }
+
+    // --------
+    // vertices
+    // --------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     */
+    friend std::pair<vertex_iterator, vertex_iterator>
+    vertices (const BasicCompressedGraph& myG) {
+      return std::make_pair(vertex_iterator(0),
+			    vertex_iterator(static_cast<vertex_descriptor>(myG.num_rows())));
+    }
+
+    // ------
+    // source
+    // ------
+
+    friend vertex_descriptor
+    source (edge_descriptor x, const BasicCompressedGraph& myG) {
+      assert(x.first < myG.num_rows());
+      return x.first;
+    }
+
+    // ------
+    // target
+    // ------
+
+    friend vertex_descriptor
+    target (edge_descriptor x, const BasicCompressedGraph&) {
+      return x.second;
+    }
+
+    // ---------
+    // num_edges
+    // ---------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     */
+    friend edges_size_type
+    num_edges (const BasicCompressedGraph& myG) {
+      return myG.ne;
+    }
+
+    // ------------
+    // num_vertices
+    // ------------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     */
+    friend vertices_size_type
+    num_vertices (const BasicCompressedGraph& myG) {
+      return myG.num_rows();
+    }
+
+    // ----------
+    // memory_use
+    // ----------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     * @return the bytes held by the rows and their offsets
+     */
+    friend std::size_t
+    memory_use (const BasicCompressedGraph& myG) {
+      return myG.bytes.capacity() + myG.offsets.capacity() * sizeof(unsigned int) +
+	myG.bases.capacity() * sizeof(edges_size_type);
+    }
+
+  private:
+    // ----
+    // data
+    // ----
+
+    // the row of x starts at byte bases[x / rows_per_base] + offsets[x],
+    // so an offset costs 4 bytes per vertex rather than 8
+    enum {rows_per_base = 1024};
+
+    std::vector<edges_size_type> bases;
+    std::vector<unsigned int>    offsets;
+    std::vector<unsigned char>   bytes;   // the rows, then compressed::slack zeros
+    edges_size_type              ne;
+
+    vertices_size_type num_rows () const {
+      return offsets.size();
+    }
+
+    adjacency_iterator row (vertex_descriptor x) const {
+      return adjacency_iterator(&bytes[position(x)], x);
+    }
+
+    edges_size_type position (vertex_descriptor x) const {
+      return bases[x / rows_per_base] + offsets[x];
+    }
+
+    /**
+     * appends the row of u, given its targets in any order
+     */
+    void append (vertex_descriptor u, std::vector<vertex_descriptor>& ts, std::vector<unsigned int>& values) {
+      if (u % rows_per_base == 0)
+	bases.push_back(bytes.size());
+      assert(bytes.size() - bases.back() <= 0xffffffffu);
+      offsets.push_back(static_cast<unsigned int>(bytes.size() - bases.back()));
+      std::sort(ts.begin(), ts.end());
+      ts.erase(std::unique(ts.begin(), ts.end()), ts.end());
+      values.resize(ts.size());
+      for (std::size_t i = 0; i != ts.size(); ++i)
+	values[i] = (i == 0) ?
+	  compressed::zigzag(static_cast<int>(ts[0]) - static_cast<int>(u)) :
+	  ts[i] - ts[i - 1];
+      compressed::put_varint(static_cast<unsigned int>(ts.size()), bytes);
+      if (!values.empty())
+	Codec::encode(&values[0], values.size(), bytes);
+      ne += ts.size();
+    }
+
+    void finish () {
+      bytes.resize(bytes.size() + compressed::slack, 0);
+      std::vector<unsigned char>(bytes).swap(bytes);
+    }
+
+    // -----
+    // valid
+    // -----
+
+    /**
+     * one base per rows_per_base rows, rows start at 0, in order
+     * (every row holds at least its length), and end before the slack
+     */
+    bool valid () const {
+      if (bases.size() != (num_rows() + rows_per_base - 1) / rows_per_base)
+	return false;
+      edges_size_type last = 0;
+      for (vertex_descriptor i = 0; i != num_rows(); ++i) {
+	const edges_size_type p = position(i);
+	if ((i == 0) ? (p != 0) : (p <= last))
+	  return false;
+	last = p;
+      }
+      if (num_rows() == 0)
+	return bytes.size() == compressed::slack;
+      return last + compressed::slack < bytes.size();
+    }
+
+  public:
+    // ------------
+    // constructors
+    // ------------
+
+    /**
+     * an empty graph
+     */
+    BasicCompressedGraph () : bytes(compressed::slack, 0), ne(0) {
+      assert(valid());
+    }
+
+    /**
+     * time: O(V + E log(max out degree))
+     * space: O(V + max out degree) beyond the result
+     * compresses any graph that models the free-function interface of
+     * cs::Graph, one row at a time
+     */
+    template <typename G>
+    explicit BasicCompressedGraph (const G& myG) : ne(0) {
+      typedef typename G::adjacency_iterator adjit;
+      const vertices_size_type n = num_vertices(myG);
+      assert(n < 0x80000000u);
+      bases.reserve(n / rows_per_base + 1);
+      offsets.reserve(n);
+      std::vector<vertex_descriptor> ts;
+      std::vector<unsigned int>      values;
+      for (vertices_size_type i = 0; i != n; ++i) {
+	std::pair<adjit, adjit> p = adjacent_vertices(vertex(i, myG), myG);
+	ts.clear();
+	for (adjit b = p.first; b != p.second; ++b)
+	  ts.push_back(static_cast<vertex_descriptor>(*b));
+	append(static_cast<vertex_descriptor>(i), ts, values);
+      }
+      finish();
+      assert(valid());
+    }
+
+    /**
+     * time: O(V + E log(max out degree))
+     * space: O(V + E) (4 bytes per edge while the rows are gathered)
+     * n vertices plus the edges of [first, last), without building an
+     * uncompressed graph first
+     */
+    template <typename FI>
+    BasicCompressedGraph (vertices_size_type n, FI first, FI last) : ne(0) {
+      assert(n < 0x80000000u);
+      std::vector<edges_size_type> starts(n + 1, 0);
+      for (FI i = first; i != last; ++i) {
+	assert((static_cast<vertices_size_type>(i->first) < n) && (static_cast<vertices_size_type>(i->second) < n));
+	++starts[i->first + 1];
+      }
+      for (vertices_size_type u = 0; u != n; ++u)
+	starts[u + 1] += starts[u];
+      std::vector<vertex_descriptor> targets(starts[n]);
+      {
+	std::vector<edges_size_type> cursor(starts.begin(), starts.end() - 1);
+	for (FI i = first; i != last; ++i)
+	  targets[cursor[i->first]++] = static_cast<vertex_descriptor>(i->second);
+      }
+      bases.reserve(n / rows_per_base + 1);
+      offsets.reserve(n);
+      std::vector<vertex_descriptor> ts;
+      std::vector<unsigned int>      values;
+      for (vertices_size_type u = 0; u != n; ++u) {
+	ts.assign(targets.begin() + starts[u], targets.begin() + starts[u + 1]);
+	append(static_cast<vertex_descriptor>(u), ts, values);
+      }
+      finish();
+      assert(valid());
+    }
+
+    // Default copy, destructor, and copy assignment
+  };
+
+  // ---------------
+  // CompressedGraph
+  // ---------------
+
+  /**
+   * varint rows, the smallest
+   */
+  typedef BasicCompressedGraph<compressed::VarintCodec> CompressedGraph;
+
+  /**
+   * group varint rows, a little larger and faster to decode
+   */
+  typedef BasicCompressedGraph<compressed::GroupVarintCodec> GroupCompressedGraph;
+
+} // cs
+
+#endif // CompressedGraph_h
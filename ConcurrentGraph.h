@@ -0,0 +1,553 @@
+// ------------------------------------
+// projects/c++/graph/ConcurrentGraph.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// ------------------------------------
+
+#ifndef ConcurrentGraph_h
+#define ConcurrentGraph_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // fill, max
+#include <cassert>   // assert
+#include <climits>   // CHAR_BIT
+#include <cstddef>   // ptrdiff_t, size_t
+#include <iterator>  // forward_iterator_tag, iterator
+#include <sched.h>   // sched_yield
+#include <set>       // set
+#include <utility>   // make_pair, pair
+#include <vector>    // vector
+
+// ----------
+// namespaces
+// ----------
+
+namespace cs {
+
+  // --------------------
+  // BasicConcurrentGraph
+  // --------------------
+
+  /**
+   * a BasicGraph that any number of threads may grow at once
+   * vertices live in segments that are never moved: segment k holds
+   * first_segment * 2^k adjacency sets and is allocated once, by
+   * whichever thread needs it first (a compare-and-swap decides), so a
+   * vertex descriptor stays valid while other threads add vertices
+   * add_vertex claims the next descriptor with a compare-and-swap only
+   * after its segment exists, so every vertex below num_vertices is
+   * fully built
+   * the adjacency sets are guarded by striped spin locks, vertex v by
+   * stripe v % stripes, one cache line each; add_edge, remove_edge,
+   * edge and out_degree take the lock of the source, and the edge count
+   * is updated atomically
+   * adjacent_vertices, edges and the algorithms of GraphAlgorithms.h
+   * hand out iterators into the sets, so they must not run while
+   * another thread changes the adjacency of the vertices they visit
+   * (ingest in parallel, then traverse)
+   */
+  template <typename AdjacencySet>
+  class BasicConcurrentGraph {
+  public:
+    // --------
+    // typedefs
+    // --------
+
+    typedef AdjacencySet adjacency_set;
+
+    typedef typename adjacency_set::value_type vertex_descriptor;
+    typedef std::pair<vertex_descriptor, vertex_descriptor>
+    edge_descriptor;
+
+    typedef typename adjacency_set::const_iterator adjacency_iterator;
+
+    typedef std::size_t vertices_size_type;
+    typedef std::size_t edges_size_type;
+    typedef std::size_t degree_size_type;
+
+  private:
+    enum {first_segment = 1024, segments = sizeof(std::size_t) * CHAR_BIT - 10, stripes = 1024};
+
+    struct stripe {
+      volatile int busy;
+      char         pad[64 - sizeof(int)];
+    };
+
+  public:
+    // ---------------
+    // vertex_iterator
+    // ---------------
+
+    /**
+     * vertices are the dense range [0, num_vertices)
+     */
+    class vertex_iterator :
+      public std::iterator<std::forward_iterator_tag, vertex_descriptor,
+			   std::ptrdiff_t, const vertex_descriptor*, vertex_descriptor> {
+    private:
+      vertex_descriptor pos;
+    public:
+      vertex_iterator (vertex_descriptor pos) : pos(pos) {}
+
+      vertex_iterator& operator ++ () {
+	++pos;
+	return *this;
+      }
+
+      vertex_iterator operator ++ (int) {
+	vertex_iterator tmp(*this);
+	++pos;
+	return tmp;
+      }
+
+      vertex_descriptor operator * () const {
+	return pos;
+      }
+
+      bool operator == (const vertex_iterator& rhs) const {
+	return pos == rhs.pos;
+      }
+
+      bool operator != (const vertex_iterator& rhs) const {
+	return pos != rhs.pos;
+      }
+    };
+
+    // -------------
+    // edge_iterator
+    // -------------
+
+    /**
+     * the adjacency sets one after another, skipping the empty ones
+     * the number of vertices is read once, when the iterator is made
+     */
+    class edge_iterator :
+      public std::iterator<std::forward_iterator_tag, edge_descriptor,
+			   std::ptrdiff_t, const edge_descriptor*, edge_descriptor> {
+    private:
+      const BasicConcurrentGraph* thegraph;
+      vertex_descriptor           u;
+      vertex_descriptor           n;
+      adjacency_iterator          pos;
+
+      void skip_exhausted () {
+	while ((u != n) && (pos == thegraph->at(u).end()))
+	  if (++u != n)
+	    pos = thegraph->at(u).begin();
+      }
+    public:
+      edge_iterator (const BasicConcurrentGraph* g, vertex_descriptor u, vertex_descriptor n) :
+	  thegraph(g), u(u), n(n) {
+	if (u != n) {
+	  pos = thegraph->at(u).begin();
+	  skip_exhausted();
+	}
+      }
+
+      edge_iterator& operator ++ () {
+	++pos;
+	skip_exhausted();
+	return *this;
+      }
+
+      edge_iterator operator ++ (int) {
+	edge_iterator tmp(*this);
+	++(*this);
+	return tmp;
+      }
+
+      edge_descriptor operator * () const {
+	return edge_descriptor(u, *pos);
+      }
+
+      bool operator == (const edge_iterator& rhs) const {
+	return (u == rhs.u) && ((u == n) || (pos == rhs.pos));
+      }
+
+      bool operator != (const edge_iterator& rhs) const {
+	return !(*this == rhs);
+      }
+    };
+
+    // -----------
+    // remove_edge
+    // -----------
+
+    /**
+     * time: O(log d) for std::set, plus the wait for the lock of u
+     * removing an edge that does not exist leaves the graph unchanged
+     */
+    friend void remove_edge
+    (vertex_descriptor u, vertex_descriptor v, BasicConcurrentGraph& myG) {
+      assert(u < num_vertices(myG));
+      myG.lock(u);
+      const bool erased = myG.at(u).erase(v);
+      myG.unlock(u);
+      if (erased)
+	__sync_fetch_and_sub(&myG.ne, 1);
+    }
+
+    // --------
+    // add_edge
+    // --------
+
+    /**
+     * time: O(log d) for std::set, plus the wait for the lock of x
+     * @return std::pair<edge_descriptor, bool>
+     * bool = false, if the edge already exist inside the graph
+     */
+    friend std::pair<edge_descriptor, bool>
+    add_edge (vertex_descriptor x, vertex_descriptor y, BasicConcurrentGraph& myG) {
+      assert(x < num_vertices(myG));
+      assert(y < num_vertices(myG));
+      myG.lock(x);
+      const bool inserted = myG.at(x).insert(y).second;
+      myG.unlock(x);
+      if (inserted)
+	__sync_fetch_and_add(&myG.ne, 1);
+      return std::make_pair(edge_descriptor(x, y), inserted);
+    }
+
+    // ---------
+    // add_edges
+    // ---------
+
+    /**
+     * time: O(E log(d) / threads)
+     * space: O(E), the range is copied so that OpenMP can split it
+     * vertices are added as needed to cover every endpoint, then the
+     * edges are inserted in parallel, each one by add_edge
+     * @return the number of edges that were not already in the graph
+     */
+    template <typename FI>
+    friend edges_size_type
+    add_edges (FI first, FI last, BasicConcurrentGraph& myG) {
+      std::vector<edge_descriptor> es;
+      vertices_size_type           n = 0;
+      for (; first != last; ++first) {
+	es.push_back(edge_descriptor(first->first, first->second));
+	n = std::max(n, vertices_size_type(std::max(first->first, first->second)) + 1);
+      }
+      while (num_vertices(myG) < n)
+	add_vertex(myG);
+      const long      m        = static_cast<long>(es.size());
+      edges_size_type inserted = 0;
+      #pragma omp parallel for schedule(static) reduction(+:inserted) if (m >= 4096)
+      for (long i = 0; i < m; ++i)
+	inserted += add_edge(es[i].first, es[i].second, myG).second;
+      return inserted;
+    }
+
+    // ----------
+    // add_vertex
+    // ----------
+
+    /**
+     * time:O(1), O(segment) for the thread that allocates a new segment
+     * @return the new vertex; concurrent callers get distinct vertices
+     */
+    friend vertex_descriptor
+    add_vertex (BasicConcurrentGraph& myG) {
+      for (;;) {
+	const vertices_size_type v = myG.claimed;
+	myG.provide(v);
+	if (__sync_bool_compare_and_swap(&myG.claimed, v, v + 1))
+	  return static_cast<vertex_descriptor>(v);
+      }
+    }
+
+    // ----------------
+    // reserve_vertices
+    // ----------------
+
+    /**
+     * allocates the segments for the first n vertices up front
+     */
+    friend void
+    reserve_vertices (vertices_size_type n, BasicConcurrentGraph& myG) {
+      if (n != 0)
+	myG.provide(n - 1);
+    }
+
+    // -----------------
+    // adjacent_vertices
+    // -----------------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     * not synchronized, see the class comment
+     */
+    friend std::pair<adjacency_iterator, adjacency_iterator>
+    adjacent_vertices (vertex_descriptor x, const BasicConcurrentGraph& myG) {
+      assert(x < num_vertices(myG));
+      const adjacency_set& s = myG.at(x);
+      return std::make_pair(s.begin(), s.end());
+    }
+
+    // ----------
+    // out_degree
+    // ----------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     */
+    friend degree_size_type
+    out_degree (vertex_descriptor x, const BasicConcurrentGraph& myG) {
+      assert(x < num_vertices(myG));
+      myG.lock(x);
+      const degree_size_type d = myG.at(x).size();
+      myG.unlock(x);
+      return d;
+    }
+
+    // ----
+    // edge
+    // ----
+
+    /**
+     * time:O(log d) for std::set
+     * space:  O(1)
+     */
+    friend std::pair<edge_descriptor, bool>
+    edge (vertex_descriptor x, vertex_descriptor y, const BasicConcurrentGraph& myG) {
+      assert(x < num_vertices(myG));
+      myG.lock(x);
+      const bool b = myG.at(x).find(y) != myG.at(x).end();
+      myG.unlock(x);
+      return std::make_pair(edge_descriptor(x, y), b);
+    }
+
+    // -----
+    // edges
+    // -----
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     * not synchronized, see the class comment
+     */
+    friend std::pair<edge_iterator, edge_iterator>
+    edges (const BasicConcurrentGraph& myG) {
+      const vertex_descriptor n = static_cast<vertex_descriptor>(num_vertices(myG));
+      return std::make_pair(edge_iterator(&myG, 0, n), edge_iterator(&myG, n, n));
+    }
+
+    // ------
+    // vertex
+    // ------
+
+    friend vertex_descriptor
+    vertex (vertices_size_type n, const BasicConcurrentGraph& myG) {
+      assert(n < num_vertices(myG));
+      return static_cast<vertex_descriptor>(n);
+    }
+
+    // --------
+    // vertices
+    // --------
+
+    friend std::pair<vertex_iterator, vertex_iterator>
+    vertices (const BasicConcurrentGraph& myG) {
+      const vertex_descriptor n = static_cast<vertex_descriptor>(num_vertices(myG));
+      return std::make_pair(vertex_iterator(0), vertex_iterator(n));
+    }
+
+    // ------
+    // source
+    // ------
+
+    friend vertex_descriptor
+    source (edge_descriptor x, const BasicConcurrentGraph& myG) {
+      assert(x.first < num_vertices(myG));
+      return x.first;
+    }
+
+    // ------
+    // target
+    // ------
+
+    friend vertex_descriptor
+    target (edge_descriptor x, const BasicConcurrentGraph& myG) {
+      assert(x.second < num_vertices(myG));
+      return x.second;
+    }
+
+    // ---------
+    // num_edges
+    // ---------
+
+    /**
+     * time:O(1)
+     * exact once the writers are done, a snapshot while they run
+     */
+    friend edges_size_type
+    num_edges (const BasicConcurrentGraph& myG) {
+      return myG.ne;
+    }
+
+    // ------------
+    // num_vertices
+    // ------------
+
+    friend vertices_size_type
+    num_vertices (const BasicConcurrentGraph& myG) {
+      return myG.claimed;
+    }
+
+  private:
+    // ----
+    // data
+    // ----
+
+    adjacency_set* volatile     segment[segments];
+    stripe*                     locks;
+    volatile vertices_size_type claimed; // the vertices handed out
+    volatile edges_size_type    ne;
+    adjacency_set               prototype;
+
+    // ------
+    // locate
+    // ------
+
+    /**
+     * vertex v is element i of segment k
+     */
+    static void locate (vertices_size_type v, std::size_t& k, vertices_size_type& i) {
+      const vertices_size_type q = v / first_segment + 1;
+      k = sizeof(unsigned long) * CHAR_BIT - 1 - __builtin_clzl(q);
+      i = v - first_segment * ((vertices_size_type(1) << k) - 1);
+    }
+
+    const adjacency_set& at (vertices_size_type v) const {
+      std::size_t        k;
+      vertices_size_type i;
+      locate(v, k, i);
+      return segment[k][i];
+    }
+
+    adjacency_set& at (vertices_size_type v) {
+      std::size_t        k;
+      vertices_size_type i;
+      locate(v, k, i);
+      return segment[k][i];
+    }
+
+    // -------
+    // provide
+    // -------
+
+    /**
+     * makes sure the segments up to the one of vertex v exist
+     * racing threads may both build a segment; the loser frees its copy
+     */
+    void provide (vertices_size_type v) {
+      std::size_t        last;
+      vertices_size_type i;
+      locate(v, last, i);
+      for (std::size_t k = 0; k <= last; ++k) {
+	if (segment[k])
+	  continue;
+	const vertices_size_type size = vertices_size_type(first_segment) << k;
+	adjacency_set*           p    = new adjacency_set[size];
+	std::fill(p, p + size, prototype);
+	if (!__sync_bool_compare_and_swap(&segment[k], static_cast<adjacency_set*>(0), p))
+	  delete [] p;
+      }
+    }
+
+    // ----
+    // lock
+    // ----
+
+    /**
+     * spins, yielding the processor every 64 turns, so a holder that was
+     * preempted (more writers than cores) gets to run
+     */
+    void lock (vertices_size_type v) const {
+      volatile int& busy = locks[v % stripes].busy;
+      for (int spins = 0; __sync_lock_test_and_set(&busy, 1); )
+	while (busy)
+	  if (++spins % 64 == 0)
+	    sched_yield();
+    }
+
+    void unlock (vertices_size_type v) const {
+      __sync_lock_release(&locks[v % stripes].busy);
+    }
+
+    void initialize () {
+      for (std::size_t k = 0; k != segments; ++k)
+	segment[k] = 0;
+      locks = new stripe[stripes];
+      for (std::size_t s = 0; s != stripes; ++s)
+	locks[s].busy = 0;
+    }
+
+    // -----
+    // valid
+    // -----
+
+    bool valid () const {
+      return prototype.empty() && (locks != 0);
+    }
+
+    // no copies, other threads may hold references into the segments
+    BasicConcurrentGraph (const BasicConcurrentGraph&);
+    BasicConcurrentGraph& operator = (const BasicConcurrentGraph&);
+
+  public:
+    // ------------
+    // constructors
+    // ------------
+
+    BasicConcurrentGraph () : claimed(0), ne(0) {
+      initialize();
+      assert(valid());
+    }
+
+    /**
+     * every vertex starts as a copy of prototype
+     */
+    explicit BasicConcurrentGraph (const adjacency_set& prototype) :
+	claimed(0), ne(0), prototype(prototype) {
+      initialize();
+      assert(valid());
+    }
+
+    /**
+     * n vertices plus the edges of [first, last), built by add_edges
+     */
+    template <typename FI>
+    BasicConcurrentGraph (vertices_size_type n, FI first, FI last) : claimed(0), ne(0) {
+      initialize();
+      reserve_vertices(n, *this);
+      for (vertices_size_type i = 0; i != n; ++i)
+	add_vertex(*this);
+      add_edges(first, last, *this);
+      assert(valid());
+    }
+
+    ~BasicConcurrentGraph () {
+      for (std::size_t k = 0; k != segments; ++k)
+	delete [] segment[k];
+      delete [] locks;
+    }
+  };
+
+  // ---------------
+  // ConcurrentGraph
+  // ---------------
+
+  /**
+   * Graph that accepts concurrent add_vertex, add_edge and remove_edge
+   */
+  typedef BasicConcurrentGraph< std::set<unsigned int> > ConcurrentGraph;
+
+} // cs
+
+#endif // ConcurrentGraph_h
@@ -0,0 +1,385 @@
+// -----------------------------
+// projects/c++/graph/CsrGraph.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// -----------------------------
+
+#ifndef CsrGraph_h
+#define CsrGraph_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // lower_bound, sort
+#include <cassert>   // assert
+#include <cstddef>   // ptrdiff_t, size_t
+#include <iterator>  // forward_iterator_tag, iterator
+#include <utility>   // make_pair, pair
+#include <vector>    // vector
+
+// ----------
+// namespaces
+// ----------
+
+namespace cs {
+
+  // ---------------
+  // CsrEdgeIterator
+  // ---------------
+
+  /**
+   * iterates the edges of any compressed-sparse-row layout
+   * walks the targets array once, bumping the source vertex whenever
+   * the position crosses the next row offset
+   * holds nothing but pointers and indices, so copies are cheap
+   */
+  template <typename Offset, typename Target>
+  class CsrEdgeIterator :
+    public std::iterator<std::forward_iterator_tag, std::pair<Target, Target>,
+			 std::ptrdiff_t, const std::pair<Target, Target>*, std::pair<Target, Target> > {
+  private:
+    const Offset* offsets; // rows + 1 entries
+    const Target* targets;
+    Target        rows;
+    Target        u;
+    Offset        pos;
+
+    void skip_empty_rows () {
+      while ((u < rows) && (offsets[u + 1] <= pos))
+	++u;
+    }
+  public:
+    CsrEdgeIterator (const Offset* offsets, const Target* targets, Target rows, Offset pos) :
+      offsets(offsets), targets(targets), rows(rows), u(0), pos(pos) {
+      skip_empty_rows();
+    }
+
+    CsrEdgeIterator& operator ++ () {
+      ++pos;
+      skip_empty_rows();
+      return *this;
+    }
+
+    CsrEdgeIterator operator ++ (int) {
+      CsrEdgeIterator tmp(*this);
+      ++(*this);
+      return tmp;
+    }
+
+    std::pair<Target, Target> operator * () const {
+      return std::pair<Target, Target>(u, targets[pos]);
+    }
+
+    bool operator == (const CsrEdgeIterator& rhs) const {
+      return (pos == rhs.pos) && (targets == rhs.targets);
+    }
+
+    bool operator != (const CsrEdgeIterator& rhs) const {
+      return !(*this == rhs);
+    }
+  };
+
+  // --------
+  // CsrGraph
+  // --------
+
+  /**
+   * an immutable compressed-sparse-row snapshot of a directed graph
+   * the targets of vertex u are stored contiguously in
+   * targets[offsets[u]] .. targets[offsets[u + 1]], sorted ascending,
+   * so a traversal walks two flat arrays instead of chasing tree nodes
+   * it exposes the same free functions as cs::Graph (minus the mutators),
+   * so the templates in GraphAlgorithms.h run on it unmodified
+   */
+  class CsrGraph {
+  public:
+    // --------
+    // typedefs
+    // --------
+
+    typedef unsigned int vertex_descriptor;
+    typedef std::pair<vertex_descriptor, vertex_descriptor>
+    edge_descriptor;
+
+    typedef const vertex_descriptor* adjacency_iterator;
+
+    typedef std::size_t vertices_size_type;
+    typedef std::size_t edges_size_type;
+    typedef std::size_t degree_size_type;
+
+  public:
+
+    // ---------------
+    // vertex_iterator
+    // ---------------
+
+    /**
+     * vertices are the dense range [0, num_vertices)
+     */
+    class vertex_iterator :
+      public std::iterator<std::forward_iterator_tag, vertex_descriptor,
+			   std::ptrdiff_t, const vertex_descriptor*, vertex_descriptor> {
+    private:
+      vertex_descriptor pos;
+    public:
+      vertex_iterator(vertex_descriptor pos) : pos(pos) {}
+
+      vertex_iterator& operator ++ () {
+	++pos;
+	return *this;
+      }
+
+      vertex_iterator operator ++ (int) {
+	vertex_iterator tmp(*this);
+	++pos;
+	return tmp;
+      }
+
+      vertex_descriptor operator * () const {
+	return pos;
+      }
+
+      bool operator == (const vertex_iterator& rhs) const {
+	return pos == rhs.pos;
+      }
+
+      bool operator != (const vertex_iterator& rhs) const {
+	return pos != rhs.pos;
+      }
+    };
+
+    typedef CsrEdgeIterator<edges_size_type, vertex_descriptor> edge_iterator;
+
+    // -----------------
+    // adjacent_vertices
+    // -----------------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     * @return pointers to the first and one past the last target of x
+     */
+    friend std::pair<adjacency_iterator, adjacency_iterator>
+    adjacent_vertices (vertex_descriptor x, const CsrGraph& myG) {
+      assert(x < myG.num_rows());
+      const vertex_descriptor* t = myG.targets.empty() ? 0 : &myG.targets[0];
+      return std::make_pair(t + myG.offsets[x], t + myG.offsets[x + 1]);
+    }
+
+    // ----------
+    // out_degree
+    // ----------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     */
+    friend degree_size_type
+    out_degree (vertex_descriptor x, const CsrGraph& myG) {
+      std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(x, myG);
+      return p.second - p.first;
+    }
+
+    // ----
+    // edge
+    // ----
+
+    /**
+     * time:O(log(out degree of x))
+     * space:  O(1)
+     * binary search inside the sorted row of x
+     */
+    friend std::pair<edge_descriptor, bool>
+    edge (vertex_descriptor x, vertex_descriptor y, const CsrGraph& myG) {
+      std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(x, myG);
+      adjacency_iterator i = std::lower_bound(p.first, p.second, y);
+      return std::make_pair(edge_descriptor(x, y), (i != p.second) && (*i == y));
+    }
+
+    // -----
+    // edges
+    // -----
+
+    /**
+     * O(1) in space
+     * O(1) in time
+     * @return, a pair of iterator to traverse through all the edges inside a graph
+     */
+    friend std::pair<edge_iterator, edge_iterator>
+    edges (const CsrGraph& myG) {
+      const vertex_descriptor rows = static_cast<vertex_descriptor>(myG.num_rows());
+      const vertex_descriptor* t   = myG.targets.empty() ? 0 : &myG.targets[0];
+      return std::make_pair(edge_iterator(&myG.offsets[0], t, rows, 0),
+			    edge_iterator(&myG.offsets[0], t, rows, myG.targets.size()));
+    }
+
+    // ------
+    // vertex
+    // ------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     */
+    friend vertex_descriptor
+    vertex (vertices_size_type n, const CsrGraph& myG) {
+      assert(n < myG.num_rows());
+      return static_cast<vertex_descriptor>(n);
+    }
+
+    // --------
+    // vertices
+    // --------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     */
+    friend std::pair<vertex_iterator, vertex_iterator>
+    vertices (const CsrGraph& myG) {
+      return std::make_pair(vertex_iterator(0),
+			    vertex_iterator(static_cast<vertex_descriptor>(myG.num_rows())));
+    }
+
+    // ------
+    // source
+    // ------
+
+    friend vertex_descriptor
+    source (edge_descriptor x, const CsrGraph& myG) {
+      assert(x.first < myG.num_rows());
+      return x.first;
+    }
+
+    // ------
+    // target
+    // ------
+
+    friend vertex_descriptor
+    target (edge_descriptor x, const CsrGraph&) {
+      return x.second;
+    }
+
+    // ---------
+    // num_edges
+    // ---------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     */
+    friend edges_size_type
+    num_edges (const CsrGraph& myG) {
+      return myG.targets.size();
+    }
+
+    // ------------
+    // num_vertices
+    // ------------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     */
+    friend vertices_size_type
+    num_vertices (const CsrGraph& myG) {
+      return myG.num_rows();
+    }
+
+  private:
+    // ----
+    // data
+    // ----
+
+    std::vector<edges_size_type>   offsets; // num_vertices + 1 entries
+    std::vector<vertex_descriptor> targets; // num_edges entries
+
+    vertices_size_type num_rows () const {
+      return offsets.size() - 1;
+    }
+
+    // -----
+    // valid
+    // -----
+
+    /**
+     * offsets start at 0, never decrease and end at the number of targets
+     */
+    bool valid () const {
+      if (offsets.empty() || (offsets.front() != 0) || (offsets.back() != targets.size()))
+	return false;
+      for (vertices_size_type i = 0; i != num_rows(); ++i)
+	if (offsets[i] > offsets[i + 1])
+	  return false;
+      return true;
+    }
+
+  public:
+    // ------------
+    // constructors
+    // ------------
+
+    /**
+     * an empty graph
+     */
+    CsrGraph () : offsets(1, 0) {
+      assert(valid());
+    }
+
+    /**
+     * time: O(V + E log(max out degree))
+     * space: O(V + E)
+     * copies the adjacency of any graph that models the free-function
+     * interface of cs::Graph (including boost::adjacency_list)
+     * rows are sorted so that edge() can binary search
+     */
+    template <typename G>
+    explicit CsrGraph (const G& myG) {
+      typedef typename G::adjacency_iterator adjit;
+      const vertices_size_type n = num_vertices(myG);
+      offsets.reserve(n + 1);
+      targets.reserve(num_edges(myG));
+      offsets.push_back(0);
+      for (vertices_size_type i = 0; i != n; ++i) {
+	std::pair<adjit, adjit> p = adjacent_vertices(vertex(i, myG), myG);
+	const edges_size_type row = targets.size();
+	for (adjit b = p.first; b != p.second; ++b)
+	  targets.push_back(static_cast<vertex_descriptor>(*b));
+	std::sort(targets.begin() + row, targets.end());
+	offsets.push_back(targets.size());
+      }
+      assert(valid());
+    }
+
+    /**
+     * time: O(1) (O(V) to check the rows when asserts are on)
+     * adopts rows that are already laid out, leaving the arguments empty
+     * Precondition: offsets start at 0, never decrease and end at
+     * targets.size(); each row is sorted
+     */
+    CsrGraph (std::vector<edges_size_type>& offsets, std::vector<vertex_descriptor>& targets) {
+      this->offsets.swap(offsets);
+      this->targets.swap(targets);
+      assert(valid());
+    }
+
+    // Default copy, destructor, and copy assignment
+  };
+
+  // ------
+  // to_csr
+  // ------
+
+  /**
+   * freezes a graph into a read-only CsrGraph snapshot
+   * later mutations of myG are not reflected in the snapshot
+   */
+  template <typename G>
+  CsrGraph to_csr (const G& myG) {
+    return CsrGraph(myG);
+  }
+
+} // cs
+
+#endif // CsrGraph_h
@@ -0,0 +1,216 @@
+// --------------------------------
+// projects/c++/graph/DagExecutor.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// --------------------------------
+
+#ifndef DagExecutor_h
+#define DagExecutor_h
+
+// --------
+// includes
+// --------
+
+#include <cassert> // assert
+#include <cstddef> // size_t
+#include <utility> // pair
+#include <vector>  // vector
+
+#include <sched.h> // sched_yield
+
+#ifdef _OPENMP
+#include <omp.h> // omp_get_max_threads, omp_get_thread_num
+#endif
+
+#include "GraphAlgorithms.h"
+#include "GraphStats.h"
+
+// ----------
+// namespaces
+// ----------
+
+namespace cs {
+
+  namespace executor {
+
+    // ---------
+    // WorkQueue
+    // ---------
+
+    /**
+     * one worker's ready vertices behind a spin lock
+     * the owner pushes and pops at the back, so it runs what it just
+     * released while the data is still in cache; thieves take from the
+     * front, the vertex that has waited longest
+     * padded so that two queues never share a cache line
+     */
+    template <typename T>
+    class WorkQueue {
+    private:
+      std::vector<T> items;
+      std::size_t    head; // items before it were stolen
+      volatile int   busy;
+      char           padding[64];
+
+      void lock () {
+	for (int spins = 0; __sync_lock_test_and_set(&busy, 1); )
+	  while (busy)
+	    if (++spins % 64 == 0)
+	      sched_yield();
+      }
+
+      void unlock () {
+	__sync_lock_release(&busy);
+      }
+
+      void reset () {
+	if (head == items.size()) {
+	  items.clear();
+	  head = 0;
+	}
+      }
+
+    public:
+      WorkQueue () : head(0), busy(0), padding() {}
+
+      void push (const T& v) {
+	lock();
+	items.push_back(v);
+	unlock();
+      }
+
+      template <typename II>
+      void push (II b, II e) {
+	lock();
+	items.insert(items.end(), b, e);
+	unlock();
+      }
+
+      bool pop (T& v) {
+	lock();
+	const bool found = (head != items.size());
+	if (found) {
+	  v = items.back();
+	  items.pop_back();
+	  reset();
+	}
+	unlock();
+	return found;
+      }
+
+      bool steal (T& v) {
+	lock();
+	const bool found = (head != items.size());
+	if (found) {
+	  v = items[head++];
+	  reset();
+	}
+	unlock();
+	return found;
+      }
+    };
+
+  } // executor
+
+  // -----------
+  // execute_dag
+  // -----------
+
+  /**
+   * runs f(v) for every vertex of a DAG on a pool of threads, each vertex
+   * as soon as every vertex with an edge into it has returned
+   * each vertex keeps a count of its unfinished parents; the thread that
+   * takes it to 0 runs that child next itself and queues any others on its
+   * own WorkQueue, and an idle thread steals from the other queues, so no
+   * thread waits for a whole level to finish
+   * f returns false to report a failure: no vertex starts after that, the
+   * ones already running finish, and execute_dag returns false
+   * each thread calls its own copy of f, concurrently with the others
+   * time: O(V + E) work, plus the calls of f
+   * space: O(V)
+   * @param threads the size of the pool, 0 for omp_get_max_threads()
+   * @param completed set to the number of vertices that returned true
+   * @return true if every vertex ran and returned true; false on a
+   * failure, or if a cycle kept some vertices from ever being ready
+   */
+  template <typename G, typename F>
+  bool execute_dag (const G& myG, F f, std::size_t* completed = 0, int threads = 0) {
+    typedef typename G::vertex_descriptor  vertex_descriptor;
+    typedef typename G::adjacency_iterator adjit;
+    CS_GRAPH_TIMER("execute_dag");
+    const long n = static_cast<long>(num_vertices(myG));
+#ifdef _OPENMP
+    if (threads <= 0)
+      threads = omp_get_max_threads();
+#else
+    threads = 1;
+#endif
+    std::vector<unsigned int> remaining; // parents not yet finished
+    in_degrees(myG, remaining);
+    std::vector< executor::WorkQueue<vertex_descriptor> > queues(threads);
+    volatile long live   = 0; // released and not yet finished, an upper bound
+    volatile int  failed = 0;
+    long          ran    = 0;
+    for (long i = 0; i < n; ++i)
+      if (remaining[i] == 0)
+	queues[live++ % threads].push(vertex(i, myG));
+
+    #pragma omp parallel num_threads(threads) firstprivate(f) reduction(+:ran)
+    {
+#ifdef _OPENMP
+      const int me = omp_get_thread_num();
+#else
+      const int me = 0;
+#endif
+      std::vector<vertex_descriptor> ready;
+      vertex_descriptor              v;
+      bool                           have = false;
+      int                            idle = 0;
+      while (!failed) {
+	if (!have)
+	  have = queues[me].pop(v);
+	for (int k = 1; !have && (k != threads); ++k)
+	  have = queues[(me + k) % threads].steal(v);
+	if (!have) {
+	  if (live == 0)
+	    break;
+	  if (++idle % 16 == 0)
+	    sched_yield();
+	  continue;
+	}
+	idle = 0;
+	if (!f(v)) {
+	  __sync_fetch_and_or(&failed, 1);
+	  break;
+	}
+	++ran;
+	ready.clear();
+	std::pair<adjit, adjit> p = adjacent_vertices(v, myG);
+	for (; p.first != p.second; ++p.first)
+	  if (__sync_sub_and_fetch(&remaining[*p.first], 1) == 0)
+	    ready.push_back(*p.first);
+	// the first child ready takes over the place of v in live, the
+	// rest are counted before anyone can steal them
+	if (ready.empty()) {
+	  __sync_fetch_and_sub(&live, 1);
+	  have = false;
+	}
+	else {
+	  if (ready.size() != 1) {
+	    __sync_fetch_and_add(&live, static_cast<long>(ready.size()) - 1);
+	    queues[me].push(ready.begin() + 1, ready.end());
+	  }
+	  v = ready[0];
+	}
+      }
+    }
+
+    assert((ran <= n) && (failed || (live == 0)));
+    if (completed)
+      *completed = static_cast<std::size_t>(ran);
+    return !failed && (ran == n);
+  }
+
+} // cs
+
+#endif // DagExecutor_h
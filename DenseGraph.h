@@ -0,0 +1,677 @@
+// -------------------------------
+// projects/c++/graph/DenseGraph.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// -------------------------------
+
+#ifndef DenseGraph_h
+#define DenseGraph_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // copy, fill, max, swap
+#include <cassert>   // assert
+#include <climits>   // CHAR_BIT
+#include <cstddef>   // ptrdiff_t, size_t
+#include <iterator>  // forward_iterator_tag, iterator
+#include <new>       // operator delete, operator new
+#include <utility>   // make_pair, pair
+
+#ifdef __SSE2__
+#include <emmintrin.h> // __m128i, _mm_and_si128, _mm_andnot_si128, _mm_load_si128, _mm_or_si128, _mm_store_si128
+#endif
+
+#include "CsrGraph.h"
+
+// ----------
+// namespaces
+// ----------
+
+namespace cs {
+
+  // ----
+  // bits
+  // ----
+
+  /**
+   * kernels over bitset rows of whole cache lines
+   * every row handed to them starts on a 64 byte boundary and is a
+   * multiple of line_words words long, so the SSE2 loops need neither
+   * a prologue nor a tail; without SSE2 they fall back to word loops
+   * there is no SSE2 popcount, so the counts stay scalar, four words
+   * per iteration (a single popcnt each when built with -mpopcnt)
+   */
+  namespace bits {
+
+    typedef unsigned long word;
+
+    enum {line_bytes = 64, word_bits = sizeof(word) * CHAR_BIT, line_words = line_bytes / sizeof(word)};
+
+    inline std::size_t count (word w) {
+      return __builtin_popcountl(w);
+    }
+
+    inline std::size_t lowest (word w) {
+      return __builtin_ctzl(w);
+    }
+
+    /**
+     * dst |= src
+     */
+    inline void or_into (word* dst, const word* src, std::size_t words) {
+#ifdef __SSE2__
+      __m128i*       d = reinterpret_cast<__m128i*>(dst);
+      const __m128i* s = reinterpret_cast<const __m128i*>(src);
+      for (std::size_t i = 0; i != words * sizeof(word) / sizeof(__m128i); ++i)
+	_mm_store_si128(d + i, _mm_or_si128(_mm_load_si128(d + i), _mm_load_si128(s + i)));
+#else
+      for (std::size_t i = 0; i != words; ++i)
+	dst[i] |= src[i];
+#endif
+    }
+
+    /**
+     * dst &= src
+     */
+    inline void and_into (word* dst, const word* src, std::size_t words) {
+#ifdef __SSE2__
+      __m128i*       d = reinterpret_cast<__m128i*>(dst);
+      const __m128i* s = reinterpret_cast<const __m128i*>(src);
+      for (std::size_t i = 0; i != words * sizeof(word) / sizeof(__m128i); ++i)
+	_mm_store_si128(d + i, _mm_and_si128(_mm_load_si128(d + i), _mm_load_si128(s + i)));
+#else
+      for (std::size_t i = 0; i != words; ++i)
+	dst[i] &= src[i];
+#endif
+    }
+
+    /**
+     * dst &= ~src
+     */
+    inline void andnot_into (word* dst, const word* src, std::size_t words) {
+#ifdef __SSE2__
+      __m128i*       d = reinterpret_cast<__m128i*>(dst);
+      const __m128i* s = reinterpret_cast<const __m128i*>(src);
+      for (std::size_t i = 0; i != words * sizeof(word) / sizeof(__m128i); ++i)
+	_mm_store_si128(d + i, _mm_andnot_si128(_mm_load_si128(s + i), _mm_load_si128(d + i)));
+#else
+      for (std::size_t i = 0; i != words; ++i)
+	dst[i] &= ~src[i];
+#endif
+    }
+
+    /**
+     * @return the number of bits set in a
+     */
+    inline std::size_t count (const word* a, std::size_t words) {
+      std::size_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+      for (std::size_t i = 0; i != words; i += 4) {
+	c0 += count(a[i]);
+	c1 += count(a[i + 1]);
+	c2 += count(a[i + 2]);
+	c3 += count(a[i + 3]);
+      }
+      return c0 + c1 + c2 + c3;
+    }
+
+    /**
+     * @return the number of bits set in both a and b
+     */
+    inline std::size_t count_and (const word* a, const word* b, std::size_t words) {
+      std::size_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+      for (std::size_t i = 0; i != words; i += 4) {
+	c0 += count(a[i]     & b[i]);
+	c1 += count(a[i + 1] & b[i + 1]);
+	c2 += count(a[i + 2] & b[i + 2]);
+	c3 += count(a[i + 3] & b[i + 3]);
+      }
+      return c0 + c1 + c2 + c3;
+    }
+
+  } // bits
+
+  // ----------
+  // DenseGraph
+  // ----------
+
+  /**
+   * a directed graph stored as an adjacency matrix, one bitset row per
+   * vertex, for dense graphs of a few thousand vertices
+   * every row starts on a cache line and all rows have the same stride,
+   * so edge, add_edge and remove_edge are a single bit operation and a
+   * whole row can be combined with another by the kernels of cs::bits
+   * memory: capacity^2 / 8 bytes whatever the number of edges, where
+   * capacity is num_vertices rounded up to a multiple of 512 (and grown
+   * by doubling; reserve_vertices avoids the slack); 4096 vertices take
+   * 2 MB, against about 40 bytes per edge for std::set
+   * it exposes the same free functions as cs::Graph, adjacent_vertices
+   * visiting the set bits of a row in ascending order, so the templates
+   * in GraphAlgorithms.h run on it unmodified
+   */
+  class DenseGraph {
+  public:
+    // --------
+    // typedefs
+    // --------
+
+    typedef unsigned int vertex_descriptor;
+    typedef std::pair<vertex_descriptor, vertex_descriptor>
+    edge_descriptor;
+
+    typedef bits::word word;
+
+    typedef std::size_t vertices_size_type;
+    typedef std::size_t edges_size_type;
+    typedef std::size_t degree_size_type;
+
+    typedef CsrGraph::vertex_iterator vertex_iterator;
+
+    // ------------------
+    // adjacency_iterator
+    // ------------------
+
+    /**
+     * the set bits of one row, lowest first
+     * keeps the bits of the current word not yet visited, so ++ is a
+     * clear of the lowest bit plus a skip over zero words
+     */
+    class adjacency_iterator :
+      public std::iterator<std::forward_iterator_tag, vertex_descriptor,
+			   std::ptrdiff_t, const vertex_descriptor*, vertex_descriptor> {
+    private:
+      const word* row;
+      std::size_t i;     // the current word
+      std::size_t words;
+      word        rest;  // the bits of row[i] not yet visited
+
+      void skip_zeros () {
+	while ((rest == 0) && (i != words))
+	  rest = (++i != words) ? row[i] : 0;
+      }
+    public:
+      adjacency_iterator (const word* row, std::size_t i, std::size_t words) :
+	  row(row), i(i), words(words), rest((i != words) ? row[i] : 0) {
+	skip_zeros();
+      }
+
+      adjacency_iterator& operator ++ () {
+	rest &= rest - 1;
+	skip_zeros();
+	return *this;
+      }
+
+      adjacency_iterator operator ++ (int) {
+	adjacency_iterator tmp(*this);
+	++(*this);
+	return tmp;
+      }
+
+      vertex_descriptor operator * () const {
+	return static_cast<vertex_descriptor>(i * bits::word_bits + bits::lowest(rest));
+      }
+
+      bool operator == (const adjacency_iterator& rhs) const {
+	return (i == rhs.i) && (rest == rhs.rest);
+      }
+
+      bool operator != (const adjacency_iterator& rhs) const {
+	return !(*this == rhs);
+      }
+    };
+
+    // -------------
+    // edge_iterator
+    // -------------
+
+    /**
+     * the rows one after another, skipping the empty ones
+     */
+    class edge_iterator :
+      public std::iterator<std::forward_iterator_tag, edge_descriptor,
+			   std::ptrdiff_t, const edge_descriptor*, edge_descriptor> {
+    private:
+      const DenseGraph*  thegraph;
+      vertex_descriptor  u;
+      adjacency_iterator pos;
+
+      void skip_exhausted () {
+	while ((u != thegraph->n) && (pos == thegraph->row_end(u)))
+	  if (++u != thegraph->n)
+	    pos = thegraph->row_begin(u);
+      }
+    public:
+      edge_iterator (const DenseGraph* g, vertex_descriptor u) :
+	  thegraph(g), u(u), pos((u != g->n) ? g->row_begin(u) : g->row_end(0)) {
+	skip_exhausted();
+      }
+
+      edge_iterator& operator ++ () {
+	++pos;
+	skip_exhausted();
+	return *this;
+      }
+
+      edge_iterator operator ++ (int) {
+	edge_iterator tmp(*this);
+	++(*this);
+	return tmp;
+      }
+
+      edge_descriptor operator * () const {
+	return edge_descriptor(u, *pos);
+      }
+
+      bool operator == (const edge_iterator& rhs) const {
+	return (u == rhs.u) && ((u == thegraph->n) || (pos == rhs.pos));
+      }
+
+      bool operator != (const edge_iterator& rhs) const {
+	return !(*this == rhs);
+      }
+    };
+
+    // -----------
+    // remove_edge
+    // -----------
+
+    /**
+     * time:O(1)
+     * removing an edge that does not exist leaves the graph unchanged
+     */
+    friend void remove_edge
+    (vertex_descriptor u, vertex_descriptor v, DenseGraph& myG) {
+      assert((u < myG.n) && (v < myG.n));
+      word&      w    = myG.row(u)[v / bits::word_bits];
+      const word mask = word(1) << (v % bits::word_bits);
+      if (w & mask) {
+	w &= ~mask;
+	--myG.ne;
+      }
+    }
+
+    // --------
+    // add_edge
+    // --------
+
+    /**
+     * time:O(1)
+     * @return std::pair<edge_descriptor, bool>
+     * bool = false, if the edge already exist inside the graph
+     */
+    friend std::pair<edge_descriptor, bool>
+    add_edge (vertex_descriptor x, vertex_descriptor y, DenseGraph& myG) {
+      assert((x < myG.n) && (y < myG.n));
+      word&      w    = myG.row(x)[y / bits::word_bits];
+      const word mask = word(1) << (y % bits::word_bits);
+      if (w & mask)
+	return std::make_pair(edge_descriptor(x, y), false);
+      w |= mask;
+      ++myG.ne;
+      return std::make_pair(edge_descriptor(x, y), true);
+    }
+
+    // ----------
+    // add_vertex
+    // ----------
+
+    /**
+     * time:O(1) amortized, O(V^2) when the capacity doubles
+     * @return the new vertex, with no edges
+     */
+    friend vertex_descriptor
+    add_vertex (DenseGraph& myG) {
+      if (myG.n == myG.capacity)
+	myG.grow(std::max<vertices_size_type>(2 * myG.capacity, bits::line_bytes * CHAR_BIT));
+      return static_cast<vertex_descriptor>(myG.n++);
+    }
+
+    // ----------------
+    // reserve_vertices
+    // ----------------
+
+    /**
+     * time: O(n^2 / 8) bytes zeroed
+     * sizes the matrix for n vertices up front
+     */
+    friend void
+    reserve_vertices (vertices_size_type n, DenseGraph& myG) {
+      const vertices_size_type line_bits = bits::line_bytes * CHAR_BIT;
+      if (n > myG.capacity)
+	myG.grow((n + line_bits - 1) / line_bits * line_bits);
+    }
+
+    // -----------------
+    // adjacent_vertices
+    // -----------------
+
+    /**
+     * time:O(1), each increment O(1) amortized over the V / 64 words
+     * space:  O(1)
+     * @return the targets of x, ascending
+     */
+    friend std::pair<adjacency_iterator, adjacency_iterator>
+    adjacent_vertices (vertex_descriptor x, const DenseGraph& myG) {
+      assert(x < myG.n);
+      return std::make_pair(myG.row_begin(x), myG.row_end(x));
+    }
+
+    // ----------
+    // out_degree
+    // ----------
+
+    /**
+     * time:O(V / 64), a popcount of the row
+     * space:  O(1)
+     */
+    friend degree_size_type
+    out_degree (vertex_descriptor x, const DenseGraph& myG) {
+      assert(x < myG.n);
+      return bits::count(myG.row(x), myG.stride);
+    }
+
+    // ----
+    // edge
+    // ----
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     */
+    friend std::pair<edge_descriptor, bool>
+    edge (vertex_descriptor x, vertex_descriptor y, const DenseGraph& myG) {
+      assert((x < myG.n) && (y < myG.n));
+      const bool b = (myG.row(x)[y / bits::word_bits] >> (y % bits::word_bits)) & 1;
+      return std::make_pair(edge_descriptor(x, y), b);
+    }
+
+    // -----
+    // edges
+    // -----
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     */
+    friend std::pair<edge_iterator, edge_iterator>
+    edges (const DenseGraph& myG) {
+      const vertex_descriptor n = static_cast<vertex_descriptor>(myG.n);
+      return std::make_pair(edge_iterator(&myG, 0), edge_iterator(&myG, n));
+    }
+
+    // ------
+    // vertex
+    // ------
+
+    friend vertex_descriptor
+    vertex (vertices_size_type n, const DenseGraph& myG) {
+      assert(n < myG.n);
+      return static_cast<vertex_descriptor>(n);
+    }
+
+    // --------
+    // vertices
+    // --------
+
+    friend std::pair<vertex_iterator, vertex_iterator>
+    vertices (const DenseGraph& myG) {
+      return std::make_pair(vertex_iterator(0),
+			    vertex_iterator(static_cast<vertex_descriptor>(myG.n)));
+    }
+
+    // ------
+    // source
+    // ------
+
+    friend vertex_descriptor
+    source (edge_descriptor x, const DenseGraph& myG) {
+      assert(x.first < myG.n);
+      return x.first;
+    }
+
+    // ------
+    // target
+    // ------
+
+    friend vertex_descriptor
+    target (edge_descriptor x, const DenseGraph& myG) {
+      assert(x.second < myG.n);
+      return x.second;
+    }
+
+    // ---------
+    // num_edges
+    // ---------
+
+    /**
+     * time:O(1), kept by the mutators; the row operations recount the
+     * row they change with a popcount
+     */
+    friend edges_size_type
+    num_edges (const DenseGraph& myG) {
+      return myG.ne;
+    }
+
+    // ------------
+    // num_vertices
+    // ------------
+
+    friend vertices_size_type
+    num_vertices (const DenseGraph& myG) {
+      return myG.n;
+    }
+
+    // --------------
+    // row operations
+    // --------------
+
+    /**
+     * time:O(1)
+     * @return the bitset of the targets of x, row_words(myG) words,
+     * 64 byte aligned; bit y of the row is the edge (x, y)
+     */
+    friend const word*
+    adjacency_row (vertex_descriptor x, const DenseGraph& myG) {
+      assert(x < myG.n);
+      return myG.row(x);
+    }
+
+    friend std::size_t
+    row_words (const DenseGraph& myG) {
+      return myG.stride;
+    }
+
+    /**
+     * time:O(V / 64)
+     * gives x every target of y
+     */
+    friend void
+    row_union (vertex_descriptor x, vertex_descriptor y, DenseGraph& myG) {
+      assert((x < myG.n) && (y < myG.n));
+      myG.ne -= out_degree(x, myG);
+      bits::or_into(myG.row(x), myG.row(y), myG.stride);
+      myG.ne += out_degree(x, myG);
+    }
+
+    /**
+     * time:O(V / 64)
+     * keeps the targets of x that are also targets of y
+     */
+    friend void
+    row_intersection (vertex_descriptor x, vertex_descriptor y, DenseGraph& myG) {
+      assert((x < myG.n) && (y < myG.n));
+      myG.ne -= out_degree(x, myG);
+      bits::and_into(myG.row(x), myG.row(y), myG.stride);
+      myG.ne += out_degree(x, myG);
+    }
+
+    /**
+     * time:O(V / 64)
+     * drops the targets of x that are also targets of y
+     */
+    friend void
+    row_difference (vertex_descriptor x, vertex_descriptor y, DenseGraph& myG) {
+      assert((x < myG.n) && (y < myG.n));
+      myG.ne -= out_degree(x, myG);
+      bits::andnot_into(myG.row(x), myG.row(y), myG.stride);
+      myG.ne += out_degree(x, myG);
+    }
+
+    /**
+     * time:O(V / 64)
+     * @return the number of vertices that are targets of both x and y
+     */
+    friend std::size_t
+    common_successors (vertex_descriptor x, vertex_descriptor y, const DenseGraph& myG) {
+      assert((x < myG.n) && (y < myG.n));
+      return bits::count_and(myG.row(x), myG.row(y), myG.stride);
+    }
+
+    // ------------------
+    // transitive_closure
+    // ------------------
+
+    /**
+     * time: O(V^3 / 64), Warshall's algorithm one row union at a time
+     * space: O(1)
+     * adds the edge (u, v) for every path from u to v; for each k the
+     * rows are independent (row k itself cannot change) and run in
+     * parallel under OpenMP
+     */
+    friend void
+    transitive_closure (DenseGraph& myG) {
+      const long n = static_cast<long>(myG.n);
+      for (long k = 0; k < n; ++k) {
+	const word* rk = myG.row(k);
+	const word  mk = word(1) << (k % bits::word_bits);
+	#pragma omp parallel for schedule(static) if (n >= 1024)
+	for (long i = 0; i < n; ++i)
+	  if ((i != k) && (myG.row(i)[k / bits::word_bits] & mk))
+	    bits::or_into(myG.row(i), rk, myG.stride);
+      }
+      myG.ne = 0;
+      for (long i = 0; i < n; ++i)
+	myG.ne += out_degree(static_cast<vertex_descriptor>(i), myG);
+    }
+
+  private:
+    // ----
+    // data
+    // ----
+
+    word*              raw;      // as returned by operator new
+    word*              matrix;   // raw rounded up to a cache line
+    vertices_size_type n;
+    vertices_size_type capacity; // rows, and bits per row
+    std::size_t        stride;   // words per row
+    edges_size_type    ne;
+
+    word* row (vertices_size_type x) const {
+      return matrix + x * stride;
+    }
+
+    adjacency_iterator row_begin (vertices_size_type x) const {
+      return adjacency_iterator(row(x), 0, stride);
+    }
+
+    adjacency_iterator row_end (vertices_size_type x) const {
+      return adjacency_iterator(row(x), stride, stride);
+    }
+
+    // ----
+    // grow
+    // ----
+
+    /**
+     * a new, zeroed capacity x capacity matrix, the old rows copied in
+     */
+    void grow (vertices_size_type c) {
+      DenseGraph that(c, 0);
+      for (vertices_size_type x = 0; x != n; ++x)
+	std::copy(row(x), row(x) + stride, that.row(x));
+      that.n  = n;
+      that.ne = ne;
+      swap(that);
+    }
+
+    void allocate (vertices_size_type c) {
+      capacity = c;
+      stride   = c / bits::word_bits;
+      if (c == 0) {
+	raw = matrix = 0;
+	return;
+      }
+      const std::size_t words = c * stride;
+      raw = static_cast<word*>(::operator new(words * sizeof(word) + bits::line_bytes));
+      const std::size_t address = reinterpret_cast<std::size_t>(raw);
+      matrix = reinterpret_cast<word*>((address + bits::line_bytes - 1) / bits::line_bytes * bits::line_bytes);
+      std::fill(matrix, matrix + words, word(0));
+    }
+
+    void swap (DenseGraph& that) {
+      std::swap(raw,      that.raw);
+      std::swap(matrix,   that.matrix);
+      std::swap(n,        that.n);
+      std::swap(capacity, that.capacity);
+      std::swap(stride,   that.stride);
+      std::swap(ne,       that.ne);
+    }
+
+    // a matrix of c rows, no vertices
+    DenseGraph (vertices_size_type c, int) : n(0), ne(0) {
+      allocate(c);
+    }
+
+    // -----
+    // valid
+    // -----
+
+    bool valid () const {
+      return (n <= capacity) && (stride * bits::word_bits == capacity) &&
+	(capacity % (bits::line_bytes * CHAR_BIT) == 0) &&
+	(reinterpret_cast<std::size_t>(matrix) % bits::line_bytes == 0);
+    }
+
+  public:
+    // ------------
+    // constructors
+    // ------------
+
+    DenseGraph () : n(0), ne(0) {
+      allocate(0);
+      assert(valid());
+    }
+
+    /**
+     * n vertices, no edges
+     */
+    explicit DenseGraph (vertices_size_type n) : n(0), ne(0) {
+      allocate(0);
+      reserve_vertices(n, *this);
+      this->n = n;
+      assert(valid());
+    }
+
+    /**
+     * time: O(V^2 / 8)
+     */
+    DenseGraph (const DenseGraph& that) : n(that.n), ne(that.ne) {
+      allocate(that.capacity);
+      std::copy(that.matrix, that.matrix + capacity * stride, matrix);
+      assert(valid());
+    }
+
+    ~DenseGraph () {
+      ::operator delete(raw);
+    }
+
+    DenseGraph& operator = (DenseGraph that) {
+      swap(that);
+      return *this;
+    }
+  };
+
+} // cs
+
+#endif // DenseGraph_h
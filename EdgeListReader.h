@@ -0,0 +1,223 @@
+// -----------------------------------
+// projects/c++/graph/EdgeListReader.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// -----------------------------------
+
+#ifndef EdgeListReader_h
+#define EdgeListReader_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // max, min
+#include <cstddef>   // size_t
+#include <cstdio>    // fclose, ferror, fopen, fread
+#include <cstring>   // memchr, memmove
+#include <limits>    // numeric_limits
+#include <utility>   // pair
+#include <vector>    // vector
+
+#ifdef _OPENMP
+#include <omp.h> // omp_get_max_threads
+#endif
+
+#include "Graph.h" // add_edges
+
+// ----------
+// namespaces
+// ----------
+
+namespace cs {
+
+  /*
+   * edge list text files, as distributed by SNAP and most graph archives
+   * one edge per line, "source target", separated by blanks or tabs;
+   * further columns (weights, timestamps) are ignored
+   * lines that are empty or start with '#' or '%' are comments
+   * vertex ids are non-negative decimal integers below the largest
+   * vertex_descriptor
+   */
+
+  namespace edge_list {
+
+    inline bool is_blank (char c) {
+      return (c == ' ') || (c == '\t') || (c == '\r');
+    }
+
+    inline const char* end_of_line (const char* b, const char* e) {
+      const void* p = std::memchr(b, '\n', e - b);
+      return p ? static_cast<const char*>(p) : e;
+    }
+
+    // ------------
+    // parse_number
+    // ------------
+
+    /**
+     * @return one past the last digit, 0 if b does not start with a digit
+     * or the number is greater than limit
+     */
+    inline const char* parse_number (const char* b, const char* e, unsigned long limit, unsigned long& x) {
+      if ((b == e) || (*b < '0') || (*b > '9'))
+	return 0;
+      x = 0;
+      do {
+	const unsigned long d = *b - '0';
+	if (x > (limit - d) / 10)
+	  return 0;
+	x = 10 * x + d;
+	++b;
+      } while ((b != e) && ('0' <= *b) && (*b <= '9'));
+      return b;
+    }
+
+    // -----
+    // parse
+    // -----
+
+    /**
+     * appends the edges of the complete lines in [b, e) to out
+     * @return false at the first malformed line, including an id that
+     * does not fit in P::first_type or is its largest value, which leaves
+     * no room for the vertex count
+     */
+    template <typename P>
+    bool parse (const char* b, const char* e, std::vector<P>& out) {
+      const unsigned long limit =
+	std::min<unsigned long>(std::numeric_limits<unsigned long>::max(),
+				std::numeric_limits<typename P::first_type>::max()) - 1;
+      while (b != e) {
+	while ((b != e) && is_blank(*b))
+	  ++b;
+	if (b == e)
+	  break;
+	if ((*b == '#') || (*b == '%') || (*b == '\n')) {
+	  b = end_of_line(b, e);
+	  if (b != e)
+	    ++b;
+	  continue;
+	}
+	unsigned long u;
+	unsigned long v;
+	if (!(b = parse_number(b, e, limit, u)))
+	  return false;
+	while ((b != e) && is_blank(*b))
+	  ++b;
+	if (!(b = parse_number(b, e, limit, v)))
+	  return false;
+	if ((b != e) && !is_blank(*b) && (*b != '\n'))
+	  return false;
+	out.push_back(P(u, v));
+	b = end_of_line(b, e);
+	if (b != e)
+	  ++b;
+      }
+      return true;
+    }
+
+    // ------------
+    // parse_chunks
+    // ------------
+
+    /**
+     * cuts [b, e) at line boundaries into one chunk per thread (times a
+     * few, for balance), parses the chunks in parallel and appends them,
+     * in file order, to out
+     */
+    template <typename P>
+    bool parse_chunks (const char* b, const char* e, std::vector<P>& out) {
+#ifdef _OPENMP
+      const long k = 4 * omp_get_max_threads();
+#else
+      const long k = 1;
+#endif
+      std::vector<const char*> cuts(k + 1, e);
+      cuts[0] = b;
+      for (long i = 1; i < k; ++i) {
+	const char* p = std::max(b + (e - b) / k * i, cuts[i - 1]);
+	p = end_of_line(p, e);
+	cuts[i] = (p == e) ? e : p + 1;
+      }
+      std::vector< std::vector<P> > parts(k);
+      bool ok = true;
+      #pragma omp parallel for schedule(dynamic, 1) reduction(&&:ok)
+      for (long i = 0; i < k; ++i)
+	ok = parse(cuts[i], cuts[i + 1], parts[i]) && ok;
+      for (long i = 0; i < k; ++i)
+	out.insert(out.end(), parts[i].begin(), parts[i].end());
+      return ok;
+    }
+  }
+
+  // --------------
+  // read_edge_list
+  // --------------
+
+  /**
+   * time: O(file size / threads) parsing plus the cost of add_edges
+   * space: O(block_bytes) of text plus the pending edges
+   * streams an edge list file into myG, block by block, so files larger
+   * than memory can be loaded; the lines of each block are parsed in
+   * parallel, and the edges are handed to add_edges in batches of at
+   * least num_vertices(myG), which amortizes its O(V) bucketing per batch
+   * @param block_bytes the size of each read; a longer line grows the block
+   * @return false if the file could not be read or has a malformed line,
+   * in which case myG may hold some of the edges read before the error
+   */
+  template <typename G>
+  bool read_edge_list (const char* path, G& myG, std::size_t block_bytes) {
+    typedef std::pair<typename G::vertex_descriptor, typename G::vertex_descriptor> pair_type;
+    std::FILE* f = std::fopen(path, "rb");
+    if (!f)
+      return false;
+    std::vector<char>      buffer(std::max<std::size_t>(block_bytes, 2));
+    std::vector<pair_type> pending;
+    std::size_t            kept = 0;
+    bool                   ok   = true;
+    while (ok) {
+      if (kept == buffer.size())
+	buffer.resize(2 * buffer.size());
+      const std::size_t wanted = buffer.size() - kept;
+      const std::size_t got    = std::fread(&buffer[kept], 1, wanted, f);
+      const bool        eof    = got < wanted;
+      const char*       b      = &buffer[0];
+      const char*       e      = b + kept + got;
+      if (eof && std::ferror(f))
+	ok = false;
+      if (!eof) {
+	const char* p = e;
+	while ((p != b) && (p[-1] != '\n'))
+	  --p;
+	if (p == b) {
+	  kept += got;
+	  continue;
+	}
+	e = p;
+      }
+      ok = ok && edge_list::parse_chunks(b, e, pending);
+      if (ok && (eof || (pending.size() >= std::max<std::size_t>(num_vertices(myG), 1 << 20)))) {
+	add_edges(pending.begin(), pending.end(), myG);
+	pending.clear();
+      }
+      kept = (b + kept + got) - e;
+      std::memmove(&buffer[0], e, kept);
+      if (eof)
+	break;
+    }
+    std::fclose(f);
+    return ok;
+  }
+
+  /**
+   * read_edge_list with 64 MB blocks
+   */
+  template <typename G>
+  bool read_edge_list (const char* path, G& myG) {
+    return read_edge_list(path, myG, 64 << 20);
+  }
+
+} // cs
+
+#endif // EdgeListReader_h
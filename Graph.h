@@ -11,12 +11,19 @@
 // includes
 // --------
 
-#include <cassert> // assert
-#include <cstddef> // size_t
-#include <list>    // list
-#include <set>     // set
-#include <utility> // make_pair, pair
-#include <vector>  // vector
+#include <algorithm> // max, sort, unique
+#include <cassert>   // assert
+#include <cstddef>   // ptrdiff_t, size_t
+#include <functional> // less
+#include <iterator>  // forward_iterator_tag, iterator, random_access_iterator_tag
+#include <list>      // list
+#include <set>       // set
+#include <utility>   // make_pair, pair
+#include <vector>    // vector
+
+#include "AdjacencySets.h"
+#include "Arena.h"
+#include "GraphStats.h"
 
 // ----------
 // namespaces
@@ -24,120 +31,234 @@
 
 namespace cs {
 
-  // -----
-  // Graph
-  // -----
+  // --------
+  // Teardown
+  // --------
+
+  /**
+   * lives while BasicGraph destroys its adjacency sets; nothing for most
+   * sets, see the specialization for arena sets
+   */
+  template <typename AdjacencySet>
+  struct Teardown {
+    explicit Teardown (const AdjacencySet&) {}
+  };
 
-  class Graph {
+  /**
+   * the arena of the sets discards their nodes, see Arena
+   * std::set still visits every node, but each one costs a branch, not a
+   * lock and a free list push
+   */
+  template <typename T, typename C>
+  struct Teardown< std::set<T, C, ArenaAllocator<T> > > {
+    const ArenaAllocator<T> allocator;
+
+    explicit Teardown (const std::set<T, C, ArenaAllocator<T> >& s) : allocator(s.get_allocator()) {
+      allocator.discard(true);
+    }
+
+    ~Teardown () {
+      allocator.discard(false);
+    }
+  };
+
+  // ----------
+  // BasicGraph
+  // ----------
+
+  /**
+   * a directed graph stored as one adjacency set per vertex
+   * AdjacencySet is the per-vertex container policy, std::set or any
+   * class with the interface described in AdjacencySets.h
+   * every new vertex starts as a copy of an empty prototype set, which
+   * is how an allocator-aware set (ArenaGraph) hands its allocator to
+   * all of the vertices
+   */
+  template <typename AdjacencySet>
+  class BasicGraph {
   public:
     // --------
     // typedefs
     // --------
 
-    typedef unsigned int vertex_descriptor;
+    typedef AdjacencySet adjacency_set;
+
+    typedef typename adjacency_set::value_type vertex_descriptor;
     typedef std::pair<vertex_descriptor, vertex_descriptor>
     edge_descriptor;
     
-    typedef std::set<vertex_descriptor>::iterator adjacency_iterator;
+    typedef typename adjacency_set::iterator adjacency_iterator;
 
     typedef std::size_t vertices_size_type;
     typedef std::size_t edges_size_type;
+    typedef std::size_t degree_size_type;
 
   public:
 
-    // ---------
-    // viterator
-    // ---------
+    // ---------------
+    // vertex_iterator
+    // ---------------
 
     /**
-     * a simple class to iterate through vertex
-     * because we have a vector of set, we need a separate iterator for the 
-     * index which represent the vertex
+     * vertices are the dense range [0, num_vertices), so the iterator is
+     * just the index: random access, and as cheap to copy as an int
      */
-    class vertex_iterator {
+    class vertex_iterator :
+      public std::iterator<std::random_access_iterator_tag, vertex_descriptor,
+			   std::ptrdiff_t, const vertex_descriptor*, vertex_descriptor> {
     private:
       vertex_descriptor pos;
     public:
-      vertex_iterator(vertex_descriptor pos) {
-	this->pos = pos;
-      }
+      vertex_iterator () : pos(0) {}
+
+      vertex_iterator (vertex_descriptor pos) : pos(pos) {}
 
-      vertex_iterator operator ++ () {
+      vertex_iterator& operator ++ () {
 	++pos;
 	return *this;
       }
 
       vertex_iterator operator ++ (int) {
 	vertex_iterator tmp(*this);
-	pos++;
+	++pos;
+	return tmp;
+      }
+
+      vertex_iterator& operator -- () {
+	--pos;
+	return *this;
+      }
+
+      vertex_iterator operator -- (int) {
+	vertex_iterator tmp(*this);
+	--pos;
 	return tmp;
       }
 
-      vertex_descriptor operator * () {
+      vertex_iterator& operator += (std::ptrdiff_t d) {
+	pos += d;
+	return *this;
+      }
+
+      vertex_iterator& operator -= (std::ptrdiff_t d) {
+	pos -= d;
+	return *this;
+      }
+
+      vertex_iterator operator + (std::ptrdiff_t d) const {
+	return vertex_iterator(*this) += d;
+      }
+
+      friend vertex_iterator operator + (std::ptrdiff_t d, const vertex_iterator& rhs) {
+	return rhs + d;
+      }
+
+      vertex_iterator operator - (std::ptrdiff_t d) const {
+	return vertex_iterator(*this) -= d;
+      }
+
+      std::ptrdiff_t operator - (const vertex_iterator& rhs) const {
+	return static_cast<std::ptrdiff_t>(pos) - static_cast<std::ptrdiff_t>(rhs.pos);
+      }
+
+      vertex_descriptor operator * () const {
 	return pos;
       }
 
-      bool operator != (const vertex_iterator& rhs) {
+      vertex_descriptor operator [] (std::ptrdiff_t d) const {
+	return *(*this + d);
+      }
+
+      bool operator == (const vertex_iterator& rhs) const {
+	return pos == rhs.pos;
+      }
+
+      bool operator != (const vertex_iterator& rhs) const {
 	return pos != rhs.pos;
       }
-    };
 
-    // a helper struct to call the edge_iterator constructor for beginning and the end
+      bool operator < (const vertex_iterator& rhs) const {
+	return pos < rhs.pos;
+      }
 
-    struct end_tag {};
-    struct start_tag {};
+      bool operator > (const vertex_iterator& rhs) const {
+	return rhs < *this;
+      }
+
+      bool operator <= (const vertex_iterator& rhs) const {
+	return !(rhs < *this);
+      }
+
+      bool operator >= (const vertex_iterator& rhs) const {
+	return !(*this < rhs);
+      }
+    };
+
+    // -------------
+    // edge_iterator
+    // -------------
 
     /**
-     * inner class to iterate through all the edges inside the graph class
+     * the adjacency sets of the sources [u, n) one after another, skipping
+     * the empty ones
+     * a graph pointer, two indices and an adjacency_iterator, trivially
+     * copyable for every adjacency set in AdjacencySets.h; the end of the
+     * range is u == n, where pos is never looked at
+     * it is only a forward iterator, and its reference is an
+     * edge_descriptor by value, so to split the edges among threads
+     * split the sources instead (see edges(first, last, g) and
+     * parallel_for_each_edge in GraphAlgorithms.h)
      */
-    class edge_iterator {
+    class edge_iterator :
+      public std::iterator<std::forward_iterator_tag, edge_descriptor,
+			   std::ptrdiff_t, const edge_descriptor*, edge_descriptor> {
     private:
-      const Graph* thegraph;
-      vertex_iterator vpos;
-      std::set<vertex_descriptor>::iterator epos;
-      std::set<vertex_descriptor> empty_set; // if the graph is empty 
-      // we need a dummy empty set
-    public:
-     //constructor for begin() of all the edges
-      edge_iterator(const Graph* g, start_tag) : thegraph(g), vpos(vertex_iterator(0)) {
-	if(!( thegraph->g.empty()) ) epos = thegraph->g[*vpos].begin();
-	else epos = empty_set.begin();
-      }
-     //constructor for end() of all the edges
-      edge_iterator(const Graph* g, end_tag) : thegraph(g),
-					       vpos(vertex_iterator(thegraph->g.size() - 1)) {     
-	if(!( thegraph->g.empty()) ) epos = thegraph->g[*vpos].end();
-	else epos = empty_set.end();
+      const BasicGraph*  thegraph;
+      vertex_descriptor  u;
+      vertex_descriptor  n;
+      adjacency_iterator pos;
+
+      // moves past vertices with no (more) out edges
+      void skip_exhausted () {
+	while ((u != n) && (pos == thegraph->g[u].end()))
+	  if (++u != n)
+	    pos = thegraph->g[u].begin();
       }
-      edge_iterator operator ++ () {
-	if(epos == thegraph->g[*vpos].end()) {
-	  vpos++;
-	  epos = thegraph->g[*vpos].begin();
-	}
-	else {
-	  epos++;
+    public:
+      edge_iterator () : thegraph(0), u(0), n(0), pos() {}
+
+      edge_iterator (const BasicGraph* g, vertex_descriptor u, vertex_descriptor n) :
+	  thegraph(g), u(u), n(n), pos() {
+	if (u != n) {
+	  pos = thegraph->g[u].begin();
+	  skip_exhausted();
 	}
+      }
+
+      edge_iterator& operator ++ () {
+	++pos;
+	skip_exhausted();
 	return *this;
       }
 
       edge_iterator operator ++ (int) {
-	edge_iterator tmp = *this;
+	edge_iterator tmp(*this);
 	++(*this);
 	return tmp;
       }
 
-      edge_descriptor operator * () {
-	return edge_descriptor(*vpos, *epos);
+      edge_descriptor operator * () const {
+	return edge_descriptor(u, *pos);
+      }
+
+      bool operator == (const edge_iterator& rhs) const {
+	return (u == rhs.u) && ((u == n) || (pos == rhs.pos));
       }
 
-      bool operator != (const edge_iterator& rhs) {
-	if(this == &rhs)
-	  return false;
-	else
-	  return epos != rhs.epos || vpos != rhs.vpos ||
-	    thegraph != rhs.thegraph;
+      bool operator != (const edge_iterator& rhs) const {
+	return !(*this == rhs);
       }
-    }; // end edge iterator
+    };
 
     // -----------
     // remove_adge
@@ -145,13 +266,17 @@ namespace cs {
 
     /**
      * Removes the edge between u and v
+     * removing an edge that does not exist leaves the graph unchanged
      * @param u The start edge
      * @param v The end edge
      * @param myG the graph
      */
     friend void remove_edge
-    (vertex_descriptor u, vertex_descriptor v, Graph& myG) {
-      myG.g[u].erase(v);
+    (vertex_descriptor u, vertex_descriptor v, BasicGraph& myG) {
+      const edges_size_type erased = myG.g[u].erase(v);
+      myG.ne -= erased;
+      CS_GRAPH_COUNT(remove_edge, 1);
+      CS_GRAPH_COUNT(missing_edges, 1 - erased);
     }
 
     // --------
@@ -167,12 +292,75 @@ namespace cs {
      * will return the edge description of 2 vertices
      */
     friend std::pair<edge_descriptor, bool>
-    add_edge (vertex_descriptor x, vertex_descriptor y, Graph& myG) {
+    add_edge (vertex_descriptor x, vertex_descriptor y, BasicGraph& myG) {
       bool            b = myG.g[x].insert(y).second;
+      if (b)
+	++myG.ne;
+      CS_GRAPH_COUNT(add_edge, 1);
+      CS_GRAPH_COUNT(duplicate_edges, !b);
       edge_descriptor ed(x,y);// = std::make_pair(a,b);
       return std::make_pair(ed, b);
     }
 
+    // ---------
+    // add_edges
+    // ---------
+
+    /**
+     * time: O(E log(d) / threads) plus two serial passes over the range
+     * space: O(V + E)
+     * bulk insertion of a range of edge_descriptors
+     * the targets are bucketed by source (a counting sort), then every
+     * source sorts and dedupes its bucket and merges it into its adjacency
+     * set in one pass; the sources run in parallel under OpenMP
+     * vertices are added as needed to cover every endpoint
+     * [first, last) is traversed twice, so it must be a forward range
+     * @return the number of edges that were not already in the graph
+     */
+    template <typename FI>
+    friend edges_size_type
+    add_edges (FI first, FI last, BasicGraph& myG) {
+      CS_GRAPH_TIMER("add_edges");
+      std::vector<edges_size_type> offsets(myG.g.size() + 1, 0);
+      for (FI i = first; i != last; ++i) {
+	const vertex_descriptor m = std::max(i->first, i->second);
+	if (m >= myG.g.size()) {
+	  myG.g.resize(std::size_t(m) + 1, myG.prototype);
+	  offsets.resize(std::size_t(m) + 2, 0);
+	}
+	++offsets[i->first + 1];
+      }
+      myG.ind = static_cast<vertex_descriptor>(myG.g.size());
+      for (std::size_t u = 1; u != offsets.size(); ++u)
+	offsets[u] += offsets[u - 1];
+
+      std::vector<vertex_descriptor> targets(offsets.back());
+      {
+	std::vector<edges_size_type> cursor(offsets.begin(), offsets.end() - 1);
+	for (FI i = first; i != last; ++i)
+	  targets[cursor[i->first]++] = i->second;
+      }
+
+      const long      n        = static_cast<long>(myG.g.size());
+      edges_size_type inserted = 0;
+      #pragma omp parallel for schedule(dynamic, 256) reduction(+:inserted)
+      for (long u = 0; u < n; ++u) {
+	if (offsets[u] == offsets[u + 1])
+	  continue;
+	typename std::vector<vertex_descriptor>::iterator b = targets.begin() + offsets[u];
+	typename std::vector<vertex_descriptor>::iterator e = targets.begin() + offsets[u + 1];
+	std::sort(b, e);
+	e = std::unique(b, e);
+	const edges_size_type before = myG.g[u].size();
+	myG.g[u].insert(b, e);
+	inserted += myG.g[u].size() - before;
+      }
+      myG.ne += inserted;
+      CS_GRAPH_COUNT(add_edge, offsets.back());
+      CS_GRAPH_COUNT(duplicate_edges, offsets.back() - inserted);
+      return inserted;
+    }
+
     // ----------
     // add_vertex
     // ----------
@@ -184,10 +372,25 @@ namespace cs {
      * @return the new description of the vertex that was added to the graph
      */
     friend vertex_descriptor
-    add_vertex (Graph& myG) {
-      myG.g.push_back( std::set<vertex_descriptor>() );
+    add_vertex (BasicGraph& myG) {
+      CS_GRAPH_COUNT(add_vertex, 1);
+      myG.g.push_back(myG.prototype);
       return myG.ind++;
     }
+
+    // ----------------
+    // reserve_vertices
+    // ----------------
+
+    /**
+     * time: O(V)
+     * makes room for n vertices, so that the following add_vertex calls
+     * do not reallocate (and copy) the vector of adjacency sets
+     */
+    friend void
+    reserve_vertices (vertices_size_type n, BasicGraph& myG) {
+      myG.g.reserve(n);
+    }
         
     // -----------------
     // adjacent_vertices
@@ -202,12 +405,27 @@ namespace cs {
      * of all the adjacent vertices
      */
     friend std::pair<adjacency_iterator, adjacency_iterator>
-    adjacent_vertices (vertex_descriptor x, const Graph& myG) {
+    adjacent_vertices (vertex_descriptor x, const BasicGraph& myG) {
       adjacency_iterator b = myG.g[x].begin();
       adjacency_iterator e = myG.g[x].end();
       return std::make_pair(b, e);
     }
 
+    // ----------
+    // out_degree
+    // ----------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     * @return the number of edges leaving x
+     */
+    friend degree_size_type
+    out_degree (vertex_descriptor x, const BasicGraph& myG) {
+      assert(x < myG.ind);
+      return myG.g[x].size();
+    }
+
     // ----
     // edge
     // ----
@@ -218,8 +436,9 @@ namespace cs {
      * checking whether there is an edge between 2 vertices.
      */
     friend std::pair<edge_descriptor, bool>
-    edge (vertex_descriptor x, vertex_descriptor y, const Graph& myG) {
-      assert(x < (myG.ind - 1));
+    edge (vertex_descriptor x, vertex_descriptor y, const BasicGraph& myG) {
+      assert(x < myG.ind);
+      CS_GRAPH_COUNT(edge_lookups, 1);
       bool            b = myG.g[x].count(y);
       edge_descriptor ed(x, y);
       return std::make_pair(ed, b);
@@ -235,10 +454,23 @@ namespace cs {
      * @return, a pair of iterator to traverse through all the edges inside a graph
      */
     friend std::pair<edge_iterator, edge_iterator>
-    edges (const Graph& mygraph) {
-      edge_iterator b(&mygraph, start_tag());
-      edge_iterator e(&mygraph, end_tag());
-      return std::make_pair(b, e);
+    edges (const BasicGraph& mygraph) {
+      return edges(0, static_cast<vertex_descriptor>(mygraph.g.size()), mygraph);
+    }
+
+    /**
+     * time: O(1) plus the empty sources skipped
+     * space:  O(1)
+     * the edges leaving [first, last), in the same order as in edges(g);
+     * disjoint ranges of sources partition the edges, e.g. one per thread
+     * @return a pair of iterators to traverse through those edges
+     */
+    friend std::pair<edge_iterator, edge_iterator>
+    edges (vertex_descriptor first, vertex_descriptor last, const BasicGraph& mygraph) {
+      assert(first <= last);
+      assert(last <= mygraph.g.size());
+      return std::make_pair(edge_iterator(&mygraph, first, last),
+			    edge_iterator(&mygraph, last, last));
     }
 
     // ------
@@ -252,7 +484,7 @@ namespace cs {
      * @return the vertex which was inserted according to the insertion time
      */
     friend vertex_descriptor
-    vertex (vertices_size_type n, const Graph& myG) {
+    vertex (vertices_size_type n, const BasicGraph& myG) {
       assert(n < myG.g.size());
       return static_cast<vertex_descriptor>(n);
     }
@@ -268,9 +500,9 @@ namespace cs {
      * a specific graph
      */
     friend std::pair<vertex_iterator, vertex_iterator>
-    vertices (const Graph& mygraph) {
+    vertices (const BasicGraph& mygraph) {
       vertex_iterator b(0);
-      vertex_iterator e(mygraph.g.size() - 1);
+      vertex_iterator e(mygraph.g.size());
       return std::make_pair(b, e);
     }
 
@@ -284,7 +516,7 @@ namespace cs {
      * returning the source vertex of an edge inside a graph
      */
     friend vertex_descriptor
-    source (edge_descriptor x, const Graph& myG) {
+    source (edge_descriptor x, const BasicGraph& myG) {
       assert(x.first < myG.g.size() );
       return x.first;
     }
@@ -299,7 +531,7 @@ namespace cs {
      * returning the target vertex of an edge inside a graph
      */
     friend vertex_descriptor
-    target (edge_descriptor x, const Graph& myG) {
+    target (edge_descriptor x, const BasicGraph& myG) {
       return x.second;
     }
 
@@ -310,15 +542,12 @@ namespace cs {
     /**
      * time:O(1) 
      * space:  O(1)
+     * the count is kept current by add_edge and remove_edge
      * @return number of all the edges of  a graph
      */
     friend edges_size_type
-    num_edges (const Graph& myG) {
-      edges_size_type num = 0;
-      for(unsigned int i = 0; i< myG.g.size(); ++i) {
-	num += myG.g[i].size();
-      }
-      return num;
+    num_edges (const BasicGraph& myG) {
+      return myG.ne;
     }
 
     // ------------
@@ -331,7 +560,7 @@ namespace cs {
      * @return number of all the vertices of  a graph
      */
     friend vertices_size_type
-    num_vertices (const Graph& myG) {
+    num_vertices (const BasicGraph& myG) {
       return static_cast<vertices_size_type>(myG.g.size());
     }
 
@@ -342,17 +571,24 @@ namespace cs {
 
     friend class edge_iterator;    //gives edge iterator access to this class 
     				   // private data
-    std::vector< std::set<vertex_descriptor> > g;
+    adjacency_set prototype; //empty, copied into every new vertex
+    std::vector<adjacency_set> g;
     vertex_descriptor ind; //the end index of a graph
+    edges_size_type ne;    //the number of edges, the sum of the set sizes
     // -----
     // valid
     // -----
 
     /**
      * Index always has to be equal to the vector's size
+     * and the edge count to the total size of the adjacency sets
      */
     bool valid () const {
-      return ind == g.size();
+      edges_size_type num = 0;
+      for(unsigned int i = 0; i< g.size(); ++i) {
+	num += g[i].size();
+      }
+      return (ind == g.size()) && (ne == num) && prototype.empty();
     }
 
   public:
@@ -363,18 +599,96 @@ namespace cs {
     /**
      * Default constructor
      */
-    Graph () {
+    BasicGraph () {
       // let the default vector of set constructor to run
       ind = 0;
+      ne = 0;
+      assert(valid());
+    }
+
+    /**
+     * every vertex starts as a copy of prototype, which must be empty
+     * e.g. ArenaGraph g(ArenaGraph::adjacency_set(std::less<unsigned int>(), allocator))
+     * puts the graph in the arena of allocator
+     */
+    explicit BasicGraph (const adjacency_set& prototype) : prototype(prototype) {
+      ind = 0;
+      ne = 0;
       assert(valid());
     }
 
-    // Default copy, destructor, and copy assignment
-    // Graph  (const Graph<T>&);
-    // ~Graph ();
-    // Graph& operator = (const Graph&);
+    /**
+     * n vertices plus the edges of [first, last), built by add_edges
+     */
+    template <typename FI>
+    BasicGraph (vertices_size_type n, FI first, FI last) : g(n, prototype) {
+      ind = static_cast<vertex_descriptor>(n);
+      ne = 0;
+      add_edges(first, last, *this);
+      assert(valid());
+    }
+
+    /**
+     * time: O(V + E)
+     * the sets are destroyed under a Teardown, so an ArenaGraph leaves
+     * its nodes to the arena instead of freeing them one by one
+     */
+    ~BasicGraph () {
+      const Teardown<adjacency_set> t(prototype);
+      std::vector<adjacency_set>().swap(g);
+    }
+
+    // Default copy and copy assignment
+    // BasicGraph  (const BasicGraph&);
+    // BasicGraph& operator = (const BasicGraph&);
   };
 
+  // -----
+  // Graph
+  // -----
+
+  /**
+   * tree based adjacency, O(log d) edge() and insertion
+   */
+  typedef BasicGraph< std::set<unsigned int> > Graph;
+
+  /**
+   * sorted vector adjacency, contiguous iteration and binary search edge()
+   */
+  typedef BasicGraph< FlatSet<unsigned int> > FlatGraph;
+
+  /**
+   * hashed adjacency, O(1) edge() even for vertices of huge out degree
+   */
+  typedef BasicGraph< HashSet<unsigned int> > HashGraph;
+
+  /**
+   * Graph with its set nodes pooled in one Arena per graph
+   * no malloc per add_edge; teardown drops the nodes without freeing
+   * them, and the memory is handed back in a few large chunks when the
+   * graph (and every copy of it) is gone
+   */
+  typedef BasicGraph< std::set<unsigned int, std::less<unsigned int>, ArenaAllocator<unsigned int> > >
+  ArenaGraph;
+
+  // ---------
+  // add_edges
+  // ---------
+
+  /**
+   * the fallback for graphs without a bulk loader (e.g. boost::adjacency_list),
+   * one add_edge per element of [first, last)
+   * @return the number of edges that were not already in the graph
+   */
+  template <typename II, typename G>
+  typename G::edges_size_type
+  add_edges (II first, II last, G& myG) {
+    typename G::edges_size_type inserted = 0;
+    for (; first != last; ++first)
+      inserted += add_edge(first->first, first->second, myG).second;
+    return inserted;
+  }
+
 } // cs
 
 #endif // Graph_h
@@ -11,7 +11,18 @@
 // includes
 // --------
 
-#include <cassert> // assert
+#include <algorithm> // copy, fill, sort, unique
+#include <cassert>   // assert
+#include <cstddef>   // size_t
+#include <iterator>  // back_inserter
+#include <utility>   // make_pair, pair
+#include <vector>    // vector
+
+#ifdef _OPENMP
+#include <omp.h> // omp_get_num_threads, omp_get_thread_num
+#endif
+
+#include "GraphStats.h"
 
 // ----------
 // namespaces
@@ -19,38 +30,115 @@
 
 namespace cs {
 
+  // --------
+  // ColorMap
+  // --------
+
+  enum colors {white, grey, black};
+
+  /**
+   * a colour per vertex, packed 2 bits each (4 vertices per byte)
+   * every vertex starts out white
+   */
+  class ColorMap {
+  private:
+    std::vector<unsigned char> bits;
+
+  public:
+    explicit ColorMap (std::size_t n) : bits((n + 3) / 4, 0) {}
+
+    colors operator [] (std::size_t v) const {
+      return static_cast<colors>((bits[v >> 2] >> ((v & 3) << 1)) & 3);
+    }
+
+    void set (std::size_t v, colors c) {
+      const unsigned int shift = (v & 3) << 1;
+      bits[v >> 2] = static_cast<unsigned char>((bits[v >> 2] & ~(3u << shift)) | (c << shift));
+    }
+  };
+
+  // --------------
+  // parallel_level
+  // --------------
+
+  /**
+   * the narrowest level of a level-synchronous algorithm that is worth
+   * forking threads for; entering an OpenMP region, even one that an `if`
+   * clause serializes, costs more than a narrow level does, and a deep
+   * DAG (a chain) is nothing but narrow levels
+   */
+  const long parallel_level = 1024;
+
+  // -----------------
+  // for_each_in_level
+  // -----------------
+
+  /**
+   * f(i) for every i in [first, last), in parallel if the level is at
+   * least parallel_level wide; no two calls may depend on each other
+   */
+  template <typename F>
+  void for_each_in_level (long first, long last, F f) {
+    if (last - first < parallel_level)
+      for (long i = first; i < last; ++i)
+	f(i);
+    else {
+      #pragma omp parallel for schedule(dynamic, 256)
+      for (long i = first; i < last; ++i)
+	f(i);
+    }
+  }
+
   // ---------
   // has_cycle
   // ---------
 
-  enum colors {white, grey, black};
-
   /**
-   * depth-first traversal
-   * three colors
+   * depth-first traversal from every white vertex
+   * three colors, an explicit stack instead of recursion
+   * so the depth of the graph is only bounded by memory
+   * time: O(V + E)
+   * space: O(V) (2 bits of colour per vertex plus the stack)
    * looking for a cycle inside a graph
    * @return true if the graph has a cycle, false otherwise
    */
   template <typename G>
   bool has_cycle (const G& myG) {
-    std::vector<colors> vc(num_vertices(myG), white);
-    return has_cycle_helper(vc, vertex(0, myG), myG);
-  }
-  
-  template<typename G>
-  bool has_cycle_helper(std::vector<colors>& visited, const typename G::vertex_descriptor& vd, const G& myG) {
+    typedef typename G::vertex_descriptor  vertex_descriptor;
+    typedef typename G::vertex_iterator    vertit;
     typedef typename G::adjacency_iterator adjit;
-    if(visited[vd] == grey) return true;
-    if(visited[vd] == black) return false;
-    std::pair<adjit, adjit> p = adjacent_vertices(vd, myG);
-    adjit b = p.first;
-    adjit e = p.second;
-    while(b != e) {
-      visited[vd] = grey;
-      if(has_cycle_helper(visited, *b, myG)) return true;
-      ++b;
-    }      
-    visited[vd] = black;
+    typedef std::pair<vertex_descriptor, std::pair<adjit, adjit> > frame;
+    CS_GRAPH_TIMER("has_cycle");
+    stats::Tally       tally;
+    ColorMap           visited(num_vertices(myG));
+    std::vector<frame> stack;
+    std::pair<vertit, vertit> p = vertices(myG);
+    for (vertit b = p.first; b != p.second; ++b) {
+      if (visited[*b] != white)
+	continue;
+      visited.set(*b, grey);
+      stack.push_back(frame(*b, adjacent_vertices(*b, myG)));
+      tally.visit();
+      while (!stack.empty()) {
+	std::pair<adjit, adjit>& children = stack.back().second;
+	if (children.first == children.second) {
+	  visited.set(stack.back().first, black);
+	  stack.pop_back();
+	  continue;
+	}
+	const vertex_descriptor vd = *children.first;
+	++children.first;
+	tally.examine();
+	if (visited[vd] == grey)
+	  return true;
+	if (visited[vd] == white) {
+	  visited.set(vd, grey);
+	  stack.push_back(frame(vd, adjacent_vertices(vd, myG)));
+	  tally.visit();
+	  tally.depth(stack.size());
+	}
+      }
+    }
     return false;
   }
 
@@ -59,49 +147,965 @@ namespace cs {
   // ----------------
 
   /**
-   * depth-first traversal
-   * two colors
+   * depth-first traversal from every unvisited vertex
+   * three colors, an explicit stack instead of recursion
+   * writes each vertex once all of its descendants are written
+   * a grey child is a back edge, which trips the precondition
+   * without a separate has_cycle pass
+   * time: O(V + E)
+   * space: O(V)
    * printing a topological ordering of a graph
    * Precondition: !has_cycle(g)
    */
   template <typename G, typename OI>
   void topological_sort (const G& myG, OI x) {
-    assert(!has_cycle(myG));
-    std::vector<colors> vc(num_vertices(myG), white);
-    typedef typename G::vertex_iterator vertit;
+    typedef typename G::vertex_descriptor  vertex_descriptor;
+    typedef typename G::vertex_iterator    vertit;
+    typedef typename G::adjacency_iterator adjit;
+    typedef std::pair<vertex_descriptor, std::pair<adjit, adjit> > frame;
+    CS_GRAPH_TIMER("topological_sort");
+    stats::Tally       tally;
+    ColorMap           visited(num_vertices(myG));
+    std::vector<frame> stack;
     std::pair<vertit, vertit> p = vertices(myG);
-    vertit b = p.first;
-    vertit e = p.second;
+    for (vertit b = p.first; b != p.second; ++b) {
+      if (visited[*b] != white)
+	continue;
+      visited.set(*b, grey);
+      stack.push_back(frame(*b, adjacent_vertices(*b, myG)));
+      tally.visit();
+      while (!stack.empty()) {
+	std::pair<adjit, adjit>& children = stack.back().second;
+	if (children.first == children.second) {
+	  visited.set(stack.back().first, black);
+	  *x = stack.back().first; ++x;
+	  stack.pop_back();
+	  continue;
+	}
+	const vertex_descriptor vd = *children.first;
+	++children.first;
+	tally.examine();
+	assert(visited[vd] != grey);
+	if (visited[vd] == white) {
+	  visited.set(vd, grey);
+	  stack.push_back(frame(vd, adjacent_vertices(vd, myG)));
+	  tally.visit();
+	  tally.depth(stack.size());
+	}
+      }
+    }
+  }
+
+  // ----------
+  // in_degrees
+  // ----------
 
-    while(b != e){
-      topological_sort_helper(vc, *b, x, myG);
-      ++b;
+  /**
+   * indegree[v] is set to the number of edges entering v, counted in
+   * parallel with atomic increments (for graphs without in edges)
+   * time: O(V + E) work
+   * space: O(V)
+   */
+  template <typename G>
+  void in_degrees (const G& myG, std::vector<unsigned int>& indegree) {
+    typedef typename G::adjacency_iterator adjit;
+    const long n = static_cast<long>(num_vertices(myG));
+    indegree.assign(n, 0);
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for (long i = 0; i < n; ++i) {
+      std::pair<adjit, adjit> p = adjacent_vertices(vertex(i, myG), myG);
+      for (adjit b = p.first; b != p.second; ++b) {
+	#pragma omp atomic
+	++indegree[*b];
+      }
     }
   }
 
+  // -------------------------
+  // parallel_topological_sort
+  // -------------------------
+
+  /**
+   * level-synchronous Kahn's algorithm
+   * the in-degrees are counted in parallel, then every vertex of the
+   * current frontier (level) releases its children concurrently;
+   * a child joins the next level when its last parent releases it
+   * each level is sorted, so the result does not depend on the
+   * number of threads
+   * the vertices are written in the same convention as
+   * topological_sort, every vertex after all of its descendants
+   * time: O(V + E) work, O(number of levels) barriers
+   * space: O(V)
+   * runs serially unless compiled with OpenMP
+   * levels narrower than parallel_level run without forking threads
+   * @param levels if not null, (*levels)[v] is set to the length of the
+   * longest path from a source to v; vertices of equal level never
+   * depend on each other
+   * @return false, and writes nothing (not even *levels), if the graph
+   * has a cycle
+   */
   template <typename G, typename OI>
-  void topological_sort_helper(std::vector<colors>& visited,
-			       const typename G::vertex_descriptor& vd,
-			       OI x, const G& myG) {
+  bool parallel_topological_sort (const G& myG, OI x, std::vector<std::size_t>* levels) {
+    typedef typename G::vertex_descriptor  vertex_descriptor;
     typedef typename G::adjacency_iterator adjit;
-    std::pair<adjit, adjit> p = adjacent_vertices(vd, myG);
-    adjit b = p.first;
-    adjit e = p.second;
-
-    if(visited[vd] == black)
-      return;
-    if(e == b) {
-      visited[vd] = black;
-      *x = vd; ++x;
-      return;
-    }
-    while(b != e) {
-      topological_sort_helper(visited, *b, x, myG);
-      ++b;
-    }      
-    visited[vd] = black;
-    *x = vd; ++x;
+    CS_GRAPH_TIMER("parallel_topological_sort");
+    stats::Tally tally;
+    const long n = static_cast<long>(num_vertices(myG));
+    std::vector<unsigned int> indegree;
+    std::vector<vertex_descriptor> order;
+    std::vector<std::size_t>       depth;
+    order.reserve(n);
+    if (levels)
+      depth.assign(n, 0);
+
+    {
+      CS_GRAPH_TIMER("parallel_topological_sort.indegree");
+      in_degrees(myG, indegree);
+    }
+    CS_GRAPH_TIMER("parallel_topological_sort.levels");
+
+    for (long i = 0; i < n; ++i)
+      if (indegree[i] == 0)
+	order.push_back(vertex(i, myG));
+
+    std::size_t first = 0;
+    std::size_t level = 0;
+    while (first != order.size()) {
+      const std::size_t last = order.size();
+      if (static_cast<long>(last - first) < parallel_level) {
+	// narrow levels (a long chain is all of them) skip the OpenMP runtime
+	for (std::size_t i = first; i != last; ++i) {
+	  std::pair<adjit, adjit> p = adjacent_vertices(order[i], myG);
+	  for (adjit b = p.first; b != p.second; ++b) {
+	    tally.examine();
+	    if (--indegree[*b] == 0)
+	      order.push_back(*b);
+	  }
+	}
+      }
+      else {
+	#pragma omp parallel
+	{
+	  std::vector<vertex_descriptor> released;
+	  std::size_t                    examined = 0;
+	  #pragma omp for schedule(dynamic, 256) nowait
+	  for (long i = static_cast<long>(first); i < static_cast<long>(last); ++i) {
+	    std::pair<adjit, adjit> p = adjacent_vertices(order[i], myG);
+	    for (adjit b = p.first; b != p.second; ++b) {
+	      ++examined;
+	      unsigned int d;
+	      #pragma omp atomic capture
+	      d = --indegree[*b];
+	      if (d == 0)
+		released.push_back(*b);
+	    }
+	  }
+	  #pragma omp critical
+	  {
+	    order.insert(order.end(), released.begin(), released.end());
+	    tally.examine(examined);
+	  }
+	}
+      }
+      if (levels)
+	for (std::size_t i = first; i != last; ++i)
+	  depth[order[i]] = level;
+      std::sort(order.begin() + last, order.end());
+      first = last;
+      ++level;
+    }
+
+    tally.visit(order.size());
+    if (order.size() != static_cast<std::size_t>(n))
+      return false;
+    if (levels)
+      levels->swap(depth);
+    std::copy(order.rbegin(), order.rend(), x);
+    return true;
+  }
+
+  /**
+   * parallel_topological_sort without the levels
+   */
+  template <typename G, typename OI>
+  bool parallel_topological_sort (const G& myG, OI x) {
+    return parallel_topological_sort(myG, x, static_cast<std::vector<std::size_t>*>(0));
+  }
+
+  namespace critical {
+
+    // -----
+    // relax
+    // -----
+
+    /**
+     * length[v] and successor[v] from the children of v, all of them done
+     * the child with the longest path wins, the smallest one on a tie
+     */
+    template <typename G, typename D>
+    void relax (const G& myG, typename G::vertex_descriptor v, const std::vector<D>* cost,
+		std::vector<D>& length, std::vector<typename G::vertex_descriptor>& successor) {
+      typedef typename G::vertex_descriptor  vertex_descriptor;
+      typedef typename G::adjacency_iterator adjit;
+      vertex_descriptor       best = v;
+      std::pair<adjit, adjit> p    = adjacent_vertices(v, myG);
+      for (; p.first != p.second; ++p.first) {
+	const vertex_descriptor c = *p.first;
+	if ((best == v) || (length[best] < length[c]) || (!(length[c] < length[best]) && (c < best)))
+	  best = c;
+      }
+      successor[v] = best;
+      length[v]    = (cost ? (*cost)[v] : D(1)) + ((best == v) ? D(0) : length[best]);
+    }
+
+    // -----
+    // Relax
+    // -----
+
+    /**
+     * relax of the i-th vertex of a topological order
+     */
+    template <typename G, typename D>
+    struct Relax {
+      typedef typename G::vertex_descriptor vertex_descriptor;
+      const G&                              myG;
+      const std::vector<vertex_descriptor>& order;
+      const std::vector<D>*                 cost;
+      std::vector<D>&                       length;
+      std::vector<vertex_descriptor>&       successor;
+
+      Relax (const G& myG, const std::vector<vertex_descriptor>& order, const std::vector<D>* cost,
+	     std::vector<D>& length, std::vector<vertex_descriptor>& successor) :
+	  myG(myG), order(order), cost(cost), length(length), successor(successor) {}
+
+      void operator () (long i) const {
+	critical::relax(myG, order[i], cost, length, successor);
+      }
+    };
+
+  } // critical
+
+  // -------------
+  // longest_paths
+  // -------------
+
+  /**
+   * the most expensive path out of every vertex of a DAG, by dynamic
+   * programming over topological_sort, which writes every vertex after
+   * all of its children
+   * length[v] is the cost of the most expensive path that starts at v,
+   * v included, and successor[v] the next vertex on it (v itself for a
+   * sink); a vertex costs (*cost)[v], or 1 if cost is null, so that
+   * length[v] counts the vertices of the longest chain from v
+   * ties go to the smallest child, so the result is the same as
+   * parallel_longest_paths
+   * time: O(V + E)
+   * space: O(V)
+   * Precondition: !has_cycle(g)
+   */
+  template <typename G, typename D>
+  void longest_paths (const G& myG, std::vector<D>& length,
+		      std::vector<typename G::vertex_descriptor>& successor,
+		      const std::vector<D>* cost = 0) {
+    typedef typename G::vertex_descriptor vertex_descriptor;
+    CS_GRAPH_TIMER("longest_paths");
+    const std::size_t n = num_vertices(myG);
+    assert(!cost || (cost->size() == n));
+    std::vector<vertex_descriptor> order;
+    order.reserve(n);
+    topological_sort(myG, std::back_inserter(order));
+    length.assign(n, D(0));
+    successor.resize(n);
+    for (std::size_t i = 0; i != order.size(); ++i)
+      critical::relax(myG, order[i], cost, length, successor);
+  }
+
+  // ----------------------
+  // parallel_longest_paths
+  // ----------------------
+
+  /**
+   * longest_paths, level by level
+   * parallel_topological_sort groups the vertices by their level, and no
+   * two vertices of a level depend on each other; walking the levels from
+   * the deepest up, every vertex of a level reads the finished lengths of
+   * its children concurrently
+   * levels narrower than parallel_level run without forking threads
+   * time: O(V + E) work, O(number of levels) barriers
+   * space: O(V)
+   * @return false, and leaves length and successor alone, if the graph has
+   * a cycle
+   */
+  template <typename G, typename D>
+  bool parallel_longest_paths (const G& myG, std::vector<D>& length,
+			       std::vector<typename G::vertex_descriptor>& successor,
+			       const std::vector<D>* cost = 0) {
+    typedef typename G::vertex_descriptor vertex_descriptor;
+    CS_GRAPH_TIMER("parallel_longest_paths");
+    const std::size_t n = num_vertices(myG);
+    assert(!cost || (cost->size() == n));
+    std::vector<vertex_descriptor> order;
+    std::vector<std::size_t>       levels;
+    order.reserve(n);
+    if (!parallel_topological_sort(myG, std::back_inserter(order), &levels))
+      return false;
+    CS_GRAPH_TIMER("parallel_longest_paths.relax");
+    length.assign(n, D(0));
+    successor.resize(n);
+    for (std::size_t first = 0; first != order.size(); ) {
+      std::size_t last = first;
+      while ((last != order.size()) && (levels[order[last]] == levels[order[first]]))
+	++last;
+      for_each_in_level(static_cast<long>(first), static_cast<long>(last),
+			critical::Relax<G, D>(myG, order, cost, length, successor));
+      first = last;
+    }
+    return true;
+  }
+
+  // -------------
+  // critical_path
+  // -------------
+
+  /**
+   * writes the most expensive path of a DAG from the output of
+   * longest_paths: from the vertex of greatest length (the smallest one on
+   * a tie), along successor, to a sink
+   * time: O(V)
+   * space: O(1)
+   * @return the cost of the path, D(0) for an empty graph
+   */
+  template <typename D, typename V, typename OI>
+  D critical_path (const std::vector<D>& length, const std::vector<V>& successor, OI x) {
+    assert(length.size() == successor.size());
+    if (length.empty())
+      return D(0);
+    V v = 0;
+    for (std::size_t i = 1; i != length.size(); ++i)
+      if (length[v] < length[i])
+	v = static_cast<V>(i);
+    const D total = length[v];
+    for (;;) {
+      *x = v; ++x;
+      if (successor[v] == v)
+	break;
+      v = successor[v];
+    }
+    return total;
   }
+
+  namespace scc {
+
+    const std::size_t unassigned     = static_cast<std::size_t>(-1);
+    const std::size_t parallel_task  = 1 << 14; // smaller tasks run Pearce serially
+
+    // ----------
+    // fetch_add
+    // ----------
+
+    inline std::size_t fetch_add (std::size_t& counter, std::size_t k) {
+      std::size_t old;
+      #pragma omp atomic capture
+      { old = counter; counter += k; }
+      return old;
+    }
+
+    // ----------
+    // Everything
+    // ----------
+
+    template <typename V>
+    struct Everything {
+      bool operator () (V) const {
+	return true;
+      }
+    };
+
+    // ---------
+    // SameColor
+    // ---------
+
+    template <typename V>
+    struct SameColor {
+      const std::vector<std::size_t>& color;
+      std::size_t                     c;
+
+      SameColor (const std::vector<std::size_t>& color, std::size_t c) : color(color), c(c) {}
+
+      bool operator () (V v) const {
+	return color[v] == c;
+      }
+    };
+
+    // ------
+    // pearce
+    // ------
+
+    /**
+     * Pearce's space-efficient variant of Tarjan's algorithm
+     * (Pearce 2016, "A space-efficient algorithm for finding strongly
+     * connected components"), with an explicit stack instead of recursion
+     * searches from the roots [first, last), over the m vertices accepted
+     * by live; a single index per vertex serves as the DFS number while
+     * the vertex is open and as its component afterwards, so the only
+     * other state is one root bit per vertex and the two stacks
+     * root holds the root bit of each vertex (std::vector<bool>, or bytes
+     * when several searches share it across threads)
+     * Precondition: rindex[v] == 0 for the m live vertices
+     * @return k, the number of components; rindex[v] of each root is left
+     * in [0, k), in reverse topological order of the components
+     */
+    template <typename G, typename II, typename Live, typename R>
+    std::size_t pearce (const G& myG, II first, II last, std::size_t m, const Live& live,
+			std::vector<std::size_t>& rindex, R& root) {
+      typedef typename G::vertex_descriptor  vertex_descriptor;
+      typedef typename G::adjacency_iterator adjit;
+      typedef std::pair<vertex_descriptor, std::pair<adjit, adjit> > frame;
+      std::vector<vertex_descriptor> open;           // visited, not yet assigned
+      std::vector<frame>             stack;
+      std::size_t                    index = 1;
+      std::size_t                    c     = m - 1; // the next component, counting down
+      for (II b = first; b != last; ++b) {
+	if (rindex[*b])
+	  continue;
+	root[*b]   = true;
+	rindex[*b] = index++;
+	stack.push_back(frame(*b, adjacent_vertices(*b, myG)));
+	while (!stack.empty()) {
+	  const vertex_descriptor  v        = stack.back().first;
+	  std::pair<adjit, adjit>& children = stack.back().second;
+	  if (children.first != children.second) {
+	    const vertex_descriptor w = *children.first;
+	    if (!live(w)) {
+	      ++children.first;
+	      continue;
+	    }
+	    if (!rindex[w]) {
+	      // descend; w is looked at again, as a finished child, on the way back
+	      root[w]   = true;
+	      rindex[w] = index++;
+	      stack.push_back(frame(w, adjacent_vertices(w, myG)));
+	      continue;
+	    }
+	    if (rindex[w] < rindex[v]) {
+	      rindex[v] = rindex[w];
+	      root[v]   = false;
+	    }
+	    ++children.first;
+	    continue;
+	  }
+	  stack.pop_back();
+	  if (root[v]) {
+	    --index;
+	    while (!open.empty() && (rindex[v] <= rindex[open.back()])) {
+	      rindex[open.back()] = c;
+	      open.pop_back();
+	      --index;
+	    }
+	    rindex[v] = c--;
+	  }
+	  else
+	    open.push_back(v);
+	}
+      }
+      for (II b = first; b != last; ++b)
+	rindex[*b] = (m - 1) - rindex[*b];
+      return (m - 1) - c;
+    }
+  }
+
+  // -----------------------------
+  // strongly_connected_components
+  // -----------------------------
+
+  /**
+   * Pearce's iterative, space-efficient form of Tarjan's algorithm
+   * the components are numbered in reverse topological order of the
+   * condensation: an edge from component i to component j implies i >= j
+   * time: O(V + E)
+   * space: O(V), one index and one bit per vertex plus the stacks
+   * @param component resized to num_vertices, component[v] is the component of v
+   * @return the number of components
+   */
+  template <typename G>
+  std::size_t strongly_connected_components (const G& myG, std::vector<std::size_t>& component) {
+    typedef typename G::vertex_descriptor vertex_descriptor;
+    typedef typename G::vertex_iterator   vertit;
+    CS_GRAPH_TIMER("strongly_connected_components");
+    stats::Tally tally;
+    tally.visit(num_vertices(myG));
+    tally.examine(num_edges(myG));
+    std::vector<bool> root(num_vertices(myG), false);
+    component.assign(num_vertices(myG), 0);
+    std::pair<vertit, vertit> p = vertices(myG);
+    return scc::pearce(myG, p.first, p.second, num_vertices(myG),
+		       scc::Everything<vertex_descriptor>(), component, root);
+  }
+
+  namespace scc {
+
+    // ----------
+    // Transposed
+    // ----------
+
+    /**
+     * the predecessors of every vertex, in compressed-sparse-row form
+     * every thread scans all the edges but only counts and stores those
+     * whose target falls in its own slice of the vertices; that reads
+     * the adjacency once per thread, sequentially, instead of issuing
+     * one atomic, cache-missing update per edge, and keeps each row
+     * sorted by source
+     */
+    template <typename V>
+    struct Transposed {
+      std::vector<std::size_t> offsets;
+      std::vector<V>           sources;
+
+      template <typename G>
+      explicit Transposed (const G& myG) : offsets(num_vertices(myG) + 1, 0) {
+	typedef typename G::adjacency_iterator adjit;
+	CS_GRAPH_TIMER("scc.transpose");
+	const long n = static_cast<long>(num_vertices(myG));
+	#pragma omp parallel
+	{
+#ifdef _OPENMP
+	  const long lo = n * omp_get_thread_num() / omp_get_num_threads();
+	  const long hi = n * (omp_get_thread_num() + 1) / omp_get_num_threads();
+#else
+	  const long lo = 0;
+	  const long hi = n;
+#endif
+	  for (long i = 0; i < n; ++i) {
+	    std::pair<adjit, adjit> p = adjacent_vertices(vertex(i, myG), myG);
+	    for (adjit b = p.first; b != p.second; ++b)
+	      if ((lo <= static_cast<long>(*b)) && (static_cast<long>(*b) < hi))
+		++offsets[*b + 1];
+	  }
+	}
+	for (long i = 0; i < n; ++i)
+	  offsets[i + 1] += offsets[i];
+	sources.resize(offsets[n]);
+	std::vector<std::size_t> cursor(offsets.begin(), offsets.end() - 1);
+	#pragma omp parallel
+	{
+#ifdef _OPENMP
+	  const long lo = n * omp_get_thread_num() / omp_get_num_threads();
+	  const long hi = n * (omp_get_thread_num() + 1) / omp_get_num_threads();
+#else
+	  const long lo = 0;
+	  const long hi = n;
+#endif
+	  for (long i = 0; i < n; ++i) {
+	    std::pair<adjit, adjit> p = adjacent_vertices(vertex(i, myG), myG);
+	    for (adjit b = p.first; b != p.second; ++b)
+	      if ((lo <= static_cast<long>(*b)) && (static_cast<long>(*b) < hi))
+		sources[cursor[*b]++] = vertex(i, myG);
+	  }
+	}
+      }
+
+      std::pair<const V*, const V*> predecessors (V v) const {
+	const V* s = sources.empty() ? 0 : &sources[0];
+	return std::make_pair(s + offsets[v], s + offsets[v + 1]);
+      }
+    };
+
+    // -------
+    // Forward
+    // -------
+
+    template <typename G>
+    struct Forward {
+      typedef typename G::vertex_descriptor  vertex_descriptor;
+      typedef typename G::adjacency_iterator iterator;
+      const G& myG;
+
+      explicit Forward (const G& myG) : myG(myG) {}
+
+      std::pair<iterator, iterator> operator () (vertex_descriptor v) const {
+	return adjacent_vertices(v, myG);
+      }
+    };
+
+    // --------
+    // Backward
+    // --------
+
+    template <typename V>
+    struct Backward {
+      typedef const V* iterator;
+      const Transposed<V>& t;
+
+      explicit Backward (const Transposed<V>& t) : t(t) {}
+
+      std::pair<iterator, iterator> operator () (V v) const {
+	return t.predecessors(v);
+      }
+    };
+
+    // ------
+    // search
+    // ------
+
+    /**
+     * sets bit in flags[w] for every w reachable from pivot inside its
+     * color, level by level; levels at least parallel_level wide are
+     * expanded by all the threads
+     */
+    template <typename N, typename V>
+    void search (const N& next, V pivot, const std::vector<std::size_t>& color,
+		 std::vector<unsigned char>& flags, unsigned char bit) {
+      typedef typename N::iterator iterator;
+      const std::size_t c = color[pivot];
+      std::vector<V>    frontier(1, pivot);
+      std::vector<V>    following;
+      flags[pivot] |= bit;
+      while (!frontier.empty()) {
+	following.clear();
+	const long k = static_cast<long>(frontier.size());
+	if (k < parallel_level) {
+	  for (long i = 0; i < k; ++i) {
+	    std::pair<iterator, iterator> p = next(frontier[i]);
+	    for (; p.first != p.second; ++p.first)
+	      if ((color[*p.first] == c) && !(flags[*p.first] & bit)) {
+		flags[*p.first] |= bit;
+		following.push_back(*p.first);
+	      }
+	  }
+	}
+	else {
+	  #pragma omp parallel
+	  {
+	    std::vector<V> found;
+	    #pragma omp for schedule(dynamic, 256) nowait
+	    for (long i = 0; i < k; ++i) {
+	      std::pair<iterator, iterator> p = next(frontier[i]);
+	      for (; p.first != p.second; ++p.first)
+		if ((color[*p.first] == c) && !(flags[*p.first] & bit) &&
+		    !(__sync_fetch_and_or(&flags[*p.first], bit) & bit))
+		  found.push_back(*p.first);
+	    }
+	    #pragma omp critical
+	    following.insert(following.end(), found.begin(), found.end());
+	  }
+	}
+	frontier.swap(following);
+      }
+    }
+
+    // ----
+    // peel
+    // ----
+
+    /**
+     * v leaves the live graph: its live successors lose a predecessor and
+     * its live predecessors a successor; those left with none are
+     * claimed and appended to found
+     */
+    template <typename G, typename V>
+    void peel (const G& myG, const Transposed<V>& t, V v, std::vector<unsigned int>& in,
+	       std::vector<unsigned int>& out, std::vector<unsigned char>& flags, std::vector<V>& found) {
+      typedef typename G::adjacency_iterator adjit;
+      std::pair<adjit, adjit> p = adjacent_vertices(v, myG);
+      for (; p.first != p.second; ++p.first) {
+	const V w = *p.first;
+	if (flags[w] || (w == v))
+	  continue;
+	unsigned int d;
+	#pragma omp atomic capture
+	d = --in[w];
+	if (!d && !__sync_fetch_and_or(&flags[w], 1))
+	  found.push_back(w);
+      }
+      std::pair<const V*, const V*> q = t.predecessors(v);
+      for (; q.first != q.second; ++q.first) {
+	const V w = *q.first;
+	if (flags[w] || (w == v))
+	  continue;
+	unsigned int d;
+	#pragma omp atomic capture
+	d = --out[w];
+	if (!d && !__sync_fetch_and_or(&flags[w], 1))
+	  found.push_back(w);
+      }
+    }
+
+    // ----
+    // trim
+    // ----
+
+    /**
+     * peels, level by level, every vertex left with no live predecessor
+     * or no live successor (self loops do not count); each is a component
+     * by itself, and on a DAG this alone assigns every vertex
+     */
+    template <typename G, typename V>
+    void trim (const G& myG, const Transposed<V>& t, std::vector<std::size_t>& color,
+	       std::vector<std::size_t>& component, std::size_t& components) {
+      typedef typename G::adjacency_iterator adjit;
+      CS_GRAPH_TIMER("scc.trim");
+      const long                 n = static_cast<long>(num_vertices(myG));
+      std::vector<unsigned int>  in(n, 0);
+      std::vector<unsigned int>  out(n, 0);
+      std::vector<unsigned char> flags(n, 0);
+      std::vector<V>             frontier;
+      std::vector<V>             following;
+      #pragma omp parallel for schedule(dynamic, 1024)
+      for (long i = 0; i < n; ++i) {
+	const V v = vertex(i, myG);
+	std::pair<adjit, adjit> p = adjacent_vertices(v, myG);
+	for (; p.first != p.second; ++p.first)
+	  out[i] += (*p.first != v);
+	std::pair<const V*, const V*> q = t.predecessors(v);
+	for (; q.first != q.second; ++q.first)
+	  in[i] += (*q.first != v);
+      }
+      for (long i = 0; i < n; ++i)
+	if (!in[i] || !out[i]) {
+	  flags[i] = 1;
+	  frontier.push_back(vertex(i, myG));
+	}
+      while (!frontier.empty()) {
+	following.clear();
+	const long k = static_cast<long>(frontier.size());
+	if (k < parallel_level)
+	  for (long i = 0; i < k; ++i)
+	    peel(myG, t, frontier[i], in, out, flags, following);
+	else {
+	  #pragma omp parallel
+	  {
+	    std::vector<V> found;
+	    #pragma omp for schedule(dynamic, 256) nowait
+	    for (long i = 0; i < k; ++i)
+	      peel(myG, t, frontier[i], in, out, flags, found);
+	    #pragma omp critical
+	    following.insert(following.end(), found.begin(), found.end());
+	  }
+	}
+	for (long i = 0; i < k; ++i) {
+	  component[frontier[i]] = components++;
+	  color[frontier[i]]     = unassigned;
+	}
+	frontier.swap(following);
+      }
+    }
+
+    // ----------------
+    // forward_backward
+    // ----------------
+
+    /**
+     * one step of FW-BW on the task holding members: the vertices both
+     * reachable from and reaching the pivot are a component; the ones
+     * only reachable, only reaching, or neither, become three new tasks
+     * (no component can straddle two of them)
+     */
+    template <typename G, typename V>
+    void forward_backward (const G& myG, const Transposed<V>& t, std::vector<V>& members,
+			   std::vector<std::size_t>& color, std::vector<unsigned char>& flags,
+			   std::vector<std::size_t>& component, std::size_t& components,
+			   std::size_t& colors, std::vector< std::vector<V> >& tasks) {
+      CS_GRAPH_TIMER("scc.forward_backward");
+      const V pivot = members[0];
+      search(Forward<G>(myG), pivot, color, flags, 1);
+      search(Backward<V>(t),  pivot, color, flags, 2);
+      const std::size_t id = components++;
+      std::vector<V>    parts[3];
+      for (std::size_t i = 0; i != members.size(); ++i) {
+	const V v = members[i];
+	if (flags[v] == 3) {
+	  component[v] = id;
+	  color[v]     = unassigned;
+	}
+	else
+	  parts[flags[v]].push_back(v);
+	flags[v] = 0;
+      }
+      std::vector<V>().swap(members);
+      for (int k = 0; k != 3; ++k)
+	if (!parts[k].empty()) {
+	  const std::size_t c = colors++;
+	  for (std::size_t i = 0; i != parts[k].size(); ++i)
+	    color[parts[k][i]] = c;
+	  tasks.push_back(std::vector<V>());
+	  tasks.back().swap(parts[k]);
+	}
+    }
+  }
+
+  // --------------------------------------
+  // parallel_strongly_connected_components
+  // --------------------------------------
+
+  /**
+   * trimming, then forward-backward decomposition of what is left
+   * (Fleischer, Hendrickson, Pinar 2000; McLendon et al. 2005; Hong et
+   * al. 2013)
+   * trimming peels, level by level, every vertex left with no live
+   * predecessor or no live successor; on a DAG it does all the work
+   * a task of at least scc::parallel_task vertices is split by FW-BW with
+   * parallel searches from a pivot; smaller tasks, typically many, run
+   * Pearce's algorithm restricted to their vertices, one task per thread
+   * the tasks are processed in rounds, so nothing recurses
+   * the predecessors are built as a transposed CSR, 8 bytes per vertex
+   * plus one vertex_descriptor per edge
+   * the components are numbered by first vertex: the component of vertex
+   * 0 is 0, the next vertex in a new component starts component 1, and
+   * so on, so the result does not depend on the number of threads
+   * time: O(V + E) per FW-BW round plus O(V + E) for the rest
+   * space: O(V + E)
+   * runs serially unless compiled with OpenMP
+   * @param component resized to num_vertices, component[v] is the component of v
+   * @return the number of components
+   */
+  template <typename G>
+  std::size_t parallel_strongly_connected_components (const G& myG, std::vector<std::size_t>& component) {
+    typedef typename G::vertex_descriptor    vertex_descriptor;
+    typedef std::vector<vertex_descriptor>   task;
+    CS_GRAPH_TIMER("parallel_strongly_connected_components");
+    stats::Tally                             tally;
+    tally.visit(num_vertices(myG));
+    const long                               n = static_cast<long>(num_vertices(myG));
+    const scc::Transposed<vertex_descriptor> t(myG);
+    std::vector<std::size_t>                 color(n, 0);
+    std::size_t                              components = 0;
+    std::size_t                              colors     = 1;
+    component.assign(n, scc::unassigned);
+
+    scc::trim(myG, t, color, component, components);
+
+    std::vector<task> tasks(1);
+    for (long i = 0; i < n; ++i)
+      if (color[i] != scc::unassigned)
+	tasks[0].push_back(vertex(i, myG));
+    if (tasks[0].empty())
+      tasks.clear();
+    std::vector<unsigned char> flags(n, 0);
+    std::vector<std::size_t>   rindex(n, 0);
+    while (!tasks.empty()) {
+      std::vector<task> following;
+      std::vector<long> small;
+      for (std::size_t i = 0; i != tasks.size(); ++i)
+	if (tasks[i].size() >= scc::parallel_task)
+	  scc::forward_backward(myG, t, tasks[i], color, flags, component, components, colors, following);
+	else
+	  small.push_back(static_cast<long>(i));
+      const long k = static_cast<long>(small.size());
+      CS_GRAPH_TIMER("scc.small_tasks");
+      #pragma omp parallel for schedule(dynamic, 1)
+      for (long i = 0; i < k; ++i) {
+	task&             members = tasks[small[i]];
+	const std::size_t c       = color[members[0]];
+	const std::size_t found   =
+	  scc::pearce(myG, members.begin(), members.end(), members.size(),
+		      scc::SameColor<vertex_descriptor>(color, c), rindex, flags);
+	const std::size_t first   = scc::fetch_add(components, found);
+	for (std::size_t j = 0; j != members.size(); ++j) {
+	  const vertex_descriptor v = members[j];
+	  component[v] = first + rindex[v];
+	  flags[v]     = 0;
+	}
+      }
+      // pearce reads the color of neighbours in other tasks, so the
+      // finished vertices are uncolored only after the loop
+      for (long i = 0; i < k; ++i) {
+	const task& members = tasks[small[i]];
+	for (std::size_t j = 0; j != members.size(); ++j)
+	  color[members[j]] = scc::unassigned;
+      }
+      tasks.swap(following);
+    }
+
+    // renumber by first vertex
+    std::vector<std::size_t> renumber(components, scc::unassigned);
+    std::size_t              count = 0;
+    for (long i = 0; i < n; ++i) {
+      std::size_t& r = renumber[component[i]];
+      if (r == scc::unassigned)
+	r = count++;
+      component[i] = r;
+    }
+    return count;
+  }
+
+  // ------------
+  // condensation
+  // ------------
+
+  /**
+   * the DAG with one vertex per component and an edge i -> j whenever
+   * some edge of myG leads from component i to component j
+   * the edges are bucketed by source component, sorted and deduplicated
+   * per bucket (in parallel), then added in order
+   * time: O(V + E log E)
+   * space: O(V + E)
+   * Precondition: dag has no vertices; component and count come from
+   * one of the strongly_connected_components functions
+   */
+  template <typename G, typename H>
+  void condensation (const G& myG, const std::vector<std::size_t>& component, std::size_t count, H& dag) {
+    typedef typename G::adjacency_iterator adjit;
+    CS_GRAPH_TIMER("condensation");
+    assert(num_vertices(dag) == 0);
+    const long n = static_cast<long>(num_vertices(myG));
+    std::vector<std::size_t> offsets(count + 1, 0);
+    for (long i = 0; i < n; ++i) {
+      std::pair<adjit, adjit> p = adjacent_vertices(vertex(i, myG), myG);
+      for (; p.first != p.second; ++p.first)
+	offsets[component[i] + 1] += (component[*p.first] != component[i]);
+    }
+    for (std::size_t c = 0; c != count; ++c)
+      offsets[c + 1] += offsets[c];
+    std::vector<std::size_t> targets(offsets[count]);
+    {
+      std::vector<std::size_t> cursor(offsets.begin(), offsets.end() - 1);
+      for (long i = 0; i < n; ++i) {
+	std::pair<adjit, adjit> p = adjacent_vertices(vertex(i, myG), myG);
+	for (; p.first != p.second; ++p.first)
+	  if (component[*p.first] != component[i])
+	    targets[cursor[component[i]]++] = component[*p.first];
+      }
+    }
+    std::vector<std::size_t> ends(count);
+    const long               k = static_cast<long>(count);
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (long c = 0; c < k; ++c) {
+      std::sort(targets.begin() + offsets[c], targets.begin() + offsets[c + 1]);
+      ends[c] = std::unique(targets.begin() + offsets[c], targets.begin() + offsets[c + 1]) - targets.begin();
+    }
+    for (std::size_t c = 0; c != count; ++c)
+      add_vertex(dag);
+    for (std::size_t c = 0; c != count; ++c)
+      for (std::size_t j = offsets[c]; j != ends[c]; ++j)
+	add_edge(vertex(c, dag), vertex(targets[j], dag), dag);
+  }
+
+  // ----------------------
+  // parallel_for_each_edge
+  // ----------------------
+
+  /**
+   * f(std::make_pair(u, v)) for every edge u -> v (the edge_descriptor of
+   * the cs graphs), the sources split among the threads
+   * f is copied into every thread, as std::for_each(std::execution::par, ...)
+   * may do, and must be safe to call on different edges at once
+   * time: O(V + E) / threads
+   * space: O(1)
+   */
+  template <typename G, typename F>
+  void parallel_for_each_edge (const G& myG, F f) {
+    typedef typename G::adjacency_iterator adjit;
+    typedef typename G::vertex_descriptor  vertex_descriptor;
+    const long n = static_cast<long>(num_vertices(myG));
+    #pragma omp parallel for schedule(dynamic, 256) firstprivate(f)
+    for (long i = 0; i < n; ++i) {
+      const vertex_descriptor u = vertex(i, myG);
+      std::pair<adjit, adjit> p = adjacent_vertices(u, myG);
+      for (; p.first != p.second; ++p.first)
+	f(std::make_pair(u, static_cast<vertex_descriptor>(*p.first)));
+    }
+  }
+
 } // cs
 
 #endif // GraphAlgorithms_h
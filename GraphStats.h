@@ -0,0 +1,410 @@
+// -------------------------------
+// projects/c++/graph/GraphStats.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// -------------------------------
+
+#ifndef GraphStats_h
+#define GraphStats_h
+
+/*
+  Operation counters and phase timers for cs::Graph and GraphAlgorithms.h.
+
+  Everything is compiled out unless CS_GRAPH_STATS is defined (before
+  the first include of any graph header, e.g. -DCS_GRAPH_STATS): the
+  macros expand to nothing and Tally is an empty class whose calls the
+  optimizer removes, so an ordinary build pays nothing.
+
+  With CS_GRAPH_STATS:
+    cs::stats::counters() the totals since the last reset()
+    CS_GRAPH_TIMER(name)  times the rest of the enclosing scope, adds it
+                          to the totals of name and, while tracing is
+                          on, records it as an event
+    write_stats(out)      the counters and phase totals as JSON
+    write_trace(out)      the events in the Chrome trace format, for
+                          chrome://tracing or https://ui.perfetto.dev
+*/
+
+// --------
+// includes
+// --------
+
+#include <cstddef> // size_t
+#include <cstring> // memset, strcmp
+#include <ostream> // ostream
+#include <vector>  // vector
+
+#ifdef CS_GRAPH_STATS
+#include <time.h> // clock_gettime, timespec
+
+#ifdef _OPENMP
+#include <omp.h> // omp_get_thread_num
+#endif
+#endif
+
+// ----------
+// namespaces
+// ----------
+
+namespace cs {
+
+  namespace stats {
+
+#ifdef CS_GRAPH_STATS
+    const bool enabled = true;
+#else
+    const bool enabled = false;
+#endif
+
+    // --------
+    // Counters
+    // --------
+
+    /**
+     * what the graphs and the algorithms did, summed over every graph
+     * and every thread
+     */
+    struct Counters {
+      // cs::Graph (and the other BasicGraphs)
+      unsigned long add_vertex;
+      unsigned long add_edge;
+      unsigned long duplicate_edges;  // add_edge and add_edges calls that found the edge
+      unsigned long remove_edge;
+      unsigned long missing_edges;    // remove_edge calls that found nothing
+      unsigned long edge_lookups;     // edge()
+
+      // GraphAlgorithms.h
+      unsigned long algorithm_calls;
+      unsigned long vertices_visited;
+      unsigned long edges_examined;
+      unsigned long max_depth;        // the deepest depth-first stack
+    };
+
+    // -----
+    // Phase
+    // -----
+
+    /**
+     * the calls and total time of one CS_GRAPH_TIMER name
+     */
+    struct Phase {
+      const char*   name;
+      unsigned long calls;
+      double        seconds;
+    };
+
+    // -----
+    // Event
+    // -----
+
+    /**
+     * one timed scope, for the trace
+     * microseconds since the first timer of the process
+     */
+    struct Event {
+      const char* name;
+      double      start;
+      double      duration;
+      int         thread;
+    };
+
+#ifdef CS_GRAPH_STATS
+
+    /**
+     * every counter, phase and event lives in one instance per process
+     */
+    struct State {
+      Counters           counters;
+      std::vector<Phase> phases;
+      std::vector<Event> events;
+      std::size_t        dropped;
+      std::size_t        capacity; // events kept, the rest are dropped
+      bool               tracing;
+      double             origin;
+      volatile int       busy;
+
+      State () : dropped(0), capacity(1 << 20), tracing(false), origin(0), busy(0) {
+	std::memset(&counters, 0, sizeof(counters));
+      }
+    };
+
+    inline State& state () {
+      static State s;
+      return s;
+    }
+
+    /**
+     * guards phases and events, which timers on many threads update
+     */
+    class Lock {
+    private:
+      volatile int& busy;
+
+      Lock (const Lock&);
+      Lock& operator = (const Lock&);
+
+    public:
+      explicit Lock (volatile int& busy) : busy(busy) {
+	while (__sync_lock_test_and_set(&busy, 1))
+	  while (busy) {}
+      }
+
+      ~Lock () {
+	__sync_lock_release(&busy);
+      }
+    };
+
+    /**
+     * monotonic wall clock in seconds, a vDSO call (no system call)
+     */
+    inline double now () {
+      timespec t;
+      clock_gettime(CLOCK_MONOTONIC, &t);
+      return t.tv_sec + t.tv_nsec / 1e9;
+    }
+
+    inline void add (unsigned long& counter, unsigned long n) {
+      __sync_fetch_and_add(&counter, n);
+    }
+
+    inline void raise (unsigned long& counter, unsigned long n) {
+      unsigned long old = counter;
+      while ((n > old) && !__sync_bool_compare_and_swap(&counter, old, n))
+	old = counter;
+    }
+
+    inline const Counters& counters () {
+      return state().counters;
+    }
+
+    /**
+     * zeroes the counters and phases and forgets the events
+     */
+    inline void reset () {
+      State& s = state();
+      Lock   lock(s.busy);
+      std::memset(&s.counters, 0, sizeof(s.counters));
+      s.phases.clear();
+      s.events.clear();
+      s.dropped = 0;
+    }
+
+    /**
+     * starts (or stops) recording an event per timed scope
+     * @param capacity the number of events kept, later ones are dropped
+     */
+    inline void trace (bool on, std::size_t capacity = 1 << 20) {
+      State& s = state();
+      Lock   lock(s.busy);
+      s.tracing  = on;
+      s.capacity = capacity;
+      if (s.origin == 0)
+	s.origin = now();
+    }
+
+    /**
+     * @return the totals of name, zeros if it never ran
+     */
+    inline Phase phase (const char* name) {
+      State& s = state();
+      Lock   lock(s.busy);
+      for (std::size_t i = 0; i != s.phases.size(); ++i)
+	if (std::strcmp(s.phases[i].name, name) == 0)
+	  return s.phases[i];
+      const Phase p = {name, 0, 0};
+      return p;
+    }
+
+    // -----------
+    // ScopedTimer
+    // -----------
+
+    /**
+     * times its own lifetime; the name must outlive the process's use of
+     * the stats (a string literal)
+     */
+    class ScopedTimer {
+    private:
+      const char* name;
+      double      start;
+
+      ScopedTimer (const ScopedTimer&);
+      ScopedTimer& operator = (const ScopedTimer&);
+
+    public:
+      explicit ScopedTimer (const char* name) : name(name), start(now()) {}
+
+      ~ScopedTimer () {
+	const double stop = now();
+	State&       s    = state();
+	Lock         lock(s.busy);
+	std::size_t  i    = 0;
+	while ((i != s.phases.size()) && (std::strcmp(s.phases[i].name, name) != 0))
+	  ++i;
+	if (i == s.phases.size()) {
+	  const Phase p = {name, 0, 0};
+	  s.phases.push_back(p);
+	}
+	++s.phases[i].calls;
+	s.phases[i].seconds += stop - start;
+	if (!s.tracing)
+	  return;
+	if (s.events.size() == s.capacity) {
+	  ++s.dropped;
+	  return;
+	}
+#ifdef _OPENMP
+	const int thread = omp_get_thread_num();
+#else
+	const int thread = 0;
+#endif
+	const Event e = {name, (start - s.origin) * 1e6, (stop - start) * 1e6, thread};
+	s.events.push_back(e);
+      }
+    };
+
+    // -----
+    // Tally
+    // -----
+
+    /**
+     * the counts of one algorithm call, kept in registers and added to
+     * the shared counters once, when the call returns
+     */
+    class Tally {
+    private:
+      unsigned long visited;
+      unsigned long examined;
+      unsigned long deepest;
+
+      Tally (const Tally&);
+      Tally& operator = (const Tally&);
+
+    public:
+      Tally () : visited(0), examined(0), deepest(0) {}
+
+      ~Tally () {
+	Counters& c = state().counters;
+	add(c.algorithm_calls, 1);
+	add(c.vertices_visited, visited);
+	add(c.edges_examined, examined);
+	raise(c.max_depth, deepest);
+      }
+
+      void visit (std::size_t n = 1) {
+	visited += n;
+      }
+
+      void examine (std::size_t n = 1) {
+	examined += n;
+      }
+
+      void depth (std::size_t d) {
+	if (d > deepest)
+	  deepest = d;
+      }
+    };
+
+#define CS_GRAPH_COUNT(field, n) ::cs::stats::add(::cs::stats::state().counters.field, (n))
+#define CS_GRAPH_TIMER_CONCAT(name, line) name ## line
+#define CS_GRAPH_TIMER_NAME(line) CS_GRAPH_TIMER_CONCAT(cs_graph_timer_, line)
+#define CS_GRAPH_TIMER(name) ::cs::stats::ScopedTimer CS_GRAPH_TIMER_NAME(__LINE__)(name)
+
+#else // CS_GRAPH_STATS
+
+    /**
+     * compiled out: every call is empty and inlined away
+     */
+    class Tally {
+    public:
+      void visit (std::size_t = 1) {}
+      void examine (std::size_t = 1) {}
+      void depth (std::size_t) {}
+    };
+
+    inline const Counters& counters () {
+      static const Counters c = Counters();
+      return c;
+    }
+
+    inline void reset () {}
+
+    inline void trace (bool, std::size_t = 0) {}
+
+    inline Phase phase (const char* name) {
+      const Phase p = {name, 0, 0};
+      return p;
+    }
+
+#define CS_GRAPH_COUNT(field, n) ((void) 0)
+#define CS_GRAPH_TIMER(name) ((void) 0)
+
+#endif // CS_GRAPH_STATS
+
+    // -----------
+    // write_stats
+    // -----------
+
+    /**
+     * the counters and the phase totals as one JSON object
+     */
+    inline void write_stats (std::ostream& out) {
+      const Counters& c = counters();
+      out << "{\"enabled\": " << (enabled ? "true" : "false")
+	  << ", \"add_vertex\": "       << c.add_vertex
+	  << ", \"add_edge\": "         << c.add_edge
+	  << ", \"duplicate_edges\": "  << c.duplicate_edges
+	  << ", \"remove_edge\": "      << c.remove_edge
+	  << ", \"missing_edges\": "    << c.missing_edges
+	  << ", \"edge_lookups\": "     << c.edge_lookups
+	  << ", \"algorithm_calls\": "  << c.algorithm_calls
+	  << ", \"vertices_visited\": " << c.vertices_visited
+	  << ", \"edges_examined\": "   << c.edges_examined
+	  << ", \"max_depth\": "        << c.max_depth
+	  << ", \"phases\": [";
+#ifdef CS_GRAPH_STATS
+      State& s = state();
+      Lock   lock(s.busy);
+      for (std::size_t i = 0; i != s.phases.size(); ++i)
+	out << ((i == 0) ? "" : ", ") << "{\"name\": \"" << s.phases[i].name
+	    << "\", \"calls\": " << s.phases[i].calls
+	    << ", \"ms\": " << s.phases[i].seconds * 1e3 << "}";
+#endif
+      out << "]}\n";
+    }
+
+    // -----------
+    // write_trace
+    // -----------
+
+    /**
+     * the recorded events as a Chrome trace (complete "X" events), with
+     * the counters attached as the metadata of the trace
+     */
+    inline void write_trace (std::ostream& out) {
+      out << "{\"traceEvents\": [";
+#ifdef CS_GRAPH_STATS
+      {
+	State& s = state();
+	Lock   lock(s.busy);
+	for (std::size_t i = 0; i != s.events.size(); ++i) {
+	  const Event& e = s.events[i];
+	  out << ((i == 0) ? "\n" : ",\n") << "{\"name\": \"" << e.name
+	      << "\", \"cat\": \"graph\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << e.thread
+	      << ", \"ts\": " << e.start << ", \"dur\": " << e.duration << "}";
+	}
+	out << "\n], \"dropped\": " << s.dropped;
+      }
+#else
+      out << "]";
+#endif
+      out << ", \"displayTimeUnit\": \"ms\", \"metadata\": ";
+      write_stats(out);
+      out << "}\n";
+    }
+
+  } // stats
+
+} // cs
+
+#endif // GraphStats_h
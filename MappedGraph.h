@@ -0,0 +1,437 @@
+// --------------------------------
+// projects/c++/graph/MappedGraph.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// --------------------------------
+
+#ifndef MappedGraph_h
+#define MappedGraph_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // lower_bound, sort
+#include <cassert>   // assert
+#include <cstddef>   // size_t
+#include <cstdio>    // fclose, fopen, fseek, fwrite
+#include <cstring>   // memcmp, memcpy
+#include <iterator>  // distance
+#include <utility>   // make_pair, pair
+#include <vector>    // vector
+
+#include <fcntl.h>    // open
+#include <stdint.h>   // uint32_t, uint64_t
+#include <sys/mman.h> // mmap, munmap
+#include <sys/stat.h> // fstat
+#include <unistd.h>   // close
+
+#include "CsrGraph.h"
+
+// ----------
+// namespaces
+// ----------
+
+namespace cs {
+
+  /*
+   * binary graph file, version 1
+   * a compressed-sparse-row image that is used in place once mapped;
+   * all fields are in the byte order of the machine that wrote the file
+   *
+   *   offset       size         field
+   *   0            8            magic "CSGRAPH1"
+   *   8            4            version, 1
+   *   12           4            flags, bit 0 set if the checksum is valid
+   *   16           8            n, the number of vertices
+   *   24           8            m, the number of edges
+   *   32           8            checksum of everything after the header
+   *   40           8 * (n + 1)  offsets, uint64, offsets[0] = 0, offsets[n] = m
+   *   48 + 8n      4 * m        targets, uint32, each row sorted ascending
+   *
+   * the targets of vertex u are targets[offsets[u]] .. targets[offsets[u + 1]]
+   * the checksum is FNV-1a taken over 32-bit words instead of bytes
+   * (offset basis 14695981039346656037, prime 1099511628211)
+   */
+
+  namespace graph_file {
+    const char     magic[8]     = {'C', 'S', 'G', 'R', 'A', 'P', 'H', '1'};
+    const uint32_t version      = 1;
+    const uint32_t has_checksum = 1;
+
+    struct header {
+      char     magic[8];
+      uint32_t version;
+      uint32_t flags;
+      uint64_t vertices;
+      uint64_t edges;
+      uint64_t checksum;
+    };
+
+    const uint64_t fnv1a_basis = 14695981039346656037u;
+
+    // -----
+    // fnv1a
+    // -----
+
+    /**
+     * folds n 32-bit words into the running hash h
+     */
+    inline uint64_t fnv1a (uint64_t h, const uint32_t* p, std::size_t n) {
+      for (std::size_t i = 0; i != n; ++i) {
+	h ^= p[i];
+	h *= 1099511628211u;
+      }
+      return h;
+    }
+  }
+
+  // -----------
+  // write_graph
+  // -----------
+
+  /**
+   * time: O(V + E log(max out degree))
+   * space: O(max out degree)
+   * writes any graph with the cs::Graph interface in the binary format
+   * above, streaming one row at a time
+   * @param checksum whether to compute and store the checksum
+   * @return false if the file could not be written
+   */
+  template <typename G>
+  bool write_graph (const G& myG, const char* path, bool checksum) {
+    typedef typename G::adjacency_iterator adjit;
+    std::FILE* f = std::fopen(path, "wb");
+    if (!f)
+      return false;
+    graph_file::header h;
+    std::memcpy(h.magic, graph_file::magic, sizeof(h.magic));
+    h.version  = graph_file::version;
+    h.flags    = checksum ? graph_file::has_checksum : 0;
+    h.vertices = num_vertices(myG);
+    h.edges    = 0;
+    h.checksum = graph_file::fnv1a_basis;
+    bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1;
+
+    uint64_t offset = 0;
+    ok = ok && (std::fwrite(&offset, sizeof(offset), 1, f) == 1);
+    if (checksum)
+      h.checksum = graph_file::fnv1a(h.checksum, reinterpret_cast<const uint32_t*>(&offset), 2);
+    for (uint64_t i = 0; ok && (i != h.vertices); ++i) {
+      std::pair<adjit, adjit> p = adjacent_vertices(vertex(i, myG), myG);
+      offset += std::distance(p.first, p.second);
+      ok = std::fwrite(&offset, sizeof(offset), 1, f) == 1;
+      if (checksum)
+	h.checksum = graph_file::fnv1a(h.checksum, reinterpret_cast<const uint32_t*>(&offset), 2);
+    }
+    h.edges = offset;
+
+    std::vector<uint32_t> row;
+    for (uint64_t i = 0; ok && (i != h.vertices); ++i) {
+      std::pair<adjit, adjit> p = adjacent_vertices(vertex(i, myG), myG);
+      row.assign(p.first, p.second);
+      if (row.empty())
+	continue;
+      std::sort(row.begin(), row.end());
+      ok = std::fwrite(&row[0], sizeof(uint32_t), row.size(), f) == row.size();
+      if (checksum)
+	h.checksum = graph_file::fnv1a(h.checksum, &row[0], row.size());
+    }
+
+    if (!checksum)
+      h.checksum = 0;
+    ok = ok && (std::fseek(f, 0, SEEK_SET) == 0) && (std::fwrite(&h, sizeof(h), 1, f) == 1);
+    return (std::fclose(f) == 0) && ok;
+  }
+
+  // -----------
+  // MappedGraph
+  // -----------
+
+  /**
+   * a read-only graph backed directly by a memory mapped graph file
+   * opening it validates the header and maps the file, nothing is copied
+   * or allocated per edge; pages are faulted in as traversals touch them
+   * exposes the same free functions as CsrGraph, so the templates in
+   * GraphAlgorithms.h run on it unmodified
+   */
+  class MappedGraph {
+  public:
+    // --------
+    // typedefs
+    // --------
+
+    typedef uint32_t vertex_descriptor;
+    typedef std::pair<vertex_descriptor, vertex_descriptor>
+    edge_descriptor;
+
+    typedef const vertex_descriptor* adjacency_iterator;
+
+    typedef CsrGraph::vertex_iterator                         vertex_iterator;
+    typedef CsrEdgeIterator<uint64_t, vertex_descriptor>      edge_iterator;
+
+    typedef std::size_t vertices_size_type;
+    typedef std::size_t edges_size_type;
+    typedef std::size_t degree_size_type;
+
+    // -----------------
+    // adjacent_vertices
+    // -----------------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     */
+    friend std::pair<adjacency_iterator, adjacency_iterator>
+    adjacent_vertices (vertex_descriptor x, const MappedGraph& myG) {
+      assert(x < myG.n);
+      return std::make_pair(myG.targets + myG.offsets[x], myG.targets + myG.offsets[x + 1]);
+    }
+
+    // ----------
+    // out_degree
+    // ----------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     */
+    friend degree_size_type
+    out_degree (vertex_descriptor x, const MappedGraph& myG) {
+      std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(x, myG);
+      return p.second - p.first;
+    }
+
+    // ----
+    // edge
+    // ----
+
+    /**
+     * time:O(log(out degree of x))
+     * space:  O(1)
+     */
+    friend std::pair<edge_descriptor, bool>
+    edge (vertex_descriptor x, vertex_descriptor y, const MappedGraph& myG) {
+      std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(x, myG);
+      adjacency_iterator i = std::lower_bound(p.first, p.second, y);
+      return std::make_pair(edge_descriptor(x, y), (i != p.second) && (*i == y));
+    }
+
+    // -----
+    // edges
+    // -----
+
+    friend std::pair<edge_iterator, edge_iterator>
+    edges (const MappedGraph& myG) {
+      const vertex_descriptor rows = static_cast<vertex_descriptor>(myG.n);
+      return std::make_pair(edge_iterator(myG.offsets, myG.targets, rows, 0),
+			    edge_iterator(myG.offsets, myG.targets, rows, myG.m));
+    }
+
+    // ------
+    // vertex
+    // ------
+
+    friend vertex_descriptor
+    vertex (vertices_size_type n, const MappedGraph& myG) {
+      assert(n < myG.n);
+      return static_cast<vertex_descriptor>(n);
+    }
+
+    // --------
+    // vertices
+    // --------
+
+    friend std::pair<vertex_iterator, vertex_iterator>
+    vertices (const MappedGraph& myG) {
+      return std::make_pair(vertex_iterator(0),
+			    vertex_iterator(static_cast<vertex_descriptor>(myG.n)));
+    }
+
+    // ------
+    // source
+    // ------
+
+    friend vertex_descriptor
+    source (edge_descriptor x, const MappedGraph& myG) {
+      assert(x.first < myG.n);
+      return x.first;
+    }
+
+    // ------
+    // target
+    // ------
+
+    friend vertex_descriptor
+    target (edge_descriptor x, const MappedGraph&) {
+      return x.second;
+    }
+
+    // ---------
+    // num_edges
+    // ---------
+
+    friend edges_size_type
+    num_edges (const MappedGraph& myG) {
+      return static_cast<edges_size_type>(myG.m);
+    }
+
+    // ------------
+    // num_vertices
+    // ------------
+
+    friend vertices_size_type
+    num_vertices (const MappedGraph& myG) {
+      return static_cast<vertices_size_type>(myG.n);
+    }
+
+  private:
+    // ----
+    // data
+    // ----
+
+    void*           base;   // the mapping, 0 if nothing is open
+    std::size_t     length;
+    uint64_t        n;
+    uint64_t        m;
+    const uint64_t* offsets;
+    const uint32_t* targets;
+
+    // ---------
+    // unmap_all
+    // ---------
+
+    void unmap_all () {
+      if (base)
+	munmap(base, length);
+      base    = 0;
+      length  = 0;
+      n       = 0;
+      m       = 0;
+      offsets = &m;             // a single 0 offset, the empty graph
+      targets = 0;
+    }
+
+    // -----
+    // valid
+    // -----
+
+    /**
+     * touches every page, only used when verifying
+     * the rows must be strictly ascending, edge() relies on it
+     */
+    bool valid () const {
+      if ((offsets[0] != 0) || (offsets[n] != m))
+	return false;
+      for (uint64_t i = 0; i != n; ++i)
+	if (offsets[i] > offsets[i + 1])
+	  return false;
+      for (uint64_t i = 0; i != m; ++i)
+	if (targets[i] >= n)
+	  return false;
+      for (uint64_t u = 0; u != n; ++u)
+	for (uint64_t i = offsets[u] + 1; i < offsets[u + 1]; ++i)
+	  if (targets[i - 1] >= targets[i])
+	    return false;
+      return true;
+    }
+
+    // no copies, the mapping has a single owner
+    MappedGraph (const MappedGraph&);
+    MappedGraph& operator = (const MappedGraph&);
+
+  public:
+    // ------------
+    // constructors
+    // ------------
+
+    /**
+     * an empty graph, nothing mapped
+     */
+    MappedGraph () : base(0), length(0) {
+      unmap_all();
+    }
+
+    /**
+     * maps path, check is_open() afterwards
+     */
+    explicit MappedGraph (const char* path, bool verify = false) : base(0), length(0) {
+      unmap_all();
+      open(path, verify);
+    }
+
+    ~MappedGraph () {
+      unmap_all();
+    }
+
+    // ----
+    // open
+    // ----
+
+    /**
+     * time: O(1), or O(V + E) when verifying
+     * maps a graph file read-only, replacing whatever was mapped before
+     * the header and the file size are always checked; verify also
+     * checks the checksum (if stored), every offset and target, and that
+     * every row is sorted
+     * @return false, leaving the graph empty, if the file is missing or malformed
+     */
+    bool open (const char* path, bool verify) {
+      unmap_all();
+      const int fd = ::open(path, O_RDONLY);
+      if (fd < 0)
+	return false;
+      struct stat st;
+      if ((fstat(fd, &st) != 0) || (static_cast<std::size_t>(st.st_size) < sizeof(graph_file::header))) {
+	::close(fd);
+	return false;
+      }
+      void* p = mmap(0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+      ::close(fd);
+      if (p == MAP_FAILED)
+	return false;
+      base   = p;
+      length = st.st_size;
+
+      const graph_file::header& h = *static_cast<const graph_file::header*>(base);
+      const uint64_t body = length - sizeof(h);
+      if ((std::memcmp(h.magic, graph_file::magic, sizeof(h.magic)) != 0) ||
+	  (h.version != graph_file::version) ||
+	  (h.vertices >= body / 8) ||
+	  (h.edges > body / 4) ||
+	  (body != 8 * (h.vertices + 1) + 4 * h.edges)) {
+	unmap_all();
+	return false;
+      }
+      n       = h.vertices;
+      m       = h.edges;
+      offsets = reinterpret_cast<const uint64_t*>(static_cast<const char*>(base) + sizeof(h));
+      targets = reinterpret_cast<const uint32_t*>(offsets + n + 1);
+
+      if (verify) {
+	if ((h.flags & graph_file::has_checksum) &&
+	    (graph_file::fnv1a(graph_file::fnv1a_basis, reinterpret_cast<const uint32_t*>(offsets),
+			       body / 4) != h.checksum)) {
+	  unmap_all();
+	  return false;
+	}
+	if (!valid()) {
+	  unmap_all();
+	  return false;
+	}
+      }
+      return true;
+    }
+
+    // -------
+    // is_open
+    // -------
+
+    bool is_open () const {
+      return base != 0;
+    }
+  };
+
+} // cs
+
+#endif // MappedGraph_h
@@ -0,0 +1,557 @@
+// --------------------------------------
+// projects/c++/graph/ReachabilityIndex.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// --------------------------------------
+
+#ifndef ReachabilityIndex_h
+#define ReachabilityIndex_h
+
+/*
+  Precomputed "is there a path from u to v" for a graph that changes
+  rarely. The graph is condensed to the DAG of its strongly connected
+  components, and every component gets a 64 byte label:
+
+    level        the longest path to it from a source; a path only
+                 climbs levels, so level(u) >= level(v) rules it out
+    out, in      one bit per hub (the 64 components of highest
+                 (in degree + 1) * (out degree + 1)): the hubs it reaches
+                 and the hubs that reach it; a shared bit proves a path
+    below, above one bit per bucket of 1/128th of the components, by post
+                 order (Su et al. 2017, BFL): the buckets of all it reaches
+                 and of all that reach it; a path needs below(v) within
+                 below(u) and above(u) within above(v)
+    first, post  its subtree in a depth-first forest (Yildirim, Chaoji,
+    low          Zaki 2010, GRAIL): a descendant in the tree proves a
+                 path, and a path needs low(u) <= low(v), post(v) <= post(u)
+
+  Most queries end in those O(1) tests; the rest search the DAG from u,
+  pruned by the same tests at every vertex.
+*/
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // find, max, min, partial_sort, sort, unique
+#include <cassert>   // assert
+#include <cstddef>   // size_t
+#include <iterator>  // back_inserter
+#include <utility>   // make_pair, pair
+#include <vector>    // vector
+
+#include <stdint.h>  // uint64_t
+
+#include "CsrGraph.h"
+#include "GraphAlgorithms.h"
+#include "GraphStats.h"
+
+// ----------
+// namespaces
+// ----------
+
+namespace cs {
+
+  namespace reach {
+
+    const unsigned int hubs    = 64;  // one bit each of a uint64_t
+    const unsigned int buckets = 128; // of the components, by post order
+    const unsigned int words   = buckets / 64;
+    const std::size_t  listed  = 64;  // visited vertices a search keeps in a list
+
+    // -----
+    // Label
+    // -----
+
+    /**
+     * all that a query looks at for one side, in one cache line
+     */
+    struct Label {
+      uint64_t     out;          // the hubs it reaches
+      uint64_t     in;           // the hubs that reach it
+      uint64_t     below[words]; // the buckets of what it reaches
+      uint64_t     above[words]; // the buckets of what reaches it
+      unsigned int level;
+      unsigned int first;        // its DFS subtree holds the post orders
+      unsigned int post;         //   [first, post]
+      unsigned int low;          // the lowest post order it reaches
+    };
+
+    // --------
+    // condense
+    // --------
+
+    /**
+     * the condensation of myG as a CsrGraph, rows sorted and deduplicated
+     * in parallel
+     * time: O(V + E log(max out degree))
+     * space: O(V + E)
+     */
+    template <typename G>
+    CsrGraph condense (const G& myG, const std::vector<unsigned int>& component, std::size_t count) {
+      typedef typename G::adjacency_iterator adjit;
+      typedef CsrGraph::edges_size_type      edges_size_type;
+      typedef CsrGraph::vertex_descriptor    vertex_descriptor;
+      const std::size_t n = num_vertices(myG);
+      std::vector<edges_size_type> offsets(count + 1, 0);
+      for (std::size_t i = 0; i != n; ++i) {
+	std::pair<adjit, adjit> p = adjacent_vertices(vertex(i, myG), myG);
+	for (; p.first != p.second; ++p.first)
+	  offsets[component[i] + 1] += (component[*p.first] != component[i]);
+      }
+      for (std::size_t c = 0; c != count; ++c)
+	offsets[c + 1] += offsets[c];
+      std::vector<vertex_descriptor> targets(offsets[count]);
+      {
+	std::vector<edges_size_type> cursor(offsets.begin(), offsets.end() - 1);
+	for (std::size_t i = 0; i != n; ++i) {
+	  std::pair<adjit, adjit> p = adjacent_vertices(vertex(i, myG), myG);
+	  for (; p.first != p.second; ++p.first)
+	    if (component[*p.first] != component[i])
+	      targets[cursor[component[i]]++] = component[*p.first];
+	}
+      }
+      std::vector<edges_size_type> ends(count);
+      const long                   k = static_cast<long>(count);
+      #pragma omp parallel for schedule(dynamic, 256)
+      for (long c = 0; c < k; ++c) {
+	std::sort(targets.begin() + offsets[c], targets.begin() + offsets[c + 1]);
+	ends[c] = std::unique(targets.begin() + offsets[c], targets.begin() + offsets[c + 1]) - targets.begin();
+      }
+      edges_size_type m = 0;
+      for (std::size_t c = 0; c != count; ++c) {
+	const edges_size_type b = offsets[c];
+	offsets[c] = m;
+	for (edges_size_type j = b; j != ends[c]; ++j)
+	  targets[m++] = targets[j];
+      }
+      offsets[count] = m;
+      targets.resize(m);
+      return CsrGraph(offsets, targets);
+    }
+
+    // ---------
+    // transpose
+    // ---------
+
+    /**
+     * the reverse of a CsrGraph, by counting sort (rows come out sorted)
+     */
+    inline CsrGraph transpose (const CsrGraph& g) {
+      typedef CsrGraph::adjacency_iterator adjit;
+      typedef CsrGraph::edges_size_type    edges_size_type;
+      typedef CsrGraph::vertex_descriptor  vertex_descriptor;
+      const std::size_t n = num_vertices(g);
+      std::vector<edges_size_type> offsets(n + 1, 0);
+      for (std::size_t u = 0; u != n; ++u) {
+	std::pair<adjit, adjit> p = adjacent_vertices(static_cast<vertex_descriptor>(u), g);
+	for (; p.first != p.second; ++p.first)
+	  ++offsets[*p.first + 1];
+      }
+      for (std::size_t u = 0; u != n; ++u)
+	offsets[u + 1] += offsets[u];
+      std::vector<vertex_descriptor> sources(offsets[n]);
+      std::vector<edges_size_type>   cursor(offsets.begin(), offsets.end() - 1);
+      for (std::size_t u = 0; u != n; ++u) {
+	std::pair<adjit, adjit> p = adjacent_vertices(static_cast<vertex_descriptor>(u), g);
+	for (; p.first != p.second; ++p.first)
+	  sources[cursor[*p.first]++] = static_cast<vertex_descriptor>(u);
+      }
+      return CsrGraph(offsets, sources);
+    }
+
+    // --------------
+    // label_interval
+    // --------------
+
+    /**
+     * one depth-first forest of dag, the roots and the children taken in
+     * ascending order, writing first, post and low
+     * a DAG has no grey child, so every child is finished (and its low
+     * final) when its parent finishes
+     * time: O(V + E)
+     * space: O(V)
+     */
+    inline void label_interval (const CsrGraph& dag, std::vector<Label>& labels) {
+      typedef CsrGraph::adjacency_iterator adjit;
+      typedef CsrGraph::vertex_descriptor  vertex_descriptor;
+      typedef std::pair<vertex_descriptor, std::size_t> frame; // vertex, children done
+      const std::size_t          n       = num_vertices(dag);
+      std::vector<unsigned char> seen(n, 0);
+      std::vector<frame>         stack;
+      unsigned int               counter = 0;
+      for (std::size_t k = 0; k != n; ++k) {
+	const vertex_descriptor r = static_cast<vertex_descriptor>(k);
+	if (seen[r])
+	  continue;
+	seen[r]         = 1;
+	labels[r].first = counter;
+	stack.push_back(frame(r, 0));
+	while (!stack.empty()) {
+	  const vertex_descriptor u = stack.back().first;
+	  std::pair<adjit, adjit> p = adjacent_vertices(u, dag);
+	  const std::size_t       i = stack.back().second;
+	  if (i == static_cast<std::size_t>(p.second - p.first)) {
+	    Label& a = labels[u];
+	    a.post = counter++;
+	    a.low  = a.post;
+	    for (; p.first != p.second; ++p.first)
+	      a.low = std::min(a.low, labels[*p.first].low);
+	    stack.pop_back();
+	    continue;
+	  }
+	  ++stack.back().second;
+	  const vertex_descriptor c = p.first[i];
+	  if (!seen[c]) {
+	    seen[c]         = 1;
+	    labels[c].first = counter;
+	    stack.push_back(frame(c, 0));
+	  }
+	}
+      }
+    }
+
+    // -------
+    // ByScore
+    // -------
+
+    /**
+     * orders vertices by a score, ties by the lower vertex
+     */
+    struct ByScore {
+      const std::vector<uint64_t>& score;
+
+      explicit ByScore (const std::vector<uint64_t>& score) : score(score) {}
+
+      bool operator () (unsigned int a, unsigned int b) const {
+	return (score[a] > score[b]) || ((score[a] == score[b]) && (a < b));
+      }
+    };
+
+    // ----------
+    // LabelAbove
+    // ----------
+
+    /**
+     * the hub and bucket bits of what reaches the i-th component of a
+     * topological order, from those of its parents
+     */
+    struct LabelAbove {
+      const CsrGraph&                  parents;
+      std::vector<Label>&              labels;
+      const std::vector<uint64_t>&     own;
+      const std::vector<unsigned int>& order;
+      std::size_t                      count;
+
+      LabelAbove (const CsrGraph& parents, std::vector<Label>& labels, const std::vector<uint64_t>& own,
+		  const std::vector<unsigned int>& order, std::size_t count) :
+	  parents(parents), labels(labels), own(own), order(order), count(count) {}
+
+      void operator () (long i) const {
+	typedef CsrGraph::adjacency_iterator adjit;
+	const unsigned int c = order[i];
+	Label&             a = labels[c];
+	const uint64_t     z = uint64_t(a.post) * buckets / count;
+	a.in = own[c];
+	for (unsigned int w = 0; w != words; ++w)
+	  a.above[w] = (z / 64 == w) ? uint64_t(1) << (z % 64) : 0;
+	std::pair<adjit, adjit> p = adjacent_vertices(c, parents);
+	for (; p.first != p.second; ++p.first) {
+	  const Label& f = labels[*p.first];
+	  a.in |= f.in;
+	  for (unsigned int w = 0; w != words; ++w)
+	    a.above[w] |= f.above[w];
+	}
+      }
+    };
+
+    // ----------
+    // LabelBelow
+    // ----------
+
+    /**
+     * the hub and bucket bits of what the i-th component of a topological
+     * order reaches, from those of its children
+     */
+    struct LabelBelow {
+      const CsrGraph&                  dag;
+      std::vector<Label>&              labels;
+      const std::vector<uint64_t>&     own;
+      const std::vector<unsigned int>& order;
+      std::size_t                      count;
+
+      LabelBelow (const CsrGraph& dag, std::vector<Label>& labels, const std::vector<uint64_t>& own,
+		  const std::vector<unsigned int>& order, std::size_t count) :
+	  dag(dag), labels(labels), own(own), order(order), count(count) {}
+
+      void operator () (long i) const {
+	typedef CsrGraph::adjacency_iterator adjit;
+	const unsigned int c = order[i];
+	Label&             a = labels[c];
+	const uint64_t     z = uint64_t(a.post) * buckets / count;
+	a.out = own[c];
+	for (unsigned int w = 0; w != words; ++w)
+	  a.below[w] = (z / 64 == w) ? uint64_t(1) << (z % 64) : 0;
+	std::pair<adjit, adjit> p = adjacent_vertices(c, dag);
+	for (; p.first != p.second; ++p.first) {
+	  const Label& f = labels[*p.first];
+	  a.out |= f.out;
+	  for (unsigned int w = 0; w != words; ++w)
+	    a.below[w] |= f.below[w];
+	}
+      }
+    };
+
+  } // reach
+
+  // -----------------
+  // ReachabilityIndex
+  // -----------------
+
+  /**
+   * answers reachable(u, v) for a snapshot of a directed graph
+   * (see the comment at the top of the file); later changes to the graph
+   * are not reflected
+   * queries are const and may run concurrently
+   */
+  class ReachabilityIndex {
+  public:
+    // --------
+    // typedefs
+    // --------
+
+    typedef unsigned int vertex_descriptor;
+    typedef std::size_t  vertices_size_type;
+
+  private:
+    // ----
+    // data
+    // ----
+
+    std::vector<unsigned int> component; // per vertex, its vertex of dag
+    std::vector<reach::Label> labels;    // per vertex of dag
+    CsrGraph                  dag;       // for the queries the labels leave open
+
+    /**
+     * O(1): 1 if there is a path from a to b, 0 if there is none,
+     * -1 if the labels cannot tell
+     */
+    static int decide (const reach::Label& a, const reach::Label& b) {
+      if (a.level >= b.level)
+	return 0;
+      if (a.out & b.in)
+	return 1;
+      for (unsigned int w = 0; w != reach::words; ++w)
+	if ((b.below[w] & ~a.below[w]) || (a.above[w] & ~b.above[w]))
+	  return 0;
+      if ((b.low < a.low) || (a.post < b.post))
+	return 0;
+      if (a.first <= b.post)
+	return 1;
+      return -1;
+    }
+
+    /**
+     * depth-first from x toward y, skipping every vertex the labels rule
+     * out and stopping at the first the labels (or the search) connect
+     * the pruned searches are mostly a handful of vertices, so the visited
+     * ones are kept in a list, and in a bitmap only once there are more
+     * than reach::listed (clearing O(V) bits would cost more than the search)
+     * time: O(V + E) in the worst case
+     * space: O(V) bits in the worst case
+     */
+    bool search (vertex_descriptor x, vertex_descriptor y) const {
+      typedef CsrGraph::adjacency_iterator adjit;
+      const reach::Label&            b = labels[y];
+      std::vector<vertex_descriptor> listed(1, x);
+      std::vector<bool>              seen;
+      std::vector<vertex_descriptor> stack(1, x);
+      while (!stack.empty()) {
+	std::pair<adjit, adjit> p = adjacent_vertices(stack.back(), dag);
+	stack.pop_back();
+	for (; p.first != p.second; ++p.first) {
+	  const vertex_descriptor w = *p.first;
+	  if (!seen.empty()) {
+	    if (seen[w])
+	      continue;
+	    seen[w] = true;
+	  }
+	  else if (std::find(listed.begin(), listed.end(), w) != listed.end())
+	    continue;
+	  else if (listed.size() != reach::listed)
+	    listed.push_back(w);
+	  else {
+	    seen.resize(labels.size(), false);
+	    for (std::size_t i = 0; i != listed.size(); ++i)
+	      seen[listed[i]] = true;
+	    seen[w] = true;
+	  }
+	  if (w == y)
+	    return true;
+	  const int d = decide(labels[w], b);
+	  if (d == 1)
+	    return true;
+	  if (d == -1)
+	    stack.push_back(w);
+	}
+      }
+      return false;
+    }
+
+  public:
+    // ---------
+    // reachable
+    // ---------
+
+    /**
+     * time: O(1) for most pairs, O(V + E) in the worst case
+     * space: O(1), O(V) bits when the labels cannot tell
+     * @return true if there is a path from u to v (u reaches itself)
+     */
+    friend bool
+    reachable (vertex_descriptor u, vertex_descriptor v, const ReachabilityIndex& r) {
+      assert(u < r.component.size());
+      assert(v < r.component.size());
+      const vertex_descriptor x = r.component[u];
+      const vertex_descriptor y = r.component[v];
+      if (x == y)
+	return true;
+      const int d = decide(r.labels[x], r.labels[y]);
+      return (d == -1) ? r.search(x, y) : (d == 1);
+    }
+
+    // --------------
+    // num_components
+    // --------------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     * @return the number of strongly connected components, the vertices
+     * of the condensation
+     */
+    friend vertices_size_type
+    num_components (const ReachabilityIndex& r) {
+      return r.labels.size();
+    }
+
+    // ------------
+    // num_vertices
+    // ------------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     */
+    friend vertices_size_type
+    num_vertices (const ReachabilityIndex& r) {
+      return r.component.size();
+    }
+
+    // ----------
+    // memory_use
+    // ----------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     * @return the bytes of the component map, the labels and the
+     * condensation
+     */
+    friend std::size_t
+    memory_use (const ReachabilityIndex& r) {
+      return r.component.capacity() * sizeof(unsigned int) +
+	r.labels.capacity() * sizeof(reach::Label) +
+	(num_vertices(r.dag) + 1) * sizeof(CsrGraph::edges_size_type) +
+	num_edges(r.dag) * sizeof(CsrGraph::vertex_descriptor);
+    }
+
+    // ------------
+    // constructors
+    // ------------
+
+    /**
+     * an index of the empty graph
+     */
+    ReachabilityIndex () {}
+
+    /**
+     * time: O(V + E log(max out degree))
+     * space: O(V + E)
+     * components by parallel_strongly_connected_components, levels by
+     * parallel_topological_sort, and the hub and bucket bits one level at
+     * a time with the vertices of a level in parallel; levels narrower than
+     * parallel_level run without forking threads
+     * runs serially unless compiled with OpenMP
+     */
+    template <typename G>
+    explicit ReachabilityIndex (const G& myG) {
+      CS_GRAPH_TIMER("reachability_index");
+      std::size_t count;
+      {
+	CS_GRAPH_TIMER("reachability_index.condense");
+	std::vector<std::size_t> c;
+	count = parallel_strongly_connected_components(myG, c);
+	component.assign(c.begin(), c.end());
+	dag = reach::condense(myG, component, count);
+      }
+      const long     k       = static_cast<long>(count);
+      const CsrGraph parents = reach::transpose(dag);
+      labels.resize(count);
+
+      // the levels, and the vertices grouped by level
+      std::vector<std::size_t>       level;
+      std::vector<vertex_descriptor> order;
+      parallel_topological_sort(dag, std::back_inserter(order), &level);
+      assert(order.size() == count);
+      std::size_t depth = 0;
+      for (long c = 0; c < k; ++c) {
+	labels[c].level = static_cast<unsigned int>(level[c]);
+	depth           = std::max(depth, level[c] + 1);
+      }
+      std::vector<std::size_t> offsets(depth + 1, 0);
+      for (long c = 0; c < k; ++c)
+	++offsets[level[c] + 1];
+      for (std::size_t l = 0; l != depth; ++l)
+	offsets[l + 1] += offsets[l];
+      {
+	std::vector<std::size_t> cursor(offsets.begin(), offsets.end() - 1);
+	for (long c = 0; c < k; ++c)
+	  order[cursor[level[c]]++] = static_cast<vertex_descriptor>(c);
+      }
+
+      {
+	CS_GRAPH_TIMER("reachability_index.intervals");
+	reach::label_interval(dag, labels);
+      }
+
+      // the bit of each component among the hubs and among the buckets,
+      // then the bits up and down the levels
+      {
+	CS_GRAPH_TIMER("reachability_index.bits");
+	std::vector<uint64_t>     score(count);
+	std::vector<unsigned int> hub(count);
+	std::vector<uint64_t>     own(count, 0);
+	for (long c = 0; c < k; ++c) {
+	  score[c] = (uint64_t(out_degree(c, dag)) + 1) * (uint64_t(out_degree(c, parents)) + 1);
+	  hub[c]   = static_cast<unsigned int>(c);
+	}
+	const std::size_t h = std::min<std::size_t>(reach::hubs, count);
+	std::partial_sort(hub.begin(), hub.begin() + h, hub.end(), reach::ByScore(score));
+	for (std::size_t i = 0; i != h; ++i)
+	  own[hub[i]] = uint64_t(1) << i;
+	const reach::LabelAbove above(parents, labels, own, order, count);
+	const reach::LabelBelow below(dag, labels, own, order, count);
+	for (std::size_t l = 0; l != depth; ++l)
+	  for_each_in_level(static_cast<long>(offsets[l]), static_cast<long>(offsets[l + 1]), above);
+	for (std::size_t l = depth; l-- != 0;)
+	  for_each_in_level(static_cast<long>(offsets[l]), static_cast<long>(offsets[l + 1]), below);
+      }
+    }
+
+    // Default copy, destructor, and copy assignment
+  };
+
+} // cs
+
+#endif // ReachabilityIndex_h
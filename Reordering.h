@@ -0,0 +1,480 @@
+// -------------------------------
+// projects/c++/graph/Reordering.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// -------------------------------
+
+#ifndef Reordering_h
+#define Reordering_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // max, reverse, sort
+#include <cassert>   // assert
+#include <cstddef>   // size_t
+#include <iterator>  // iterator, output_iterator_tag
+#include <utility>   // make_pair, pair
+#include <vector>    // vector
+
+// ----------
+// namespaces
+// ----------
+
+namespace cs {
+
+  // ----------
+  // Relabeling
+  // ----------
+
+  /**
+   * a permutation of the vertices [0, n) together with its inverse
+   * old_vertex(i, r) is the vertex of the original graph that becomes
+   * vertex i, new_vertex(v, r) is what original vertex v becomes
+   */
+  class Relabeling {
+  private:
+    std::vector<std::size_t> order;    // new -> old
+    std::vector<std::size_t> position; // old -> new
+
+  public:
+    /**
+     * the empty permutation
+     */
+    Relabeling () {}
+
+    /**
+     * @param order the original vertices in their new order
+     * Precondition: order is a permutation of [0, order.size())
+     */
+    explicit Relabeling (const std::vector<std::size_t>& order) :
+      order(order), position(order.size(), order.size()) {
+      for (std::size_t i = 0; i != order.size(); ++i) {
+	assert(order[i] < order.size());
+	assert(position[order[i]] == order.size());
+	position[order[i]] = i;
+      }
+    }
+
+    // Default copy, destructor, and copy assignment
+
+    /**
+     * time: O(1)
+     */
+    friend std::size_t num_vertices (const Relabeling& r) {
+      return r.order.size();
+    }
+
+    /**
+     * time: O(1)
+     * @return the vertex that original vertex v becomes
+     */
+    friend std::size_t new_vertex (std::size_t v, const Relabeling& r) {
+      assert(v < r.position.size());
+      return r.position[v];
+    }
+
+    /**
+     * time: O(1)
+     * @return the original vertex that became vertex v
+     */
+    friend std::size_t old_vertex (std::size_t v, const Relabeling& r) {
+      assert(v < r.order.size());
+      return r.order[v];
+    }
+  };
+
+  namespace reorder {
+
+    // ----------
+    // undirected
+    // ----------
+
+    /**
+     * the graph with every edge in both directions, as compressed rows:
+     * the neighbours of v are targets[offsets[v]] .. targets[offsets[v + 1]]
+     * self loops are dropped, a pair of opposite edges appears twice
+     * time: O(V + E)
+     * space: O(V + E)
+     */
+    template <typename G>
+    void undirected (const G& myG, std::vector<std::size_t>& offsets, std::vector<std::size_t>& targets) {
+      typedef typename G::adjacency_iterator adjit;
+      const std::size_t n = num_vertices(myG);
+      offsets.assign(n + 1, 0);
+      for (std::size_t u = 0; u != n; ++u) {
+	std::pair<adjit, adjit> p = adjacent_vertices(vertex(u, myG), myG);
+	for (; p.first != p.second; ++p.first)
+	  if (static_cast<std::size_t>(*p.first) != u) {
+	    ++offsets[u + 1];
+	    ++offsets[*p.first + 1];
+	  }
+      }
+      for (std::size_t u = 0; u != n; ++u)
+	offsets[u + 1] += offsets[u];
+      targets.resize(offsets[n]);
+      std::vector<std::size_t> cursor(offsets.begin(), offsets.end() - 1);
+      for (std::size_t u = 0; u != n; ++u) {
+	std::pair<adjit, adjit> p = adjacent_vertices(vertex(u, myG), myG);
+	for (; p.first != p.second; ++p.first)
+	  if (static_cast<std::size_t>(*p.first) != u) {
+	    targets[cursor[u]++]        = *p.first;
+	    targets[cursor[*p.first]++] = u;
+	  }
+      }
+    }
+
+    // ---------
+    // by_degree
+    // ---------
+
+    /**
+     * a stable counting sort of the vertices by degree
+     * the degree of v is offsets[v + 1] - offsets[v]
+     * time: O(V + max degree)
+     * space: O(V + max degree)
+     * @param descending the largest degrees first if true, the smallest otherwise
+     */
+    inline std::vector<std::size_t> by_degree (const std::vector<std::size_t>& offsets, bool descending) {
+      const std::size_t n = offsets.size() - 1;
+      std::size_t top = 0;
+      for (std::size_t v = 0; v != n; ++v)
+	top = std::max(top, offsets[v + 1] - offsets[v]);
+      std::vector<std::size_t> start(top + 2, 0);
+      for (std::size_t v = 0; v != n; ++v) {
+	const std::size_t d = offsets[v + 1] - offsets[v];
+	++start[(descending ? top - d : d) + 1];
+      }
+      for (std::size_t d = 0; d <= top; ++d)
+	start[d + 1] += start[d];
+      std::vector<std::size_t> order(n);
+      for (std::size_t v = 0; v != n; ++v) {
+	const std::size_t d = offsets[v + 1] - offsets[v];
+	order[start[descending ? top - d : d]++] = v;
+      }
+      return order;
+    }
+
+    // --------
+    // ByDegree
+    // --------
+
+    /**
+     * orders vertices by degree, ties by id
+     */
+    struct ByDegree {
+      const std::vector<std::size_t>* offsets;
+
+      explicit ByDegree (const std::vector<std::size_t>& offsets) : offsets(&offsets) {}
+
+      bool operator () (std::size_t u, std::size_t v) const {
+	const std::size_t du = (*offsets)[u + 1] - (*offsets)[u];
+	const std::size_t dv = (*offsets)[v + 1] - (*offsets)[v];
+	return (du < dv) || ((du == dv) && (u < v));
+      }
+    };
+
+    // -----------
+    // level_order
+    // -----------
+
+    /**
+     * the breadth-first (Cuthill-McKee) order of the component of start,
+     * appended to order; the unvisited neighbours of each vertex are
+     * queued by ascending degree
+     * every vertex appended is marked with stamp
+     * @param last set to the index in order at which the last level begins
+     * @return the number of levels
+     */
+    inline std::size_t level_order (const std::vector<std::size_t>& offsets,
+				    const std::vector<std::size_t>& targets,
+				    std::size_t start, std::size_t stamp, std::vector<std::size_t>& mark,
+				    std::vector<std::size_t>& order, std::size_t& last) {
+      std::size_t head  = order.size();
+      std::size_t depth = 0;
+      order.push_back(start);
+      mark[start] = stamp;
+      while (head != order.size()) {
+	const std::size_t end = order.size();
+	last = head;
+	++depth;
+	for (; head != end; ++head) {
+	  const std::size_t u     = order[head];
+	  const std::size_t first = order.size();
+	  for (std::size_t i = offsets[u]; i != offsets[u + 1]; ++i)
+	    if (mark[targets[i]] != stamp) {
+	      mark[targets[i]] = stamp;
+	      order.push_back(targets[i]);
+	    }
+	  std::sort(order.begin() + first, order.end(), ByDegree(offsets));
+	}
+      }
+      return depth;
+    }
+  }
+
+  // ---------------
+  // degree_ordering
+  // ---------------
+
+  /**
+   * the vertices by descending total (in plus out) degree, ties by id
+   * packs the hubs, which most edges lead to, into the first few cache lines
+   * time: O(V + E)
+   * space: O(V + max degree)
+   */
+  template <typename G>
+  Relabeling degree_ordering (const G& myG) {
+    typedef typename G::adjacency_iterator adjit;
+    const std::size_t n = num_vertices(myG);
+    std::vector<std::size_t> offsets(n + 1, 0);
+    for (std::size_t u = 0; u != n; ++u) {
+      std::pair<adjit, adjit> p = adjacent_vertices(vertex(u, myG), myG);
+      for (; p.first != p.second; ++p.first) {
+	++offsets[u + 1];
+	++offsets[*p.first + 1];
+      }
+    }
+    for (std::size_t u = 0; u != n; ++u)
+      offsets[u + 1] += offsets[u];
+    return Relabeling(reorder::by_degree(offsets, true));
+  }
+
+  // ------------
+  // bfs_ordering
+  // ------------
+
+  /**
+   * the order in which a breadth-first traversal along the edges
+   * reaches the vertices, restarting from the lowest unreached vertex
+   * time: O(V + E)
+   * space: O(V)
+   */
+  template <typename G>
+  Relabeling bfs_ordering (const G& myG) {
+    typedef typename G::adjacency_iterator adjit;
+    const std::size_t        n = num_vertices(myG);
+    std::vector<bool>        reached(n, false);
+    std::vector<std::size_t> order;
+    order.reserve(n);
+    for (std::size_t s = 0; s != n; ++s) {
+      if (reached[s])
+	continue;
+      reached[s] = true;
+      order.push_back(s);
+      for (std::size_t head = order.size() - 1; head != order.size(); ++head) {
+	std::pair<adjit, adjit> p = adjacent_vertices(vertex(order[head], myG), myG);
+	for (; p.first != p.second; ++p.first)
+	  if (!reached[*p.first]) {
+	    reached[*p.first] = true;
+	    order.push_back(*p.first);
+	  }
+      }
+    }
+    return Relabeling(order);
+  }
+
+  // ------------
+  // dfs_ordering
+  // ------------
+
+  /**
+   * the preorder of a depth-first traversal along the edges,
+   * restarting from the lowest unreached vertex, so the vertices of
+   * each path a topological_sort walks are numbered consecutively
+   * an explicit stack instead of recursion
+   * time: O(V + E)
+   * space: O(V)
+   */
+  template <typename G>
+  Relabeling dfs_ordering (const G& myG) {
+    typedef typename G::adjacency_iterator adjit;
+    const std::size_t                     n = num_vertices(myG);
+    std::vector<bool>                     reached(n, false);
+    std::vector<std::size_t>              order;
+    std::vector< std::pair<adjit, adjit> > stack;
+    order.reserve(n);
+    for (std::size_t s = 0; s != n; ++s) {
+      if (reached[s])
+	continue;
+      reached[s] = true;
+      order.push_back(s);
+      stack.push_back(adjacent_vertices(vertex(s, myG), myG));
+      while (!stack.empty()) {
+	std::pair<adjit, adjit>& children = stack.back();
+	if (children.first == children.second) {
+	  stack.pop_back();
+	  continue;
+	}
+	const std::size_t v = *children.first;
+	++children.first;
+	if (!reached[v]) {
+	  reached[v] = true;
+	  order.push_back(v);
+	  stack.push_back(adjacent_vertices(vertex(v, myG), myG));
+	}
+      }
+    }
+    return Relabeling(order);
+  }
+
+  // ------------
+  // rcm_ordering
+  // ------------
+
+  /**
+   * reverse Cuthill-McKee on the undirected graph underneath myG
+   * each component starts from a pseudo-peripheral vertex (George and
+   * Liu: repeatedly restart from the smallest degree vertex of the last
+   * breadth-first level while that makes the level structure deeper),
+   * neighbours are numbered by ascending degree, and the whole order
+   * is reversed; this keeps every edge close to the diagonal of the
+   * adjacency matrix (small bandwidth), so a vertex and its neighbours
+   * share cache lines
+   * time: O(V + E log(d)) per restart, restarts are few in practice
+   * space: O(V + E)
+   */
+  template <typename G>
+  Relabeling rcm_ordering (const G& myG) {
+    std::vector<std::size_t> offsets;
+    std::vector<std::size_t> targets;
+    reorder::undirected(myG, offsets, targets);
+    const std::size_t              n      = num_vertices(myG);
+    const std::vector<std::size_t> lowest = reorder::by_degree(offsets, false);
+    const reorder::ByDegree        less(offsets);
+    std::vector<std::size_t>       mark(n, 0);
+    std::vector<std::size_t>       order;
+    std::vector<std::size_t>       levels;
+    std::vector<std::size_t>       trial;
+    std::size_t                    stamp = 0;
+    order.reserve(n);
+    for (std::size_t i = 0; i != n; ++i) {
+      std::size_t start = lowest[i];
+      if (mark[start] != 0)
+	continue;
+      std::size_t last;
+      levels.clear();
+      std::size_t depth = reorder::level_order(offsets, targets, start, ++stamp, mark, levels, last);
+      for (;;) {
+	std::size_t candidate = levels[last];
+	for (std::size_t j = last + 1; j != levels.size(); ++j)
+	  if (less(levels[j], candidate))
+	    candidate = levels[j];
+	std::size_t l;
+	trial.clear();
+	const std::size_t d = reorder::level_order(offsets, targets, candidate, ++stamp, mark, trial, l);
+	if (d <= depth)
+	  break;
+	start = candidate;
+	depth = d;
+	last  = l;
+	levels.swap(trial);
+      }
+      std::size_t l;
+      reorder::level_order(offsets, targets, start, ++stamp, mark, order, l);
+    }
+    std::reverse(order.begin(), order.end());
+    return Relabeling(order);
+  }
+
+  // -------
+  // relabel
+  // -------
+
+  /**
+   * copies myG into h with every vertex v renamed new_vertex(v, r)
+   * the edges are sorted by their new source before they are added,
+   * so a node-based graph also allocates its rows in the new order
+   * time: O(V + E log E) plus add_edges
+   * space: O(E)
+   * Precondition: h has no vertices; r permutes the vertices of myG
+   */
+  template <typename G, typename H>
+  void relabel (const G& myG, const Relabeling& r, H& h) {
+    typedef typename G::adjacency_iterator adjit;
+    typedef typename H::vertex_descriptor  vertex_descriptor;
+    typedef std::pair<vertex_descriptor, vertex_descriptor> edge_type;
+    const std::size_t n = num_vertices(myG);
+    assert(num_vertices(h) == 0);
+    assert(num_vertices(r) == n);
+    for (std::size_t i = 0; i != n; ++i)
+      add_vertex(h);
+    std::vector<edge_type> es;
+    for (std::size_t u = 0; u != n; ++u) {
+      const vertex_descriptor nu = vertex(new_vertex(u, r), h);
+      std::pair<adjit, adjit> p = adjacent_vertices(vertex(u, myG), myG);
+      for (; p.first != p.second; ++p.first)
+	es.push_back(std::make_pair(nu, vertex(new_vertex(*p.first, r), h)));
+    }
+    std::sort(es.begin(), es.end());
+    add_edges(es.begin(), es.end(), h);
+  }
+
+  // -----------------
+  // original_vertices
+  // -----------------
+
+  /**
+   * an output iterator that writes old_vertex(v, r) for every v written
+   * through it, so an algorithm run on a relabeled graph reports the
+   * original vertices, e.g.
+   * topological_sort(h, original_vertices(r, std::back_inserter(x)))
+   */
+  template <typename OI>
+  class OriginalVertices :
+    public std::iterator<std::output_iterator_tag, void, void, void, void> {
+  private:
+    const Relabeling* r;
+    OI                x;
+
+  public:
+    OriginalVertices (const Relabeling& r, OI x) : r(&r), x(x) {}
+
+    OriginalVertices& operator * () {
+      return *this;
+    }
+
+    OriginalVertices& operator = (std::size_t v) {
+      *x = old_vertex(v, *r);
+      ++x;
+      return *this;
+    }
+
+    OriginalVertices& operator ++ () {
+      return *this;
+    }
+
+    OriginalVertices operator ++ (int) {
+      return *this;
+    }
+  };
+
+  template <typename OI>
+  OriginalVertices<OI> original_vertices (const Relabeling& r, OI x) {
+    return OriginalVertices<OI>(r, x);
+  }
+
+  // --------------
+  // original_order
+  // --------------
+
+  /**
+   * turns a per-vertex result of a relabeled graph (e.g. the components
+   * of strongly_connected_components) into the per-vertex result of the
+   * original graph: afterwards values[v] is what was values[new_vertex(v, r)]
+   * time: O(V)
+   * space: O(V)
+   */
+  template <typename T>
+  void original_order (const Relabeling& r, std::vector<T>& values) {
+    assert(values.size() == num_vertices(r));
+    std::vector<T> x(values.size());
+    for (std::size_t i = 0; i != values.size(); ++i)
+      x[old_vertex(i, r)] = values[i];
+    values.swap(x);
+  }
+
+} // cs
+
+#endif // Reordering_h
@@ -0,0 +1,528 @@
+// ----------------------------------
+// projects/c++/graph/ShortestPaths.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// ----------------------------------
+
+#ifndef ShortestPaths_h
+#define ShortestPaths_h
+
+/*
+  Single-source shortest paths over the arcs of a weighted graph
+  (WeightedGraph.h, or anything else with out_arcs): every function
+  takes a graph, a source and two vectors, fills distance and
+  predecessor, and returns the number of vertices reached.
+
+  distance[v]    the length of a shortest path from the source,
+                 std::numeric_limits<D>::max() if v is unreachable
+  predecessor[v] the vertex before v on such a path, v itself for the
+                 source and the unreachable vertices (as in boost)
+
+  D, the element type of distance, is chosen by the caller; it must hold
+  the longest path (e.g. unsigned long over unsigned int weights). Every
+  weight must be non-negative.
+
+  dijkstra_shortest_paths        a 4-ary heap with decrease-key, any D
+  radix_dijkstra_shortest_paths  a monotone radix heap, D an unsigned
+                                 integer type
+  delta_stepping_shortest_paths  Meyer and Sanders' delta-stepping: the
+                                 arcs out of one bucket of width delta
+                                 are relaxed in parallel under OpenMP
+*/
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // max
+#include <cassert>   // assert
+#include <cstddef>   // size_t
+#include <limits>    // numeric_limits
+#include <utility>   // pair
+#include <vector>    // vector
+
+#ifdef _OPENMP
+#include <omp.h> // omp_get_max_threads, omp_get_thread_num
+#endif
+
+#include "GraphStats.h"
+
+// ----------
+// namespaces
+// ----------
+
+namespace cs {
+
+  namespace sssp {
+
+    // --------
+    // DaryHeap
+    // --------
+
+    /**
+     * a min-heap of vertices keyed by distance, Arity children per node
+     * the key sits next to the vertex in the heap, and position[v] is
+     * where v is, so lowering a key is a sift up without a search
+     * a wider node makes the heap shallower; pop pays Arity compares per
+     * level, which share a cache line
+     */
+    template <typename D, typename V, unsigned int Arity>
+    class DaryHeap {
+    private:
+      typedef std::pair<D, V> entry;
+
+      std::vector<entry>        heap;
+      std::vector<unsigned int> position;
+
+      static unsigned int none () {
+	return static_cast<unsigned int>(-1);
+      }
+
+      void place (std::size_t i, const entry& e) {
+	heap[i]             = e;
+	position[e.second]  = static_cast<unsigned int>(i);
+      }
+
+      void sift_up (std::size_t i, const entry& e) {
+	while (i != 0) {
+	  const std::size_t parent = (i - 1) / Arity;
+	  if (!(e.first < heap[parent].first))
+	    break;
+	  place(i, heap[parent]);
+	  i = parent;
+	}
+	place(i, e);
+      }
+
+      void sift_down (std::size_t i, const entry& e) {
+	const std::size_t n = heap.size();
+	for (;;) {
+	  const std::size_t first = i * Arity + 1;
+	  if (first >= n)
+	    break;
+	  const std::size_t last  = (first + Arity < n) ? first + Arity : n;
+	  std::size_t       child = first;
+	  for (std::size_t c = first + 1; c < last; ++c)
+	    if (heap[c].first < heap[child].first)
+	      child = c;
+	  if (!(heap[child].first < e.first))
+	    break;
+	  place(i, heap[child]);
+	  i = child;
+	}
+	place(i, e);
+      }
+
+    public:
+      explicit DaryHeap (std::size_t n) : position(n, none()) {}
+
+      bool empty () const {
+	return heap.empty();
+      }
+
+      /**
+       * inserts v, or lowers its key if it is already in the heap
+       */
+      void push (V v, D key) {
+	if (position[v] == none()) {
+	  heap.push_back(entry(key, v));
+	  sift_up(heap.size() - 1, entry(key, v));
+	}
+	else
+	  sift_up(position[v], entry(key, v));
+      }
+
+      V pop () {
+	assert(!heap.empty());
+	const V v = heap[0].second;
+	position[v] = none();
+	const entry e = heap.back();
+	heap.pop_back();
+	if (!heap.empty())
+	  sift_down(0, e);
+	return v;
+      }
+    };
+
+    // ---------
+    // RadixHeap
+    // ---------
+
+    /**
+     * a monotone priority queue for unsigned integer keys (Ahuja et al.):
+     * no key pushed is ever below the last key popped, which Dijkstra
+     * guarantees
+     * bucket b > 0 holds the keys whose highest bit differing from the
+     * last key popped is bit b - 1, bucket 0 the keys equal to it; a pop
+     * from an empty bucket 0 empties the first non-empty bucket into the
+     * lower ones, and each entry moves down at most once per bit, so
+     * push and pop are O(1) amortized plus O(log C) per pop
+     * there is no decrease-key: the caller pushes again and skips the
+     * stale entries on the way out
+     */
+    template <typename D, typename V>
+    class RadixHeap {
+    private:
+      typedef std::pair<D, V> entry;
+
+      std::vector< std::vector<entry> > buckets;
+      D                                 last;
+      std::size_t                       count;
+
+      static std::size_t bucket (D key, D last) {
+	D           x = key ^ last;
+	std::size_t b = 0;
+	while (x != 0) {
+	  x >>= 1;
+	  ++b;
+	}
+	return b;
+      }
+
+    public:
+      RadixHeap () : buckets(std::numeric_limits<D>::digits + 1), last(0), count(0) {
+	assert(std::numeric_limits<D>::is_integer && !std::numeric_limits<D>::is_signed);
+      }
+
+      bool empty () const {
+	return count == 0;
+      }
+
+      void push (V v, D key) {
+	assert(!(key < last));
+	buckets[bucket(key, last)].push_back(entry(key, v));
+	++count;
+      }
+
+      /**
+       * @return the smallest key and its vertex
+       */
+      entry pop () {
+	assert(count != 0);
+	if (buckets[0].empty()) {
+	  std::size_t i = 1;
+	  while (buckets[i].empty())
+	    ++i;
+	  std::vector<entry>& from = buckets[i];
+	  D                   m    = from[0].first;
+	  for (std::size_t j = 1; j != from.size(); ++j)
+	    if (from[j].first < m)
+	      m = from[j].first;
+	  last = m;
+	  for (std::size_t j = 0; j != from.size(); ++j)
+	    buckets[bucket(from[j].first, last)].push_back(from[j]);
+	  from.clear();
+	}
+	const entry e = buckets[0].back();
+	buckets[0].pop_back();
+	--count;
+	return e;
+      }
+    };
+
+    // -----
+    // start
+    // -----
+
+    /**
+     * every vertex unreached and its own predecessor, but the source
+     */
+    template <typename G, typename D>
+    void start (const G& myG, typename G::vertex_descriptor s, std::vector<D>& distance,
+		std::vector<typename G::vertex_descriptor>& predecessor) {
+      const std::size_t n = num_vertices(myG);
+      assert(s < n);
+      distance.assign(n, std::numeric_limits<D>::max());
+      predecessor.resize(n);
+      for (std::size_t v = 0; v != n; ++v)
+	predecessor[v] = static_cast<typename G::vertex_descriptor>(v);
+      distance[s] = D(0);
+    }
+
+    // -------
+    // Request
+    // -------
+
+    /**
+     * a relaxation found by one thread of delta-stepping, applied later
+     * by one thread
+     */
+    template <typename D, typename V>
+    struct Request {
+      V to;
+      V from;
+      D distance;
+    };
+
+    // -----
+    // relax
+    // -----
+
+    /**
+     * the relaxations of the light (weight <= delta) or the heavy arcs
+     * out of the size vertices at first, found in parallel, each
+     * thread collecting the ones that beat the current distance
+     * nothing is written to distance here, so the threads only read it
+     * @return the number of arcs examined
+     */
+    template <typename G, typename D>
+    std::size_t relax (const G& myG, const typename G::vertex_descriptor* first, std::size_t size,
+		       D delta, bool light, const std::vector<D>& distance,
+		       std::vector< std::vector< Request<D, typename G::vertex_descriptor> > >& requests) {
+      typedef typename G::vertex_descriptor vertex_descriptor;
+      typedef typename G::arc_iterator      arcit;
+      const long  n        = static_cast<long>(size);
+      std::size_t examined = 0;
+      #pragma omp parallel reduction(+:examined)
+      {
+#ifdef _OPENMP
+	std::vector< Request<D, vertex_descriptor> >& mine = requests[omp_get_thread_num()];
+#else
+	std::vector< Request<D, vertex_descriptor> >& mine = requests[0];
+#endif
+	mine.clear();
+	#pragma omp for schedule(dynamic, 64)
+	for (long k = 0; k < n; ++k) {
+	  const vertex_descriptor u  = first[k];
+	  const D                 du = distance[u];
+	  std::pair<arcit, arcit> p  = out_arcs(u, myG);
+	  for (; p.first != p.second; ++p.first) {
+	    const D w = D(p.first->weight);
+	    if (!(delta < w) != light)
+	      continue;
+	    ++examined;
+	    const D d = du + w;
+	    if (d < distance[p.first->target]) {
+	      const Request<D, vertex_descriptor> r = {p.first->target, u, d};
+	      mine.push_back(r);
+	    }
+	  }
+	}
+      }
+      return examined;
+    }
+
+    // -----
+    // apply
+    // -----
+
+    /**
+     * the requests that still improve a distance, in thread order,
+     * each moving its vertex into the bucket of its new distance
+     */
+    template <typename D, typename V>
+    void apply (const std::vector< std::vector< Request<D, V> > >& requests, D delta,
+		std::vector<D>& distance, std::vector<V>& predecessor,
+		std::vector< std::vector<V> >& buckets) {
+      for (std::size_t t = 0; t != requests.size(); ++t)
+	for (std::size_t j = 0; j != requests[t].size(); ++j) {
+	  const Request<D, V>& r = requests[t][j];
+	  if (!(r.distance < distance[r.to]))
+	    continue;
+	  distance[r.to]    = r.distance;
+	  predecessor[r.to] = r.from;
+	  const std::size_t b = static_cast<std::size_t>(r.distance / delta);
+	  if (b >= buckets.size())
+	    buckets.resize(b + 1);
+	  buckets[b].push_back(r.to);
+	}
+    }
+
+  } // sssp
+
+  // -----------------------
+  // dijkstra_shortest_paths
+  // -----------------------
+
+  /**
+   * Dijkstra with a 4-ary heap and decrease-key
+   * the heap never holds more than one entry per vertex
+   * time: O(E log(V))
+   * space: O(V)
+   * @return the number of vertices reached from s
+   */
+  template <typename G, typename D>
+  std::size_t dijkstra_shortest_paths (const G& myG, typename G::vertex_descriptor s,
+				       std::vector<D>& distance,
+				       std::vector<typename G::vertex_descriptor>& predecessor) {
+    typedef typename G::vertex_descriptor vertex_descriptor;
+    typedef typename G::arc_iterator      arcit;
+    CS_GRAPH_TIMER("dijkstra_shortest_paths");
+    stats::Tally tally;
+    sssp::start(myG, s, distance, predecessor);
+    sssp::DaryHeap<D, vertex_descriptor, 4> heap(distance.size());
+    heap.push(s, D(0));
+    std::size_t reached = 0;
+    while (!heap.empty()) {
+      const vertex_descriptor u  = heap.pop();
+      const D                 du = distance[u];
+      ++reached;
+      tally.visit();
+      std::pair<arcit, arcit> p = out_arcs(u, myG);
+      tally.examine(p.second - p.first);
+      for (; p.first != p.second; ++p.first) {
+	const vertex_descriptor v = p.first->target;
+	const D                 d = du + D(p.first->weight);
+	if (d < distance[v]) {
+	  distance[v]    = d;
+	  predecessor[v] = u;
+	  heap.push(v, d);
+	}
+      }
+    }
+    return reached;
+  }
+
+  // -----------------------------
+  // radix_dijkstra_shortest_paths
+  // -----------------------------
+
+  /**
+   * Dijkstra with a radix heap, for unsigned integer distances
+   * a relaxation is an append to a bucket instead of a sift, which
+   * pays off on large graphs; a vertex is settled by the first of its
+   * entries to come out, the later ones are stale
+   * time: O(E + V log(C)), C the largest weight
+   * space: O(E) in the worst case, the stale entries
+   * @return the number of vertices reached from s
+   */
+  template <typename G, typename D>
+  std::size_t radix_dijkstra_shortest_paths (const G& myG, typename G::vertex_descriptor s,
+					     std::vector<D>& distance,
+					     std::vector<typename G::vertex_descriptor>& predecessor) {
+    typedef typename G::vertex_descriptor vertex_descriptor;
+    typedef typename G::arc_iterator      arcit;
+    CS_GRAPH_TIMER("radix_dijkstra_shortest_paths");
+    stats::Tally tally;
+    sssp::start(myG, s, distance, predecessor);
+    sssp::RadixHeap<D, vertex_descriptor> heap;
+    heap.push(s, D(0));
+    std::size_t reached = 0;
+    while (!heap.empty()) {
+      const std::pair<D, vertex_descriptor> e = heap.pop();
+      const vertex_descriptor               u = e.second;
+      if (distance[u] != e.first)
+	continue;
+      ++reached;
+      tally.visit();
+      std::pair<arcit, arcit> p = out_arcs(u, myG);
+      tally.examine(p.second - p.first);
+      for (; p.first != p.second; ++p.first) {
+	const vertex_descriptor v = p.first->target;
+	const D                 d = e.first + D(p.first->weight);
+	if (d < distance[v]) {
+	  distance[v]    = d;
+	  predecessor[v] = u;
+	  heap.push(v, d);
+	}
+      }
+    }
+    return reached;
+  }
+
+  // -----------------------------
+  // delta_stepping_shortest_paths
+  // -----------------------------
+
+  /**
+   * Meyer and Sanders' delta-stepping
+   * the tentative distances are kept in buckets of width delta; the
+   * vertices of the first non-empty bucket relax their light arcs
+   * (weight <= delta) all at once, in parallel, until the bucket stays
+   * empty, and then their heavy arcs, which can only reach later
+   * buckets
+   * the threads only collect the relaxations that improve a distance;
+   * one thread applies them, so the distances, the predecessors and the
+   * buckets need no atomics, and the result is that of Dijkstra
+   * delta = the smallest weight is Dijkstra, delta = infinity is
+   * Bellman-Ford; see the overload below for a default
+   * time: O(V + E + L / delta * the work of a bucket), L the longest path
+   * space: O(V + E + L / delta)
+   * @return the number of vertices reached from s
+   */
+  template <typename G, typename D>
+  std::size_t delta_stepping_shortest_paths (const G& myG, typename G::vertex_descriptor s,
+					     D delta, std::vector<D>& distance,
+					     std::vector<typename G::vertex_descriptor>& predecessor) {
+    typedef typename G::vertex_descriptor vertex_descriptor;
+    typedef std::vector<vertex_descriptor> bucket;
+    CS_GRAPH_TIMER("delta_stepping_shortest_paths");
+    stats::Tally tally;
+    assert(D(0) < delta);
+    sssp::start(myG, s, distance, predecessor);
+#ifdef _OPENMP
+    const std::size_t threads = omp_get_max_threads();
+#else
+    const std::size_t threads = 1;
+#endif
+    std::vector< std::vector< sssp::Request<D, vertex_descriptor> > > requests(threads);
+    std::vector<bucket>       buckets(1, bucket(1, s));
+    std::vector<D>            relaxed(distance.size(), std::numeric_limits<D>::max());
+    std::vector<unsigned int> settled_in(distance.size(), 0); // 1 + the bucket settling v
+    bucket                    frontier;
+    bucket                    settled;
+    std::size_t               reached = 0;
+    for (std::size_t i = 0; i < buckets.size(); ++i) {
+      settled.clear();
+      while (!buckets[i].empty()) {
+	// the entries still in bucket i whose light arcs have not gone
+	// out at their current distance
+	frontier.clear();
+	frontier.swap(buckets[i]);
+	std::size_t k = 0;
+	for (std::size_t j = 0; j != frontier.size(); ++j) {
+	  const vertex_descriptor v = frontier[j];
+	  if ((static_cast<std::size_t>(distance[v] / delta) != i) || (relaxed[v] == distance[v]))
+	    continue;
+	  relaxed[v]    = distance[v];
+	  frontier[k++] = v;
+	  if (settled_in[v] != i + 1) {
+	    settled_in[v] = static_cast<unsigned int>(i + 1);
+	    settled.push_back(v);
+	  }
+	}
+	if (k == 0)
+	  break;
+	tally.examine(sssp::relax(myG, &frontier[0], k, delta, true, distance, requests));
+	sssp::apply(requests, delta, distance, predecessor, buckets);
+      }
+      // bucket i is final, its heavy arcs only reach later buckets
+      if (!settled.empty()) {
+	tally.examine(sssp::relax(myG, &settled[0], settled.size(), delta, false, distance, requests));
+	sssp::apply(requests, delta, distance, predecessor, buckets);
+      }
+      reached += settled.size();
+      tally.visit(settled.size());
+      bucket().swap(buckets[i]);
+    }
+    return reached;
+  }
+
+  /**
+   * delta-stepping with delta the largest weight over the average out
+   * degree (at least 1), Meyer and Sanders' choice for random weights
+   * time: O(E) more than the above, to find the largest weight
+   */
+  template <typename G, typename D>
+  std::size_t delta_stepping_shortest_paths (const G& myG, typename G::vertex_descriptor s,
+					     std::vector<D>& distance,
+					     std::vector<typename G::vertex_descriptor>& predecessor) {
+    typedef typename G::arc_iterator arcit;
+    const std::size_t n = num_vertices(myG);
+    D                 m = D(0);
+    for (std::size_t u = 0; u != n; ++u) {
+      std::pair<arcit, arcit> p = out_arcs(vertex(u, myG), myG);
+      for (; p.first != p.second; ++p.first)
+	if (m < D(p.first->weight))
+	  m = D(p.first->weight);
+    }
+    const std::size_t degree = (n == 0) ? 1 : std::max<std::size_t>(1, num_edges(myG) / n);
+    D                 delta  = D(m / D(degree));
+    if (delta < D(1))
+      delta = D(1);
+    return delta_stepping_shortest_paths(myG, s, delta, distance, predecessor);
+  }
+
+} // cs
+
+#endif // ShortestPaths_h
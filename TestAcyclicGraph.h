@@ -0,0 +1,196 @@
+// -------------------------------------
+// projects/c++/graph/TestAcyclicGraph.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// -------------------------------------
+
+#ifndef TestAcyclicGraph_h
+#define TestAcyclicGraph_h
+
+// --------
+// includes
+// --------
+
+#include <iterator> // back_inserter
+#include <utility>  // pair
+#include <vector>   // vector
+
+#include "cppunit/TestFixture.h"             // TestFixture
+#include "cppunit/extensions/HelperMacros.h" // CPPUNIT_TEST, CPPUNIT_TEST_SUITE, CPPUNIT_TEST_SUITE
+
+#include "AcyclicGraph.h"
+#include "Graph.h"
+#include "GraphAlgorithms.h"
+#include "TestSampleGraph.h"
+
+// ----------------
+// TestAcyclicGraph
+// ----------------
+
+struct TestAcyclicGraph : CppUnit::TestFixture {
+  // --------
+  // typedefs
+  // --------
+
+  typedef cs::AcyclicGraph                  graph_type;
+
+  typedef graph_type::vertex_descriptor     vertex_descriptor;
+  typedef graph_type::edge_descriptor       edge_descriptor;
+  typedef graph_type::edge_iterator         edge_iterator;
+
+  // -----
+  // tests
+  // -----
+
+  graph_type g;
+
+  vertex_descriptor vdA;
+  vertex_descriptor vdB;
+  vertex_descriptor vdC;
+  vertex_descriptor vdD;
+  vertex_descriptor vdE;
+  vertex_descriptor vdF;
+  vertex_descriptor vdG;
+  vertex_descriptor vdH;
+
+  // -----
+  // setUp
+  // -----
+
+  // the graph of TestGraph without the edge (F, D)
+  void setUp () {
+    build_sample_dag(g, vdA, vdB, vdC, vdD, vdE, vdF, vdG, vdH);
+  }
+
+  // every edge goes forward in the maintained order
+  bool ordered (const graph_type& h) {
+    std::pair<edge_iterator, edge_iterator> p = edges(h);
+    for (edge_iterator b = p.first; b != p.second; ++b)
+      if (topological_index(source(*b, h), h) >= topological_index(target(*b, h), h))
+	return false;
+    return true;
+  }
+
+  // ---------------------
+  // test_add_edge_acyclic
+  // ---------------------
+
+  void test_add_edge_acyclic1 () {
+    CPPUNIT_ASSERT(!add_edge_acyclic(vdF, vdD, g));
+    CPPUNIT_ASSERT(!add_edge_acyclic(vdH, vdA, g));
+    CPPUNIT_ASSERT(!add_edge_acyclic(vdC, vdC, g));
+    CPPUNIT_ASSERT(add_edge_acyclic(vdA, vdB, g));
+    CPPUNIT_ASSERT(num_edges(g) == 10);
+    CPPUNIT_ASSERT(!edge(vdF, vdD, g).second);
+    CPPUNIT_ASSERT(in_degree(vdD, g) == 2);
+    CPPUNIT_ASSERT(!cs::has_cycle(static_cast<const cs::Graph&>(g)));
+  }
+
+  void test_add_edge_acyclic2 () {
+    CPPUNIT_ASSERT(add_edge_acyclic(vdG, vdA, g));
+    CPPUNIT_ASSERT(!add_edge_acyclic(vdH, vdC, g));
+    CPPUNIT_ASSERT(!add_edge_acyclic(vdE, vdG, g));
+    CPPUNIT_ASSERT(num_edges(g) == 11);
+    CPPUNIT_ASSERT(ordered(g));
+    remove_edge(vdG, vdA, g);
+    CPPUNIT_ASSERT(add_edge(vdE, vdG, g).second);
+    CPPUNIT_ASSERT(!add_edge(vdE, vdG, g).second);
+    CPPUNIT_ASSERT(!add_edge(vdG, vdA, g).second);
+    CPPUNIT_ASSERT(ordered(g));
+  }
+
+  void test_add_edge_acyclic3 () {
+    graph_type h;
+    for (int i = 0; i != 100; ++i)
+      add_vertex(h);
+    for (vertex_descriptor v = 99; v != 0; --v)
+      CPPUNIT_ASSERT(add_edge_acyclic(v, v - 1, h));
+    CPPUNIT_ASSERT(ordered(h));
+    CPPUNIT_ASSERT(topological_index(99, h) == 0);
+    CPPUNIT_ASSERT(topological_index(0, h) == 99);
+    CPPUNIT_ASSERT(!add_edge_acyclic(0, 99, h));
+    CPPUNIT_ASSERT(!add_edge_acyclic(50, 51, h));
+    CPPUNIT_ASSERT(add_edge_acyclic(51, 50, h));
+  }
+
+  // --------------
+  // test_add_edges
+  // --------------
+
+  void test_add_edges () {
+    typedef std::pair<vertex_descriptor, vertex_descriptor> pair_type;
+    std::vector<pair_type> es;
+    es.push_back(pair_type(vdH, vdA));
+    es.push_back(pair_type(vdE, vdH));
+    es.push_back(pair_type(9, vdG));
+    es.push_back(pair_type(vdA, 9));
+    CPPUNIT_ASSERT(add_edges(es.begin(), es.end(), g) == 3);
+    CPPUNIT_ASSERT(num_vertices(g) == 10);
+    CPPUNIT_ASSERT(edge(vdE, vdH, g).second);
+    CPPUNIT_ASSERT(!edge(vdH, vdA, g).second);
+    CPPUNIT_ASSERT(ordered(g));
+  }
+
+  // ---------------------
+  // test_topological_sort
+  // ---------------------
+
+  void test_topological_sort () {
+    std::vector<vertex_descriptor> x;
+    cs::topological_sort(g, std::back_inserter(x));
+    CPPUNIT_ASSERT(x.size() == 8);
+    for (vertex_descriptor i = 0; i != 8; ++i)
+      CPPUNIT_ASSERT(topological_index(x[i], g) == 7 - i);
+    CPPUNIT_ASSERT(!cs::has_cycle(g));
+  }
+
+  // ---------------
+  // test_random_dag
+  // ---------------
+
+  // every refused edge closes a cycle in a copy of the graph
+  void test_random_dag () {
+    const vertex_descriptor n = 200;
+    graph_type              h;
+    cs::Graph               copy;
+    for (vertex_descriptor v = 0; v != n; ++v) {
+      add_vertex(h);
+      add_vertex(copy);
+    }
+    unsigned int state   = 12345;
+    unsigned int refused = 0;
+    for (int i = 0; i != 1000; ++i) {
+      state = state * 1103515245u + 12345u;
+      const vertex_descriptor u = (state >> 8) % n;
+      state = state * 1103515245u + 12345u;
+      const vertex_descriptor v = (state >> 8) % n;
+      if (add_edge_acyclic(u, v, h))
+	add_edge(u, v, copy);
+      else if (u != v) {
+	++refused;
+	add_edge(u, v, copy);
+	CPPUNIT_ASSERT(cs::has_cycle(copy));
+	remove_edge(u, v, copy);
+      }
+    }
+    CPPUNIT_ASSERT(refused != 0);
+    CPPUNIT_ASSERT(num_edges(h) == num_edges(copy));
+    CPPUNIT_ASSERT(!cs::has_cycle(copy));
+    CPPUNIT_ASSERT(ordered(h));
+  }
+
+  // -----
+  // suite
+  // -----
+
+  CPPUNIT_TEST_SUITE(TestAcyclicGraph);
+  CPPUNIT_TEST(test_add_edge_acyclic1);
+  CPPUNIT_TEST(test_add_edge_acyclic2);
+  CPPUNIT_TEST(test_add_edge_acyclic3);
+  CPPUNIT_TEST(test_add_edges);
+  CPPUNIT_TEST(test_topological_sort);
+  CPPUNIT_TEST(test_random_dag);
+  CPPUNIT_TEST_SUITE_END();
+};
+
+#endif // TestAcyclicGraph_h
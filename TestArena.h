@@ -0,0 +1,166 @@
+// ------------------------------
+// projects/c++/graph/TestArena.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// ------------------------------
+
+#ifndef TestArena_h
+#define TestArena_h
+
+// --------
+// includes
+// --------
+
+#include <cstddef> // size_t
+
+#include "cppunit/TestFixture.h"             // TestFixture
+#include "cppunit/extensions/HelperMacros.h" // CPPUNIT_TEST, CPPUNIT_TEST_SUITE, CPPUNIT_TEST_SUITE
+
+#include "Arena.h"
+#include "Graph.h"
+#include "TestSampleGraph.h"
+
+// ---------
+// TestArena
+// ---------
+
+struct TestArena : CppUnit::TestFixture {
+  // --------
+  // typedefs
+  // --------
+
+  typedef cs::ArenaGraph                graph_type;
+  typedef graph_type::vertex_descriptor vertex_descriptor;
+
+  // -----------------
+  // test_size_classes
+  // -----------------
+
+  // a freed block is reused by the next request of its size class only
+  void test_size_classes () {
+    cs::Arena a;
+    void* p = a.allocate(24);
+    void* q = a.allocate(8);
+    CPPUNIT_ASSERT(p != q);
+    a.deallocate(p, 24);
+    CPPUNIT_ASSERT(a.allocate(8) != p);
+    CPPUNIT_ASSERT(a.allocate(17) == p);
+    a.deallocate(p, 17);
+    a.deallocate(q, 8);
+    CPPUNIT_ASSERT(a.allocate(1) == q);
+    CPPUNIT_ASSERT(a.allocate(24) == p);
+  }
+
+  // -----------
+  // test_chunks
+  // -----------
+
+  // 256-byte blocks: 16 fit in the first chunk of 4 KB, then the chunks
+  // double up to chunk_limit and stay there; larger blocks bypass them
+  void test_chunks () {
+    cs::Arena a(8192);
+    CPPUNIT_ASSERT(a.bytes_reserved() == 0);
+    for (int i = 0; i != 16; ++i)
+      a.allocate(256);
+    CPPUNIT_ASSERT(a.bytes_reserved() == 4096);
+    a.allocate(256);
+    CPPUNIT_ASSERT(a.bytes_reserved() == 4096 + 8192);
+    for (int i = 0; i != 31; ++i)
+      a.allocate(256);
+    CPPUNIT_ASSERT(a.bytes_reserved() == 4096 + 8192);
+    a.allocate(256);
+    CPPUNIT_ASSERT(a.bytes_reserved() == 4096 + 2 * 8192);
+    void* p = a.allocate(257);
+    CPPUNIT_ASSERT(a.bytes_reserved() == 4096 + 2 * 8192);
+    a.deallocate(p, 257);
+  }
+
+  // a limit below the first chunk is raised to it
+  void test_small_limit () {
+    cs::Arena a(100);
+    for (int i = 0; i != 17; ++i)
+      a.allocate(256);
+    CPPUNIT_ASSERT(a.bytes_reserved() == 2 * 4096);
+  }
+
+  // ------------
+  // test_discard
+  // ------------
+
+  // a block given back while discarding is not reused
+  void test_discard () {
+    cs::Arena a;
+    void* p = a.allocate(16);
+    a.discard(true);
+    a.discard(true);
+    a.deallocate(p, 16);
+    a.discard(false);
+    void* q = a.allocate(16);
+    CPPUNIT_ASSERT(q != p);
+    a.deallocate(q, 16);
+    CPPUNIT_ASSERT(a.allocate(16) != q);
+    a.discard(false);
+    a.deallocate(q, 16);
+    CPPUNIT_ASSERT(a.allocate(16) == q);
+  }
+
+  // --------------
+  // test_allocator
+  // --------------
+
+  // copies and rebound copies share one arena, == compares the arenas
+  void test_allocator () {
+    cs::ArenaAllocator<int>    x;
+    cs::ArenaAllocator<int>    y(x);
+    cs::ArenaAllocator<double> z(x);
+    cs::ArenaAllocator<int>    w;
+    CPPUNIT_ASSERT((x == y) && (x == z) && (z == y));
+    CPPUNIT_ASSERT((w != x) && !(w == z));
+    CPPUNIT_ASSERT(&x.get_arena() == &z.get_arena());
+    double* d = z.allocate(2);
+    CPPUNIT_ASSERT(x.get_arena().bytes_reserved() == 4096);
+    CPPUNIT_ASSERT(w.get_arena().bytes_reserved() == 0);
+    z.deallocate(d, 2);
+    CPPUNIT_ASSERT(static_cast<void*>(y.allocate(4)) == static_cast<void*>(d));
+    w = x;
+    CPPUNIT_ASSERT(w == z);
+    cs::ArenaAllocator<int> v(8192);
+    CPPUNIT_ASSERT(v != x);
+  }
+
+  // -------------
+  // test_teardown
+  // -------------
+
+  // a copy shares the arena, and outlives the teardown of its original
+  void test_teardown () {
+    graph_type        g;
+    vertex_descriptor vdA, vdB, vdC, vdD, vdE, vdF, vdG, vdH;
+    build_sample_graph(g, vdA, vdB, vdC, vdD, vdE, vdF, vdG, vdH);
+    {
+      graph_type h(g);
+      CPPUNIT_ASSERT(num_edges(h) == 11);
+    }
+    CPPUNIT_ASSERT(num_edges(g) == 11);
+    CPPUNIT_ASSERT(edge(vdF, vdD, g).second);
+    add_edge(vdH, vdA, g);
+    remove_edge(vdA, vdB, g);
+    CPPUNIT_ASSERT(num_edges(g) == 11);
+    CPPUNIT_ASSERT(agrees_with_graph(g));
+  }
+
+  // -----
+  // suite
+  // -----
+
+  CPPUNIT_TEST_SUITE(TestArena);
+  CPPUNIT_TEST(test_size_classes);
+  CPPUNIT_TEST(test_chunks);
+  CPPUNIT_TEST(test_small_limit);
+  CPPUNIT_TEST(test_discard);
+  CPPUNIT_TEST(test_allocator);
+  CPPUNIT_TEST(test_teardown);
+  CPPUNIT_TEST_SUITE_END();
+};
+
+#endif // TestArena_h
@@ -0,0 +1,113 @@
+// -----------------------------------
+// projects/c++/graph/TestBasicGraph.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// -----------------------------------
+
+#ifndef TestBasicGraph_h
+#define TestBasicGraph_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // lower_bound
+#include <utility>   // pair
+#include <vector>    // vector
+
+#include "cppunit/TestFixture.h"             // TestFixture
+#include "cppunit/extensions/HelperMacros.h" // CPPUNIT_TEST, CPPUNIT_TEST_SUITE, CPPUNIT_TEST_SUITE
+
+#include "Graph.h"
+#include "TestSampleGraph.h"
+
+// --------------
+// TestBasicGraph
+// --------------
+
+/**
+ * what cs::BasicGraph has beyond the interface of TestGraph, for each
+ * of its adjacency sets
+ */
+template <typename T>
+struct TestBasicGraph : CppUnit::TestFixture {
+  // --------
+  // typedefs
+  // --------
+
+  typedef T                                      graph_type;
+
+  typedef typename graph_type::vertex_descriptor vertex_descriptor;
+  typedef typename graph_type::edge_descriptor   edge_descriptor;
+
+  typedef typename graph_type::vertex_iterator   vertex_iterator;
+  typedef typename graph_type::edge_iterator     edge_iterator;
+
+  // -----
+  // tests
+  // -----
+
+  graph_type g;
+
+  vertex_descriptor vdA;
+  vertex_descriptor vdB;
+  vertex_descriptor vdC;
+  vertex_descriptor vdD;
+  vertex_descriptor vdE;
+  vertex_descriptor vdF;
+  vertex_descriptor vdG;
+  vertex_descriptor vdH;
+
+  // -----
+  // setUp
+  // -----
+
+  // the graph of TestGraph
+  void setUp () {
+    build_sample_graph(g, vdA, vdB, vdC, vdD, vdE, vdF, vdG, vdH);
+  }
+
+  // --------------------
+  // test_vertex_iterator
+  // --------------------
+
+  void test_vertex_iterator () {
+    const vertex_iterator b = vertices(g).first;
+    const vertex_iterator e = vertices(g).second;
+    CPPUNIT_ASSERT(e - b == 8);
+    CPPUNIT_ASSERT((b[3] == 3) && (*(e - 1) == 7) && (2 + b == b + 2));
+    CPPUNIT_ASSERT((b < e) && (e >= b) && (b + 8 == e));
+    CPPUNIT_ASSERT(std::lower_bound(b, e, 5u) - b == 5);
+  }
+
+  // ----------------
+  // test_edge_ranges
+  // ----------------
+
+  // the edges split by source ranges, in the order of edges(g)
+  void test_edge_ranges () {
+    const vertex_descriptor      cut[] = {0, 1, 3, 6, 7, 8};
+    std::vector<edge_descriptor> all;
+    for (int i = 0; i != 5; ++i) {
+      std::pair<edge_iterator, edge_iterator> p = edges(cut[i], cut[i + 1], g);
+      for (; p.first != p.second; ++p.first)
+	all.push_back(*p.first);
+    }
+    CPPUNIT_ASSERT(all.size() == 11);
+    CPPUNIT_ASSERT(all == std::vector<edge_descriptor>(edges(g).first, edges(g).second));
+    CPPUNIT_ASSERT(edges(6, 7, g).first != edges(6, 7, g).second);
+    CPPUNIT_ASSERT(edges(7, 8, g).first == edges(7, 8, g).second);
+    CPPUNIT_ASSERT(edges(4, 4, g).first == edges(4, 4, g).second);
+  }
+
+  // -----
+  // suite
+  // -----
+
+  CPPUNIT_TEST_SUITE(TestBasicGraph);
+  CPPUNIT_TEST(test_vertex_iterator);
+  CPPUNIT_TEST(test_edge_ranges);
+  CPPUNIT_TEST_SUITE_END();
+};
+
+#endif // TestBasicGraph_h
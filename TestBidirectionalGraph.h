@@ -0,0 +1,162 @@
+// -------------------------------------------
+// projects/c++/graph/TestBidirectionalGraph.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// -------------------------------------------
+
+#ifndef TestBidirectionalGraph_h
+#define TestBidirectionalGraph_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // sort
+#include <iterator>  // distance
+#include <utility>   // pair
+#include <vector>    // vector
+
+#include "cppunit/TestFixture.h"             // TestFixture
+#include "cppunit/extensions/HelperMacros.h" // CPPUNIT_TEST, CPPUNIT_TEST_SUITE, CPPUNIT_TEST_SUITE
+
+#include "BidirectionalGraph.h"
+#include "Graph.h"
+#include "TestSampleGraph.h"
+
+// ----------------------
+// TestBidirectionalGraph
+// ----------------------
+
+template <typename T>
+struct TestBidirectionalGraph : CppUnit::TestFixture {
+  // --------
+  // typedefs
+  // --------
+
+  typedef T                                           graph_type;
+
+  typedef typename graph_type::vertex_descriptor      vertex_descriptor;
+  typedef typename graph_type::edge_descriptor        edge_descriptor;
+
+  typedef typename graph_type::in_edge_iterator       in_edge_iterator;
+  typedef typename graph_type::inv_adjacency_iterator inv_adjacency_iterator;
+
+  // -----
+  // tests
+  // -----
+
+  graph_type g;
+
+  vertex_descriptor vdA;
+  vertex_descriptor vdB;
+  vertex_descriptor vdC;
+  vertex_descriptor vdD;
+  vertex_descriptor vdE;
+  vertex_descriptor vdF;
+  vertex_descriptor vdG;
+  vertex_descriptor vdH;
+
+  // -----
+  // setUp
+  // -----
+
+  // the graph of TestGraph
+  void setUp () {
+    build_sample_graph(g, vdA, vdB, vdC, vdD, vdE, vdF, vdG, vdH);
+  }
+
+  // the predecessors of v, sorted
+  std::vector<vertex_descriptor> predecessors (vertex_descriptor v) {
+    std::pair<inv_adjacency_iterator, inv_adjacency_iterator> p = inv_adjacent_vertices(v, g);
+    std::vector<vertex_descriptor> x(p.first, p.second);
+    std::sort(x.begin(), x.end());
+    return x;
+  }
+
+  // --------------
+  // test_in_degree
+  // --------------
+
+  void test_in_degree () {
+    CPPUNIT_ASSERT(in_degree(vdA, g) == 0);
+    CPPUNIT_ASSERT(in_degree(vdD, g) == 3);
+    CPPUNIT_ASSERT(in_degree(vdE, g) == 3);
+    CPPUNIT_ASSERT(in_degree(vdH, g) == 2);
+    CPPUNIT_ASSERT(out_degree(vdA, g) == 3);
+    CPPUNIT_ASSERT(out_degree(vdH, g) == 0);
+  }
+
+  // --------------------------
+  // test_inv_adjacent_vertices
+  // --------------------------
+
+  void test_inv_adjacent_vertices () {
+    std::vector<vertex_descriptor> x = predecessors(vdD);
+    CPPUNIT_ASSERT(x.size() == 3);
+    CPPUNIT_ASSERT(x[0] == vdB);
+    CPPUNIT_ASSERT(x[1] == vdC);
+    CPPUNIT_ASSERT(x[2] == vdF);
+    CPPUNIT_ASSERT(predecessors(vdG).empty());
+  }
+
+  // -------------
+  // test_in_edges
+  // -------------
+
+  void test_in_edges () {
+    std::pair<in_edge_iterator, in_edge_iterator> p = in_edges(vdH, g);
+    CPPUNIT_ASSERT(std::distance(p.first, p.second) == 2);
+    for (in_edge_iterator b = p.first; b != p.second; ++b) {
+      CPPUNIT_ASSERT(target(*b, g) == vdH);
+      CPPUNIT_ASSERT((source(*b, g) == vdF) || (source(*b, g) == vdG));
+    }
+  }
+
+  // ----------------
+  // test_remove_edge
+  // ----------------
+
+  void test_remove_edge () {
+    remove_edge(vdF, vdD, g);
+    remove_edge(vdF, vdD, g);
+    CPPUNIT_ASSERT(in_degree(vdD, g) == 2);
+    CPPUNIT_ASSERT(out_degree(vdF, g) == 1);
+    CPPUNIT_ASSERT(predecessors(vdD)[1] == vdC);
+    CPPUNIT_ASSERT(add_edge(vdF, vdD, g).second);
+    CPPUNIT_ASSERT(!add_edge(vdF, vdD, g).second);
+    CPPUNIT_ASSERT(in_degree(vdD, g) == 3);
+  }
+
+  // --------------
+  // test_add_edges
+  // --------------
+
+  void test_add_edges () {
+    using cs::add_edges;
+    typedef std::pair<vertex_descriptor, vertex_descriptor> pair_type;
+    std::vector<pair_type> es;
+    es.push_back(pair_type(vdH, vdA));
+    es.push_back(pair_type(vdA, vdB));
+    es.push_back(pair_type(9, vdA));
+    CPPUNIT_ASSERT(add_edges(es.begin(), es.end(), g) == 2);
+    CPPUNIT_ASSERT(num_vertices(g) == 10);
+    CPPUNIT_ASSERT(in_degree(vdA, g) == 2);
+    CPPUNIT_ASSERT(in_degree(vdB, g) == 1);
+    CPPUNIT_ASSERT(in_degree(9, g) == 0);
+    CPPUNIT_ASSERT(predecessors(vdA)[1] == 9);
+  }
+
+  // -----
+  // suite
+  // -----
+
+  CPPUNIT_TEST_SUITE(TestBidirectionalGraph);
+  CPPUNIT_TEST(test_in_degree);
+  CPPUNIT_TEST(test_inv_adjacent_vertices);
+  CPPUNIT_TEST(test_in_edges);
+  CPPUNIT_TEST(test_remove_edge);
+  CPPUNIT_TEST(test_add_edges);
+  CPPUNIT_TEST_SUITE_END();
+};
+
+#endif // TestBidirectionalGraph_h
@@ -0,0 +1,210 @@
+// ----------------------------------------
+// projects/c++/graph/TestCompressedGraph.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// ----------------------------------------
+
+#ifndef TestCompressedGraph_h
+#define TestCompressedGraph_h
+
+// --------
+// includes
+// --------
+
+#include <cstddef>  // size_t
+#include <iterator> // distance
+#include <utility>  // make_pair, pair
+#include <vector>   // vector
+
+#include "cppunit/TestFixture.h"             // TestFixture
+#include "cppunit/extensions/HelperMacros.h" // CPPUNIT_TEST, CPPUNIT_TEST_SUITE, CPPUNIT_TEST_SUITE
+
+#include "CompressedGraph.h"
+#include "Graph.h"
+#include "GraphAlgorithms.h"
+#include "TestSampleGraph.h"
+
+// -------------------
+// TestCompressedGraph
+// -------------------
+
+/**
+ * the graph is immutable, so each test compresses a cs::Graph and
+ * checks the copy against it
+ */
+template <typename T>
+struct TestCompressedGraph : CppUnit::TestFixture {
+  // --------
+  // typedefs
+  // --------
+
+  typedef T                                      graph_type;
+
+  typedef typename graph_type::vertex_descriptor  vertex_descriptor;
+  typedef typename graph_type::edge_iterator      edge_iterator;
+  typedef typename graph_type::adjacency_iterator adjacency_iterator;
+
+  // -----
+  // tests
+  // -----
+
+  cs::Graph g;
+
+  vertex_descriptor vdA;
+  vertex_descriptor vdB;
+  vertex_descriptor vdC;
+  vertex_descriptor vdD;
+  vertex_descriptor vdE;
+  vertex_descriptor vdF;
+  vertex_descriptor vdG;
+  vertex_descriptor vdH;
+
+  // -----
+  // setUp
+  // -----
+
+  // the graph of TestGraph
+  void setUp () {
+    build_sample_graph(g, vdA, vdB, vdC, vdD, vdE, vdF, vdG, vdH);
+  }
+
+  // the targets of v, in iteration order
+  static std::vector<vertex_descriptor> successors (vertex_descriptor v, const graph_type& h) {
+    std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(v, h);
+    return std::vector<vertex_descriptor>(p.first, p.second);
+  }
+
+  // every row of h is the row of g
+  static bool same (const cs::Graph& g, const graph_type& h) {
+    if ((num_vertices(g) != num_vertices(h)) || (num_edges(g) != num_edges(h)))
+      return false;
+    for (vertex_descriptor v = 0; v != num_vertices(g); ++v) {
+      std::pair<cs::Graph::adjacency_iterator, cs::Graph::adjacency_iterator> p = adjacent_vertices(v, g);
+      if ((std::vector<vertex_descriptor>(p.first, p.second) != successors(v, h)) ||
+	  (out_degree(v, g) != out_degree(v, h)))
+	return false;
+    }
+    return true;
+  }
+
+  // ----------
+  // test_codec
+  // ----------
+
+  // rows of every length up to 17 values of every encoded size, read
+  // back through the iterator: the first value is a zigzag delta from
+  // the source (0 here), the others are gaps, all modulo 2^32
+  void test_codec () {
+    typedef typename graph_type::codec_type codec_type;
+    const unsigned int a[] = {0, 1, 127, 128, 255, 256, 16383, 16384, 65535, 65536,
+			      2097151, 2097152, 16777215, 16777216, 268435455, 268435456, 0xffffffffu};
+    const std::size_t  n   = sizeof(a) / sizeof(a[0]);
+    for (std::size_t k = 0; k <= n; ++k) {
+      std::vector<unsigned char> bytes;
+      cs::compressed::put_varint(static_cast<unsigned int>(k), bytes);
+      codec_type::encode(a, k, bytes);
+      bytes.resize(bytes.size() + cs::compressed::slack, 0);
+      adjacency_iterator b(&bytes[0], 0);
+      CPPUNIT_ASSERT(b.size() == k);
+      unsigned int value = 0;
+      for (std::size_t i = 0; i != k; ++i, ++b) {
+	value = (i == 0) ? static_cast<unsigned int>(cs::compressed::unzigzag(a[0])) : value + a[i];
+	CPPUNIT_ASSERT(*b == value);
+      }
+      CPPUNIT_ASSERT(b == adjacency_iterator());
+    }
+    CPPUNIT_ASSERT(cs::compressed::zigzag(-1) == 1);
+    CPPUNIT_ASSERT(cs::compressed::zigzag(1) == 2);
+    CPPUNIT_ASSERT(cs::compressed::unzigzag(cs::compressed::zigzag(-7)) == -7);
+  }
+
+  // ----------
+  // test_graph
+  // ----------
+
+  void test_graph () {
+    const graph_type h(g);
+    CPPUNIT_ASSERT(same(g, h));
+    CPPUNIT_ASSERT(successors(vdF, h).size() == 2);
+    CPPUNIT_ASSERT(successors(vdF, h)[0] == vdD);
+    CPPUNIT_ASSERT(successors(vdH, h).empty());
+    CPPUNIT_ASSERT(edge(vdF, vdD, h).second);
+    CPPUNIT_ASSERT(edge(vdA, vdE, h).second);
+    CPPUNIT_ASSERT(!edge(vdA, vdD, h).second);
+    CPPUNIT_ASSERT(!edge(vdH, vdA, h).second);
+    CPPUNIT_ASSERT(memory_use(h) < 11 * sizeof(vertex_descriptor) + 9 * sizeof(std::size_t) + 32);
+    const graph_type e;
+    CPPUNIT_ASSERT(num_vertices(e) == 0);
+    CPPUNIT_ASSERT(edges(e).first == edges(e).second);
+  }
+
+  // ----------
+  // test_edges
+  // ----------
+
+  void test_edges () {
+    const graph_type h(g);
+    std::pair<edge_iterator, edge_iterator> p = edges(h);
+    CPPUNIT_ASSERT(std::distance(p.first, p.second) == 11);
+    CPPUNIT_ASSERT(*p.first == std::make_pair(vdA, vdB));
+    std::pair<cs::Graph::edge_iterator, cs::Graph::edge_iterator> q = edges(g);
+    for (; p.first != p.second; ++p.first, ++q.first)
+      CPPUNIT_ASSERT(*p.first == *q.first);
+  }
+
+  // ---------------
+  // test_algorithms
+  // ---------------
+
+  // the templates of GraphAlgorithms.h agree with cs::Graph
+  void test_algorithms () {
+    graph_type h(g);
+    CPPUNIT_ASSERT(cs::has_cycle(h));
+    std::vector<std::size_t> c;
+    CPPUNIT_ASSERT(cs::strongly_connected_components(h, c) == 7);
+    CPPUNIT_ASSERT(agrees_with_graph(h));
+    remove_edge(vdF, vdD, g);
+    h = graph_type(g);
+    CPPUNIT_ASSERT(!cs::has_cycle(h));
+    CPPUNIT_ASSERT(agrees_with_graph(h));
+  }
+
+  // ---------------
+  // test_edge_range
+  // ---------------
+
+  // rows of every length and gap, built straight from an edge list,
+  // with duplicates, against cs::Graph
+  void test_edge_range () {
+    const vertex_descriptor n = 70000;
+    std::vector< std::pair<vertex_descriptor, vertex_descriptor> > es;
+    unsigned int x = 12345;
+    for (vertex_descriptor u = 0; u != 300; ++u)
+      for (vertex_descriptor i = 0; i != u; ++i) {
+	x = x * 1103515245u + 12345u;
+	es.push_back(std::make_pair(u * 233, (x >> 8) % ((i % 3 == 0) ? n : 300)));
+      }
+    es.push_back(std::make_pair(n - 1, 0));
+    es.push_back(std::make_pair(n - 1, n - 1));
+    es.push_back(std::make_pair(n - 1, 0));
+    const cs::Graph  k(n, es.begin(), es.end());
+    const graph_type h(n, es.begin(), es.end());
+    CPPUNIT_ASSERT(same(k, h));
+    CPPUNIT_ASSERT(same(k, graph_type(k)));
+    CPPUNIT_ASSERT(out_degree(n - 1, h) == 2);
+  }
+
+  // -----
+  // suite
+  // -----
+
+  CPPUNIT_TEST_SUITE(TestCompressedGraph);
+  CPPUNIT_TEST(test_codec);
+  CPPUNIT_TEST(test_graph);
+  CPPUNIT_TEST(test_edges);
+  CPPUNIT_TEST(test_algorithms);
+  CPPUNIT_TEST(test_edge_range);
+  CPPUNIT_TEST_SUITE_END();
+};
+
+#endif // TestCompressedGraph_h
@@ -0,0 +1,156 @@
+// ----------------------------------------
+// projects/c++/graph/TestConcurrentGraph.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// ----------------------------------------
+
+#ifndef TestConcurrentGraph_h
+#define TestConcurrentGraph_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // sort
+#include <cstddef>   // size_t
+#include <utility>   // pair
+#include <vector>    // vector
+
+#include "cppunit/TestFixture.h"             // TestFixture
+#include "cppunit/extensions/HelperMacros.h" // CPPUNIT_TEST, CPPUNIT_TEST_SUITE, CPPUNIT_TEST_SUITE
+
+#include "ConcurrentGraph.h"
+#include "Graph.h"
+
+// -------------------
+// TestConcurrentGraph
+// -------------------
+
+/**
+ * the interface itself is covered by TestGraph<cs::ConcurrentGraph>;
+ * these run many writers at once (8 threads, whatever the machine)
+ */
+struct TestConcurrentGraph : CppUnit::TestFixture {
+  // --------
+  // typedefs
+  // --------
+
+  typedef cs::ConcurrentGraph               graph_type;
+
+  typedef graph_type::vertex_descriptor     vertex_descriptor;
+  typedef graph_type::edge_iterator         edge_iterator;
+
+  // the i-th edge of a fixed pseudo-random sequence over n vertices
+  static std::pair<vertex_descriptor, vertex_descriptor> random_edge (long i, vertex_descriptor n) {
+    unsigned long x = static_cast<unsigned long>(i) * 2654435761u + 12345u;
+    x ^= x >> 13;
+    x *= 1103515245u;
+    x ^= x >> 16;
+    return std::make_pair(static_cast<vertex_descriptor>(x % n),
+			  static_cast<vertex_descriptor>((x >> 20) % n));
+  }
+
+  // ---------------
+  // test_add_vertex
+  // ---------------
+
+  // every writer gets distinct vertices, and the count is exact
+  void test_add_vertex () {
+    const long                     n = 100000;
+    graph_type                     g;
+    std::vector<vertex_descriptor> v(n);
+    #pragma omp parallel for num_threads(8)
+    for (long i = 0; i < n; ++i)
+      v[i] = add_vertex(g);
+    CPPUNIT_ASSERT(num_vertices(g) == static_cast<std::size_t>(n));
+    std::sort(v.begin(), v.end());
+    for (long i = 0; i != n; ++i)
+      CPPUNIT_ASSERT(v[i] == static_cast<vertex_descriptor>(i));
+    CPPUNIT_ASSERT(out_degree(vertex_descriptor(n - 1), g) == 0);
+  }
+
+  // -------------
+  // test_add_edge
+  // -------------
+
+  // the same edges, in parallel and serially, give the same graph
+  void test_add_edge () {
+    const vertex_descriptor n = 1000;
+    const long              m = 200000;
+    graph_type              g;
+    cs::Graph               h;
+    for (vertex_descriptor v = 0; v != n; ++v) {
+      add_vertex(g);
+      add_vertex(h);
+    }
+    std::size_t inserted = 0;
+    #pragma omp parallel for num_threads(8) reduction(+:inserted)
+    for (long i = 0; i < m; ++i)
+      inserted += add_edge(random_edge(i, n).first, random_edge(i, n).second, g).second;
+    for (long i = 0; i < m; ++i)
+      add_edge(random_edge(i, n).first, random_edge(i, n).second, h);
+    CPPUNIT_ASSERT(inserted == num_edges(h));
+    CPPUNIT_ASSERT(num_edges(g) == num_edges(h));
+    std::pair<edge_iterator, edge_iterator> p = edges(g);
+    for (edge_iterator b = p.first; b != p.second; ++b)
+      CPPUNIT_ASSERT(edge((*b).first, (*b).second, h).second);
+
+    #pragma omp parallel for num_threads(8)
+    for (long i = 0; i < m; i += 2)
+      remove_edge(random_edge(i, n).first, random_edge(i, n).second, g);
+    std::size_t left = 0;
+    for (vertex_descriptor v = 0; v != n; ++v)
+      left += out_degree(v, g);
+    CPPUNIT_ASSERT(left == num_edges(g));
+    CPPUNIT_ASSERT(!edge(random_edge(0, n).first, random_edge(0, n).second, g).second);
+  }
+
+  // ----------
+  // test_mixed
+  // ----------
+
+  // writers add vertices and edges into them while others do the same
+  void test_mixed () {
+    const long n = 50000;
+    graph_type g;
+    const vertex_descriptor hub = add_vertex(g);
+    #pragma omp parallel for num_threads(8)
+    for (long i = 0; i < n; ++i) {
+      const vertex_descriptor v = add_vertex(g);
+      add_edge(hub, v, g);
+      add_edge(v, static_cast<vertex_descriptor>(v / 2), g);
+    }
+    CPPUNIT_ASSERT(num_vertices(g) == static_cast<std::size_t>(n + 1));
+    CPPUNIT_ASSERT(out_degree(hub, g) == static_cast<std::size_t>(n));
+    CPPUNIT_ASSERT(num_edges(g) == static_cast<std::size_t>(2 * n));
+    CPPUNIT_ASSERT(edge(vertex_descriptor(n), vertex_descriptor(n / 2), g).second);
+  }
+
+  // --------------
+  // test_add_edges
+  // --------------
+
+  void test_add_edges () {
+    std::vector< std::pair<vertex_descriptor, vertex_descriptor> > es;
+    for (long i = 0; i != 50000; ++i)
+      es.push_back(random_edge(i, 5000));
+    graph_type g(5000, es.begin(), es.end());
+    cs::Graph  h(5000, es.begin(), es.end());
+    CPPUNIT_ASSERT(num_vertices(g) == 5000);
+    CPPUNIT_ASSERT(num_edges(g) == num_edges(h));
+    CPPUNIT_ASSERT(add_edges(es.begin(), es.end(), g) == 0);
+  }
+
+  // -----
+  // suite
+  // -----
+
+  CPPUNIT_TEST_SUITE(TestConcurrentGraph);
+  CPPUNIT_TEST(test_add_vertex);
+  CPPUNIT_TEST(test_add_edge);
+  CPPUNIT_TEST(test_mixed);
+  CPPUNIT_TEST(test_add_edges);
+  CPPUNIT_TEST_SUITE_END();
+};
+
+#endif // TestConcurrentGraph_h
@@ -0,0 +1,171 @@
+// ------------------------------------
+// projects/c++/graph/TestDagExecutor.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// ------------------------------------
+
+#ifndef TestDagExecutor_h
+#define TestDagExecutor_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // swap
+#include <cstddef>   // size_t
+#include <utility>   // pair
+#include <vector>    // vector
+
+#include "cppunit/TestFixture.h"             // TestFixture
+#include "cppunit/extensions/HelperMacros.h" // CPPUNIT_TEST, CPPUNIT_TEST_SUITE, CPPUNIT_TEST_SUITE
+
+#include "DagExecutor.h"
+#include "Graph.h"
+
+// ---------------
+// TestDagExecutor
+// ---------------
+
+struct TestDagExecutor : CppUnit::TestFixture {
+  // --------
+  // typedefs
+  // --------
+
+  typedef cs::Graph                     graph_type;
+  typedef graph_type::vertex_descriptor vertex_descriptor;
+  typedef graph_type::edge_iterator     edge_iterator;
+
+  // ------
+  // Record
+  // ------
+
+  // stamps the start and the finish of every call from one shared clock
+  // and fails on one chosen vertex
+  struct Record {
+    volatile long*     clock;
+    std::vector<long>* started;
+    std::vector<long>* finished;
+    std::vector<int>*  calls;
+    vertex_descriptor  failing;
+
+    bool operator () (vertex_descriptor v) const {
+      (*started)[v] = __sync_fetch_and_add(clock, 1);
+      __sync_fetch_and_add(&(*calls)[v], 1);
+      if (v == failing)
+	return false;
+      (*finished)[v] = __sync_fetch_and_add(clock, 1);
+      return true;
+    }
+  };
+
+  volatile long     clock;
+  std::vector<long> started;
+  std::vector<long> finished;
+  std::vector<int>  calls;
+
+  Record record (const graph_type& g, vertex_descriptor failing) {
+    clock = 0;
+    started.assign(num_vertices(g), -1);
+    finished.assign(num_vertices(g), -1);
+    calls.assign(num_vertices(g), 0);
+    const Record r = {&clock, &started, &finished, &calls, failing};
+    return r;
+  }
+
+  static graph_type chain (vertex_descriptor n) {
+    graph_type g;
+    for (vertex_descriptor v = 0; v != n; ++v)
+      add_vertex(g);
+    for (vertex_descriptor v = 1; v < n; ++v)
+      add_edge(v - 1, v, g);
+    return g;
+  }
+
+  // ----------
+  // test_order
+  // ----------
+
+  // more threads than cores, so that vertices are stolen
+  void test_order () {
+    const vertex_descriptor n = 3000;
+    graph_type              g;
+    for (vertex_descriptor v = 0; v != n; ++v)
+      add_vertex(g);
+    unsigned int x = 2463534242u;
+    for (int i = 0; i != 12000; ++i) {
+      x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+      vertex_descriptor u = x % n;
+      x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+      vertex_descriptor v = x % n;
+      if (u > v)
+	std::swap(u, v);
+      if (u != v)
+	add_edge(u, v, g);
+    }
+    for (int threads = 1; threads <= 4; threads += 3) {
+      std::size_t completed = 0;
+      CPPUNIT_ASSERT(cs::execute_dag(g, record(g, n), &completed, threads));
+      CPPUNIT_ASSERT(completed == n);
+      for (vertex_descriptor v = 0; v != n; ++v)
+	CPPUNIT_ASSERT(calls[v] == 1);
+      std::pair<edge_iterator, edge_iterator> p = edges(g);
+      for (; p.first != p.second; ++p.first)
+	CPPUNIT_ASSERT(finished[source(*p.first, g)] < started[target(*p.first, g)]);
+    }
+    CPPUNIT_ASSERT(cs::execute_dag(graph_type(), record(graph_type(), 0)));
+  }
+
+  // ------------
+  // test_failure
+  // ------------
+
+  void test_failure () {
+    const graph_type g = chain(100);
+    std::size_t      completed = 0;
+    CPPUNIT_ASSERT(!cs::execute_dag(g, record(g, 50), &completed, 4));
+    CPPUNIT_ASSERT(completed == 50);
+    CPPUNIT_ASSERT(calls[50] == 1);
+    CPPUNIT_ASSERT(calls[51] == 0);
+
+    // a failed root cancels all 1000 of its children
+    graph_type h;
+    add_vertex(h);
+    for (vertex_descriptor v = 1; v <= 1000; ++v) {
+      add_vertex(h);
+      add_edge(0, v, h);
+    }
+    CPPUNIT_ASSERT(!cs::execute_dag(h, record(h, 0), &completed, 4));
+    CPPUNIT_ASSERT(completed == 0);
+    CPPUNIT_ASSERT(calls[1] == 0);
+  }
+
+  // ----------
+  // test_cycle
+  // ----------
+
+  // 0 -> 1 -> 2 -> 1, 3 alone: only 0 and 3 ever run
+  void test_cycle () {
+    graph_type g;
+    for (int i = 0; i != 4; ++i)
+      add_vertex(g);
+    add_edge(0, 1, g);
+    add_edge(1, 2, g);
+    add_edge(2, 1, g);
+    std::size_t completed = 0;
+    CPPUNIT_ASSERT(!cs::execute_dag(g, record(g, 4), &completed, 2));
+    CPPUNIT_ASSERT(completed == 2);
+    CPPUNIT_ASSERT((calls[0] == 1) && (calls[1] == 0) && (calls[2] == 0) && (calls[3] == 1));
+  }
+
+  // -----
+  // suite
+  // -----
+
+  CPPUNIT_TEST_SUITE(TestDagExecutor);
+  CPPUNIT_TEST(test_order);
+  CPPUNIT_TEST(test_failure);
+  CPPUNIT_TEST(test_cycle);
+  CPPUNIT_TEST_SUITE_END();
+};
+
+#endif // TestDagExecutor_h
@@ -0,0 +1,223 @@
+// -----------------------------------
+// projects/c++/graph/TestDenseGraph.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// -----------------------------------
+
+#ifndef TestDenseGraph_h
+#define TestDenseGraph_h
+
+// --------
+// includes
+// --------
+
+#include <cstddef>  // size_t
+#include <iterator> // distance
+#include <utility>  // pair
+#include <vector>   // vector
+
+#include "cppunit/TestFixture.h"             // TestFixture
+#include "cppunit/extensions/HelperMacros.h" // CPPUNIT_TEST, CPPUNIT_TEST_SUITE, CPPUNIT_TEST_SUITE
+
+#include "DenseGraph.h"
+#include "Graph.h"
+#include "GraphAlgorithms.h"
+#include "TestSampleGraph.h"
+
+// --------------
+// TestDenseGraph
+// --------------
+
+/**
+ * TestGraph itself grows chains of 300000 vertices, which a matrix
+ * cannot hold, so DenseGraph has its own fixture over the same graph
+ */
+struct TestDenseGraph : CppUnit::TestFixture {
+  // --------
+  // typedefs
+  // --------
+
+  typedef cs::DenseGraph                    graph_type;
+
+  typedef graph_type::vertex_descriptor     vertex_descriptor;
+  typedef graph_type::edge_iterator         edge_iterator;
+  typedef graph_type::adjacency_iterator    adjacency_iterator;
+
+  // -----
+  // tests
+  // -----
+
+  graph_type g;
+
+  vertex_descriptor vdA;
+  vertex_descriptor vdB;
+  vertex_descriptor vdC;
+  vertex_descriptor vdD;
+  vertex_descriptor vdE;
+  vertex_descriptor vdF;
+  vertex_descriptor vdG;
+  vertex_descriptor vdH;
+
+  // -----
+  // setUp
+  // -----
+
+  // the graph of TestGraph
+  void setUp () {
+    build_sample_graph(g, vdA, vdB, vdC, vdD, vdE, vdF, vdG, vdH);
+  }
+
+  // the targets of v, in iteration order
+  std::vector<vertex_descriptor> successors (vertex_descriptor v, const graph_type& h) {
+    std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(v, h);
+    return std::vector<vertex_descriptor>(p.first, p.second);
+  }
+
+  // ---------
+  // test_edge
+  // ---------
+
+  void test_edge () {
+    CPPUNIT_ASSERT(num_vertices(g) == 8);
+    CPPUNIT_ASSERT(num_edges(g) == 11);
+    CPPUNIT_ASSERT(edge(vdF, vdD, g).second);
+    CPPUNIT_ASSERT(!edge(vdD, vdA, g).second);
+    CPPUNIT_ASSERT(!add_edge(vdA, vdB, g).second);
+    remove_edge(vdA, vdB, g);
+    remove_edge(vdA, vdB, g);
+    CPPUNIT_ASSERT(!edge(vdA, vdB, g).second);
+    CPPUNIT_ASSERT(num_edges(g) == 10);
+    CPPUNIT_ASSERT(out_degree(vdA, g) == 2);
+    CPPUNIT_ASSERT(out_degree(vdH, g) == 0);
+  }
+
+  // ----------------------
+  // test_adjacent_vertices
+  // ----------------------
+
+  void test_adjacent_vertices () {
+    std::vector<vertex_descriptor> x = successors(vdA, g);
+    CPPUNIT_ASSERT(x.size() == 3);
+    CPPUNIT_ASSERT((x[0] == vdB) && (x[1] == vdC) && (x[2] == vdE));
+    CPPUNIT_ASSERT(successors(vdH, g).empty());
+    while (num_vertices(g) != 600)
+      add_vertex(g);
+    add_edge(vdH, 599, g);
+    add_edge(vdH, 64, g);
+    add_edge(vdH, 63, g);
+    add_edge(vdH, vdH, g);
+    x = successors(vdH, g);
+    CPPUNIT_ASSERT(x.size() == 4);
+    CPPUNIT_ASSERT((x[0] == vdH) && (x[1] == 63) && (x[2] == 64) && (x[3] == 599));
+    CPPUNIT_ASSERT(out_degree(vdH, g) == 4);
+  }
+
+  // ----------
+  // test_edges
+  // ----------
+
+  void test_edges () {
+    std::pair<edge_iterator, edge_iterator> p = edges(g);
+    CPPUNIT_ASSERT(std::distance(p.first, p.second) == 11);
+    CPPUNIT_ASSERT(*p.first == std::make_pair(vdA, vdB));
+    vertex_descriptor last = 0;
+    for (edge_iterator b = p.first; b != p.second; ++b) {
+      CPPUNIT_ASSERT(edge(source(*b, g), target(*b, g), g).second);
+      CPPUNIT_ASSERT(source(*b, g) >= last);
+      last = source(*b, g);
+    }
+    CPPUNIT_ASSERT(last == vdG);
+    graph_type h;
+    CPPUNIT_ASSERT(edges(h).first == edges(h).second);
+  }
+
+  // -----------
+  // test_growth
+  // -----------
+
+  void test_growth () {
+    for (int i = 0; i != 1000; ++i)
+      add_vertex(g);
+    CPPUNIT_ASSERT(num_vertices(g) == 1008);
+    CPPUNIT_ASSERT(num_edges(g) == 11);
+    CPPUNIT_ASSERT(edge(vdG, vdH, g).second);
+    CPPUNIT_ASSERT(successors(1007, g).empty());
+    CPPUNIT_ASSERT(row_words(g) * sizeof(cs::bits::word) % cs::bits::line_bytes == 0);
+    for (vertex_descriptor v = 0; v != 8; ++v) {
+      const std::size_t address = reinterpret_cast<std::size_t>(adjacency_row(v, g));
+      CPPUNIT_ASSERT(address % cs::bits::line_bytes == 0);
+    }
+    graph_type h(g);
+    add_edge(1007, vdA, h);
+    CPPUNIT_ASSERT(num_edges(h) == 12);
+    CPPUNIT_ASSERT(!edge(1007, vdA, g).second);
+    g = h;
+    CPPUNIT_ASSERT(edge(1007, vdA, g).second);
+  }
+
+  // ---------------
+  // test_algorithms
+  // ---------------
+
+  // the templates of GraphAlgorithms.h agree with cs::Graph
+  void test_algorithms () {
+    CPPUNIT_ASSERT(cs::has_cycle(g));
+    std::vector<std::size_t> c;
+    CPPUNIT_ASSERT(cs::strongly_connected_components(g, c) == 7);
+    CPPUNIT_ASSERT(agrees_with_graph(g));
+    remove_edge(vdF, vdD, g);
+    CPPUNIT_ASSERT(!cs::has_cycle(g));
+    CPPUNIT_ASSERT(agrees_with_graph(g));
+  }
+
+  // -------------------
+  // test_row_operations
+  // -------------------
+
+  void test_row_operations () {
+    CPPUNIT_ASSERT(common_successors(vdA, vdB, g) == 1);
+    CPPUNIT_ASSERT(common_successors(vdB, vdC, g) == 1);
+    row_union(vdA, vdD, g);
+    CPPUNIT_ASSERT(out_degree(vdA, g) == 4);
+    CPPUNIT_ASSERT(num_edges(g) == 12);
+    row_difference(vdA, vdB, g);
+    CPPUNIT_ASSERT(successors(vdA, g).size() == 3);
+    CPPUNIT_ASSERT(!edge(vdA, vdE, g).second && edge(vdA, vdF, g).second);
+    CPPUNIT_ASSERT(num_edges(g) == 11);
+    row_intersection(vdA, vdD, g);
+    CPPUNIT_ASSERT(successors(vdA, g) == std::vector<vertex_descriptor>(1, vdF));
+    CPPUNIT_ASSERT(num_edges(g) == 9);
+  }
+
+  // -----------------------
+  // test_transitive_closure
+  // -----------------------
+
+  void test_transitive_closure () {
+    graph_type h(g);
+    transitive_closure(h);
+    CPPUNIT_ASSERT(successors(vdA, h).size() == 6);
+    CPPUNIT_ASSERT(edge(vdD, vdD, h).second);
+    CPPUNIT_ASSERT(!edge(vdA, vdA, h).second);
+    CPPUNIT_ASSERT(!edge(vdA, vdG, h).second);
+    CPPUNIT_ASSERT(edge(vdB, vdH, h).second);
+    CPPUNIT_ASSERT(successors(vdG, h) == std::vector<vertex_descriptor>(1, vdH));
+    CPPUNIT_ASSERT(num_edges(h) == 6 + 4 + 4 + 4 + 0 + 4 + 1 + 0);
+  }
+
+  // -----
+  // suite
+  // -----
+
+  CPPUNIT_TEST_SUITE(TestDenseGraph);
+  CPPUNIT_TEST(test_edge);
+  CPPUNIT_TEST(test_adjacent_vertices);
+  CPPUNIT_TEST(test_edges);
+  CPPUNIT_TEST(test_growth);
+  CPPUNIT_TEST(test_algorithms);
+  CPPUNIT_TEST(test_row_operations);
+  CPPUNIT_TEST(test_transitive_closure);
+  CPPUNIT_TEST_SUITE_END();
+};
+
+#endif // TestDenseGraph_h
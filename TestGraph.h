@@ -11,15 +11,25 @@
 // includes
 // --------
 
-#include <iterator> // ostream_iterator
-#include <sstream>  // ostringstream
-#include <utility>  // pair
+#include <algorithm> // find
+#include <cstddef>   // size_t
+#include <cstdio>    // fopen, fputc, fputs, fseek, fwrite, remove
+#include <iterator>  // back_inserter, distance, ostream_iterator
+#include <limits>    // numeric_limits
+#include <sstream>   // ostringstream
+#include <utility>   // pair
+#include <vector>    // vector
+
+#include <stdint.h>  // uint32_t
 
 #include "cppunit/TestFixture.h"             // TestFixture
 #include "cppunit/extensions/HelperMacros.h" // CPPUNIT_TEST, CPPUNIT_TEST_SUITE, CPPUNIT_TEST_SUITE
 
+#include "CsrGraph.h"
+#include "EdgeListReader.h"
 #include "Graph.h"
 #include "GraphAlgorithms.h"
+#include "MappedGraph.h"
 
 // ---------
 // TestGraph
@@ -120,6 +130,60 @@ struct TestGraph : CppUnit::TestFixture {
     remove_edge(vdE, vdG, g);
   }
 
+  void test_add_edge3() {
+    std::vector<vertex_descriptor> vs;
+    for (int i = 0; i != 64; ++i)
+      vs.push_back(add_vertex(g));
+    for (int i = 0; i != 64; ++i)
+      CPPUNIT_ASSERT(add_edge(vdG, vs[i], g).second);
+    for (int i = 0; i < 64; i += 2)
+      remove_edge(vdG, vs[i], g);
+    for (int i = 0; i != 64; ++i)
+      CPPUNIT_ASSERT(edge(vdG, vs[i], g).second == (i % 2 == 1));
+    CPPUNIT_ASSERT(edge(vdG, vdH, g).second);
+    adjacency_iterator b = adjacent_vertices(vdG, g).first;
+    adjacency_iterator e = adjacent_vertices(vdG, g).second;
+    CPPUNIT_ASSERT(std::distance(b, e) == 33);
+    CPPUNIT_ASSERT(!add_edge(vdG, vs[63], g).second);
+  }
+
+  // --------------
+  // test_add_edges
+  // --------------
+
+  void test_add_edges() {
+    using cs::add_edges;
+    typedef std::pair<vertex_descriptor, vertex_descriptor> pair_type;
+    std::vector<pair_type> es;
+    es.push_back(pair_type(vdH, vdA));
+    es.push_back(pair_type(vdA, vdB));
+    es.push_back(pair_type(vdE, vdG));
+    es.push_back(pair_type(vdH, vdA));
+    es.push_back(pair_type(vdH, vdC));
+    es.push_back(pair_type(vdE, vdG));
+    CPPUNIT_ASSERT(add_edges(es.begin(), es.end(), g) == 3);
+    CPPUNIT_ASSERT(num_edges(g) == 14);
+    CPPUNIT_ASSERT(edge(vdH, vdA, g).second);
+    CPPUNIT_ASSERT(edge(vdH, vdC, g).second);
+    CPPUNIT_ASSERT(edge(vdE, vdG, g).second);
+    adjacency_iterator b = adjacent_vertices(vdH, g).first;
+    adjacency_iterator e = adjacent_vertices(vdH, g).second;
+    CPPUNIT_ASSERT(std::distance(b, e) == 2);
+  }
+
+  void test_add_edges2() {
+    using cs::add_edges;
+    typedef std::pair<vertex_descriptor, vertex_descriptor> pair_type;
+    std::vector<pair_type> es;
+    es.push_back(pair_type(vdA, 9));
+    es.push_back(pair_type(9, vdA));
+    CPPUNIT_ASSERT(add_edges(es.begin(), es.end(), g) == 2);
+    CPPUNIT_ASSERT(num_vertices(g) == 10);
+    CPPUNIT_ASSERT(num_edges(g) == 13);
+    CPPUNIT_ASSERT(edge(9, vdA, g).second);
+    CPPUNIT_ASSERT(add_edges(es.begin(), es.end(), g) == 0);
+  }
+
   // -----------
   // test_vertex
   // -----------
@@ -239,6 +303,18 @@ struct TestGraph : CppUnit::TestFixture {
     CPPUNIT_ASSERT(p.second == false);
   }
 
+  // ---------------
+  // test_out_degree
+  // ---------------
+
+  void test_out_degree() {
+    CPPUNIT_ASSERT(out_degree(vdA, g) == 3);
+    CPPUNIT_ASSERT(out_degree(vdF, g) == 2);
+    CPPUNIT_ASSERT(out_degree(vdH, g) == 0);
+    remove_edge(vdA, vdB, g);
+    CPPUNIT_ASSERT(out_degree(vdA, g) == 2);
+  }
+
   // -----------------
   // test_num_vertices
   // -----------------
@@ -257,6 +333,20 @@ struct TestGraph : CppUnit::TestFixture {
     CPPUNIT_ASSERT(es == 11);
   }
 
+  void test_num_edges2() {
+    CPPUNIT_ASSERT(!add_edge(vdA, vdB, g).second);
+    CPPUNIT_ASSERT(num_edges(g) == 11);
+    remove_edge(vdD, vdG, g);
+    CPPUNIT_ASSERT(num_edges(g) == 11);
+    remove_edge(vdA, vdB, g);
+    CPPUNIT_ASSERT(num_edges(g) == 10);
+    remove_edge(vdA, vdB, g);
+    CPPUNIT_ASSERT(num_edges(g) == 10);
+    CPPUNIT_ASSERT(add_edge(vdA, vdB, g).second);
+    CPPUNIT_ASSERT(add_edge(vdH, vdA, g).second);
+    CPPUNIT_ASSERT(num_edges(g) == 12);
+  }
+
   // -----------
   // test_source
   // -----------
@@ -408,6 +498,45 @@ struct TestGraph : CppUnit::TestFixture {
     CPPUNIT_ASSERT(ed == edAC);
   }
 
+  // the standard algorithms need iterator_traits and ==
+  void test_edges2 () {
+    std::pair<edge_iterator, edge_iterator> p = edges(g);
+    CPPUNIT_ASSERT(std::distance(p.first, p.second) == 11);
+    const std::vector<edge_descriptor> es(p.first, p.second);
+    CPPUNIT_ASSERT(es.size() == 11);
+    CPPUNIT_ASSERT(std::find(es.begin(), es.end(), edFD) != es.end());
+    CPPUNIT_ASSERT(std::distance(vertices(g).first, vertices(g).second) == 8);
+    const graph_type h;
+    CPPUNIT_ASSERT(edges(h).first == edges(h).second);
+    CPPUNIT_ASSERT(vertices(h).first == vertices(h).second);
+  }
+
+  // ---------------------------
+  // test_parallel_for_each_edge
+  // ---------------------------
+
+  // counts every edge in a slot of its own, so the threads never collide
+  struct MarkEdge {
+    std::vector<int>* marks;
+    std::size_t       n;
+
+    MarkEdge (std::vector<int>* marks, std::size_t n) : marks(marks), n(n) {}
+
+    template <typename E>
+    void operator () (const E& e) const {
+      ++(*marks)[e.first * n + e.second];
+    }
+  };
+
+  void test_parallel_for_each_edge () {
+    const std::size_t n = num_vertices(g);
+    std::vector<int>  marks(n * n, 0);
+    cs::parallel_for_each_edge(g, MarkEdge(&marks, n));
+    for (std::size_t u = 0; u != n; ++u)
+      for (std::size_t v = 0; v != n; ++v)
+	CPPUNIT_ASSERT(marks[u * n + v] == edge(vertex(u, g), vertex(v, g), g).second);
+  }
+
   // ----------------------
   // test_adjacent_vertices
   // ----------------------
@@ -439,6 +568,25 @@ struct TestGraph : CppUnit::TestFixture {
     edDF = add_edge(vdD, vdF, g).first;
   }
 
+  // deeper than the call stack could ever recurse
+  // unreachable from vdA, so a whole-graph traversal is needed to see it
+  void add_chain (int n) {
+    vertex_descriptor u = add_vertex(g);
+    for (int i = 1; i != n; ++i) {
+      vertex_descriptor v = add_vertex(g);
+      add_edge(u, v, g);
+      u = v;
+    }
+  }
+
+  void test_has_cycle3() {
+    remove_edge(vdD, vdF, g);
+    add_chain(300000);
+    CPPUNIT_ASSERT(!cs::has_cycle(g));
+    add_edge(vertex(num_vertices(g) - 1, g), vertex(8, g), g);
+    CPPUNIT_ASSERT(cs::has_cycle(g));
+  }
+
   // ---------------------
   // test_topological_sort
   // ---------------------
@@ -451,6 +599,374 @@ struct TestGraph : CppUnit::TestFixture {
     edDF = add_edge(vdD, vdF, g).first;
   }
 
+  void test_topological_sort2 () {
+    remove_edge(vdD, vdF, g);
+    add_chain(300000);
+    std::vector<vertex_descriptor> order;
+    cs::topological_sort(g, std::back_inserter(order));
+    CPPUNIT_ASSERT(order.size() == num_vertices(g));
+    CPPUNIT_ASSERT(order[0] == vdE);
+    CPPUNIT_ASSERT(order[8] == vertex(num_vertices(g) - 1, g));
+    CPPUNIT_ASSERT(order.back() == vertex(8, g));
+  }
+
+  // ------------------------------
+  // test_parallel_topological_sort
+  // ------------------------------
+
+  void test_parallel_topological_sort1 () {
+    std::ostringstream out;
+    std::vector<std::size_t> levels;
+    remove_edge(vdD, vdF, g);
+    CPPUNIT_ASSERT(cs::parallel_topological_sort(g, std::ostream_iterator<vertex_descriptor>(out, " "), &levels));
+    CPPUNIT_ASSERT(out.str() == "4 3 7 2 1 6 5 0 ");
+    CPPUNIT_ASSERT(levels[vdA] == 0);
+    CPPUNIT_ASSERT(levels[vdB] == 1);
+    CPPUNIT_ASSERT(levels[vdC] == 1);
+    CPPUNIT_ASSERT(levels[vdD] == 2);
+    CPPUNIT_ASSERT(levels[vdE] == 3);
+    CPPUNIT_ASSERT(levels[vdF] == 0);
+    CPPUNIT_ASSERT(levels[vdG] == 0);
+    CPPUNIT_ASSERT(levels[vdH] == 1);
+    edDF = add_edge(vdD, vdF, g).first;
+  }
+
+  void test_parallel_topological_sort2 () {
+    std::vector<vertex_descriptor> order;
+    CPPUNIT_ASSERT(!cs::parallel_topological_sort(g, std::back_inserter(order)));
+    CPPUNIT_ASSERT(order.empty());
+  }
+
+  void test_parallel_topological_sort3 () {
+    remove_edge(vdD, vdF, g);
+    add_chain(300000);
+    std::vector<vertex_descriptor> order;
+    std::vector<std::size_t>       levels;
+    CPPUNIT_ASSERT(cs::parallel_topological_sort(g, std::back_inserter(order), &levels));
+    CPPUNIT_ASSERT(order.size() == num_vertices(g));
+    CPPUNIT_ASSERT(order.front() == vertex(num_vertices(g) - 1, g));
+    CPPUNIT_ASSERT(levels[vertex(num_vertices(g) - 1, g)] == 299999);
+  }
+
+  // ------------------
+  // test_longest_paths
+  // ------------------
+
+  void test_longest_paths1 () {
+    std::vector<std::size_t>       length;
+    std::vector<vertex_descriptor> successor;
+    std::ostringstream             out;
+    remove_edge(vdD, vdF, g);
+    cs::longest_paths(g, length, successor);
+    CPPUNIT_ASSERT(length[vdA] == 4);
+    CPPUNIT_ASSERT(length[vdC] == 3);
+    CPPUNIT_ASSERT(length[vdE] == 1);
+    CPPUNIT_ASSERT(length[vdF] == 3);
+    CPPUNIT_ASSERT(successor[vdA] == vdB);
+    CPPUNIT_ASSERT(successor[vdE] == vdE);
+    CPPUNIT_ASSERT(cs::critical_path(length, successor, std::ostream_iterator<vertex_descriptor>(out, " ")) == 4);
+    CPPUNIT_ASSERT(out.str() == "0 1 3 4 ");
+    edDF = add_edge(vdD, vdF, g).first;
+  }
+
+  // a vertex costs one more than its index
+  void test_longest_paths2 () {
+    std::vector<double>            cost;
+    std::vector<double>            length;
+    std::vector<double>            parallel_length;
+    std::vector<vertex_descriptor> successor;
+    std::vector<vertex_descriptor> parallel_successor;
+    std::ostringstream             out;
+    for (std::size_t v = 0; v != num_vertices(g); ++v)
+      cost.push_back(v + 1.0);
+    CPPUNIT_ASSERT(!cs::parallel_longest_paths(g, length, successor, &cost));
+    remove_edge(vdD, vdF, g);
+    cs::longest_paths(g, length, successor, &cost);
+    CPPUNIT_ASSERT(cs::parallel_longest_paths(g, parallel_length, parallel_successor, &cost));
+    CPPUNIT_ASSERT(length == parallel_length);
+    CPPUNIT_ASSERT(successor == parallel_successor);
+    CPPUNIT_ASSERT(length[vdA] == 13);
+    CPPUNIT_ASSERT(successor[vdA] == vdC);
+    CPPUNIT_ASSERT(cs::critical_path(length, successor, std::ostream_iterator<vertex_descriptor>(out, " ")) == 15);
+    CPPUNIT_ASSERT(out.str() == "5 3 4 ");
+    edDF = add_edge(vdD, vdF, g).first;
+  }
+
+  void test_longest_paths3 () {
+    std::vector<std::size_t>       length;
+    std::vector<vertex_descriptor> successor;
+    std::vector<vertex_descriptor> path;
+    remove_edge(vdD, vdF, g);
+    add_chain(300000);
+    CPPUNIT_ASSERT(cs::parallel_longest_paths(g, length, successor));
+    CPPUNIT_ASSERT(cs::critical_path(length, successor, std::back_inserter(path)) == 300000);
+    CPPUNIT_ASSERT(path.size() == 300000);
+    CPPUNIT_ASSERT(path.front() == vertex(8, g));
+    CPPUNIT_ASSERT(path.back() == vertex(num_vertices(g) - 1, g));
+  }
+
+  // ----------------------------------
+  // test_strongly_connected_components
+  // ----------------------------------
+
+  void test_strongly_connected_components1 () {
+    typedef typename graph_type::edge_iterator edgeit;
+    std::vector<std::size_t> c;
+    CPPUNIT_ASSERT(cs::strongly_connected_components(g, c) == 7);
+    CPPUNIT_ASSERT(c.size() == 8);
+    CPPUNIT_ASSERT(c[vdD] == c[vdF]);
+    CPPUNIT_ASSERT(c[vdD] != c[vdE]);
+    std::pair<edgeit, edgeit> p = edges(g);
+    for (; p.first != p.second; ++p.first)
+      CPPUNIT_ASSERT(c[source(*p.first, g)] >= c[target(*p.first, g)]);
+  }
+
+  void test_strongly_connected_components2 () {
+    std::vector<std::size_t> c;
+    add_chain(300000);
+    add_edge(vertex(num_vertices(g) - 1, g), vertex(8, g), g);
+    CPPUNIT_ASSERT(cs::strongly_connected_components(g, c) == 8);
+    CPPUNIT_ASSERT(c[8] == c[num_vertices(g) - 1]);
+    CPPUNIT_ASSERT(c[8] != c[vdA]);
+  }
+
+  void test_parallel_strongly_connected_components1 () {
+    std::vector<std::size_t> c;
+    CPPUNIT_ASSERT(cs::parallel_strongly_connected_components(g, c) == 7);
+    CPPUNIT_ASSERT(c[vdA] == 0);
+    CPPUNIT_ASSERT(c[vdC] == 2);
+    CPPUNIT_ASSERT(c[vdD] == 3);
+    CPPUNIT_ASSERT(c[vdF] == 3);
+    CPPUNIT_ASSERT(c[vdG] == 5);
+    CPPUNIT_ASSERT(c[vdH] == 6);
+  }
+
+  // a ring, so no vertex of it can be trimmed, tied into two more cycles
+  void test_parallel_strongly_connected_components2 () {
+    std::vector<std::size_t> c;
+    std::vector<std::size_t> d;
+    add_chain(300000);
+    const vertex_descriptor last = vertex(num_vertices(g) - 1, g);
+    add_edge(last, vertex(8, g), g);
+    add_edge(vertex(1000, g), vdA, g);
+    add_edge(vdE, vdB, g);
+    CPPUNIT_ASSERT(cs::parallel_strongly_connected_components(g, c) == 6);
+    CPPUNIT_ASSERT(cs::strongly_connected_components(g, d) == 6);
+    for (std::size_t i = 0; i != c.size(); ++i)
+      for (std::size_t j = 0; j != 10; ++j)
+	CPPUNIT_ASSERT((c[i] == c[j]) == (d[i] == d[j]));
+    CPPUNIT_ASSERT(c[vdB] == c[vdE]);
+    CPPUNIT_ASSERT(c[vdE] == c[vdF]);
+    CPPUNIT_ASSERT(c[vdB] != c[vdA]);
+    CPPUNIT_ASSERT(c[last] == c[8]);
+  }
+
+  // -----------------
+  // test_condensation
+  // -----------------
+
+  void test_condensation () {
+    std::vector<std::size_t> c;
+    cs::Graph                dag;
+    const std::size_t        k = cs::strongly_connected_components(g, c);
+    cs::condensation(g, c, k, dag);
+    CPPUNIT_ASSERT(num_vertices(dag) == 7);
+    CPPUNIT_ASSERT(num_edges(dag) == 9);
+    CPPUNIT_ASSERT(edge(c[vdF], c[vdH], dag).second);
+    CPPUNIT_ASSERT(edge(c[vdC], c[vdD], dag).second);
+    CPPUNIT_ASSERT(!cs::has_cycle(dag));
+    std::vector<cs::Graph::vertex_descriptor> order;
+    cs::topological_sort(dag, std::back_inserter(order));
+    CPPUNIT_ASSERT(order.size() == 7);
+  }
+
+  // -----------
+  // test_to_csr
+  // -----------
+
+  void test_to_csr1 () {
+    cs::CsrGraph c = cs::to_csr(g);
+    CPPUNIT_ASSERT(num_vertices(c) == 8);
+    CPPUNIT_ASSERT(num_edges(c)    == 11);
+    CPPUNIT_ASSERT(edge(vdF, vdD, c).second);
+    CPPUNIT_ASSERT(!edge(vdD, vdG, c).second);
+    cs::CsrGraph::adjacency_iterator b = adjacent_vertices(vdA, c).first;
+    cs::CsrGraph::adjacency_iterator e = adjacent_vertices(vdA, c).second;
+    CPPUNIT_ASSERT(std::distance(b, e) == 3);
+    CPPUNIT_ASSERT(*b == vdB);
+    CPPUNIT_ASSERT(*(e - 1) == vdE);
+    CPPUNIT_ASSERT(out_degree(vdF, c) == 2);
+  }
+
+  void test_to_csr2 () {
+    cs::CsrGraph c = cs::to_csr(g);
+    std::pair<cs::CsrGraph::edge_iterator, cs::CsrGraph::edge_iterator> p = edges(c);
+    CPPUNIT_ASSERT(std::distance(p.first, p.second) == 11);
+    CPPUNIT_ASSERT(*p.first == cs::CsrGraph::edge_descriptor(vdA, vdB));
+    CPPUNIT_ASSERT(cs::has_cycle(c));
+  }
+
+  void test_to_csr3 () {
+    std::ostringstream out;
+    remove_edge(vdD, vdF, g);
+    cs::CsrGraph c = cs::to_csr(g);
+    edDF = add_edge(vdD, vdF, g).first;
+    CPPUNIT_ASSERT(num_edges(c) == 10);
+    CPPUNIT_ASSERT(!cs::has_cycle(c));
+    cs::topological_sort(c, std::ostream_iterator<cs::CsrGraph::vertex_descriptor>(out, " "));
+    CPPUNIT_ASSERT(out.str() == "4 3 1 2 0 7 5 6 ");
+  }
+
+  // -----------------
+  // test_mapped_graph
+  // -----------------
+
+  void test_mapped_graph1 () {
+    CPPUNIT_ASSERT(cs::write_graph(g, "TestGraph.bin", true));
+    cs::MappedGraph m("TestGraph.bin", true);
+    CPPUNIT_ASSERT(m.is_open());
+    CPPUNIT_ASSERT(num_vertices(m) == 8);
+    CPPUNIT_ASSERT(num_edges(m)    == 11);
+    CPPUNIT_ASSERT(edge(vdF, vdD, m).second);
+    CPPUNIT_ASSERT(!edge(vdD, vdG, m).second);
+    std::pair<cs::MappedGraph::edge_iterator, cs::MappedGraph::edge_iterator> p = edges(m);
+    CPPUNIT_ASSERT(std::distance(p.first, p.second) == 11);
+    CPPUNIT_ASSERT(cs::has_cycle(m));
+    std::remove("TestGraph.bin");
+  }
+
+  void test_mapped_graph2 () {
+    std::ostringstream out;
+    remove_edge(vdD, vdF, g);
+    CPPUNIT_ASSERT(cs::write_graph(g, "TestGraph.bin", false));
+    edDF = add_edge(vdD, vdF, g).first;
+    cs::MappedGraph m;
+    CPPUNIT_ASSERT(m.open("TestGraph.bin", true));
+    CPPUNIT_ASSERT(!cs::has_cycle(m));
+    cs::topological_sort(m, std::ostream_iterator<cs::MappedGraph::vertex_descriptor>(out, " "));
+    CPPUNIT_ASSERT(out.str() == "4 3 1 2 0 7 5 6 ");
+    std::remove("TestGraph.bin");
+  }
+
+  void test_mapped_graph3 () {
+    CPPUNIT_ASSERT(cs::write_graph(g, "TestGraph.bin", true));
+    {
+      std::FILE* f = std::fopen("TestGraph.bin", "r+b");
+      std::fseek(f, -1, SEEK_END);
+      std::fputc(6, f);
+      std::fclose(f);
+    }
+    cs::MappedGraph m;
+    CPPUNIT_ASSERT(m.open("TestGraph.bin", false));
+    CPPUNIT_ASSERT(!m.open("TestGraph.bin", true));
+    CPPUNIT_ASSERT(!m.is_open());
+    CPPUNIT_ASSERT(num_vertices(m) == 0);
+    CPPUNIT_ASSERT(!m.open("TestGraph.missing", false));
+    std::remove("TestGraph.bin");
+  }
+
+  void test_mapped_graph4 () {
+    CPPUNIT_ASSERT(cs::write_graph(g, "TestGraph.bin", false));
+    {
+      // the row of vdA, B C E, after the header and 9 offsets, as C B E
+      const uint32_t row[2] = {2, 1};
+      std::FILE*     f      = std::fopen("TestGraph.bin", "r+b");
+      std::fseek(f, 40 + 8 * 9, SEEK_SET);
+      std::fwrite(row, sizeof(uint32_t), 2, f);
+      std::fclose(f);
+    }
+    cs::MappedGraph m;
+    CPPUNIT_ASSERT(m.open("TestGraph.bin", false));
+    CPPUNIT_ASSERT(out_degree(vdA, m) == 3);
+    CPPUNIT_ASSERT(!m.open("TestGraph.bin", true));
+    CPPUNIT_ASSERT(!m.is_open());
+    std::remove("TestGraph.bin");
+  }
+
+  // -------------------
+  // test_read_edge_list
+  // -------------------
+
+  void write_file (const char* path, const char* text) {
+    std::FILE* f = std::fopen(path, "w");
+    std::fputs(text, f);
+    std::fclose(f);
+  }
+
+  void test_read_edge_list1 () {
+    write_file("TestGraph.txt",
+	       "# Directed graph\n# FromNodeId\tToNodeId\n"
+	       "7\t0\n"
+	       "  0 1   \n"
+	       "\n"
+	       "% another comment\r\n"
+	       "4 6 1.5\r\n"
+	       "8\t9");
+    CPPUNIT_ASSERT(cs::read_edge_list("TestGraph.txt", g));
+    CPPUNIT_ASSERT(num_vertices(g) == 10);
+    CPPUNIT_ASSERT(num_edges(g)    == 14);
+    CPPUNIT_ASSERT(edge(vdH, vdA, g).second);
+    CPPUNIT_ASSERT(edge(vdE, vdG, g).second);
+    CPPUNIT_ASSERT(edge(8, 9, g).second);
+    std::remove("TestGraph.txt");
+  }
+
+  void test_read_edge_list2 () {
+    write_file("TestGraph.txt", "7 0\n100 6\n4 6\n6 100\n");
+    CPPUNIT_ASSERT(cs::read_edge_list("TestGraph.txt", g, 3));
+    CPPUNIT_ASSERT(num_vertices(g) == 101);
+    CPPUNIT_ASSERT(num_edges(g)    == 15);
+    CPPUNIT_ASSERT(edge(100, vdG, g).second);
+    CPPUNIT_ASSERT(edge(vdG, 100, g).second);
+    std::remove("TestGraph.txt");
+  }
+
+  void test_read_edge_list3 () {
+    write_file("TestGraph.txt", "7 0\n4 x\n");
+    CPPUNIT_ASSERT(!cs::read_edge_list("TestGraph.txt", g));
+    write_file("TestGraph.txt", "7 0\n4 6x\n");
+    CPPUNIT_ASSERT(!cs::read_edge_list("TestGraph.txt", g));
+    CPPUNIT_ASSERT(!cs::read_edge_list("TestGraph.missing", g));
+    std::remove("TestGraph.txt");
+  }
+
+  void test_read_edge_list4 () {
+    write_file("TestGraph.txt", "7 0\n18446744073709551617 0\n");
+    CPPUNIT_ASSERT(!cs::read_edge_list("TestGraph.txt", g));
+    write_file("TestGraph.txt", "7 0\n0 99999999999999999999999\n");
+    CPPUNIT_ASSERT(!cs::read_edge_list("TestGraph.txt", g));
+    CPPUNIT_ASSERT(num_vertices(g) == 8);
+    CPPUNIT_ASSERT(num_edges(g)    == 11);
+    std::remove("TestGraph.txt");
+  }
+
+  void test_read_edge_list5 () {
+    // one past the largest vertex_descriptor, which overflows an unsigned
+    // long when the vertex_descriptor is as wide
+    const unsigned long largest = std::numeric_limits<vertex_descriptor>::max();
+    std::ostringstream  out;
+    if (largest < std::numeric_limits<unsigned long>::max())
+      out << (largest + 1) << " 2\n";
+    else
+      out << "18446744073709551616 2\n";
+    write_file("TestGraph.txt", out.str().c_str());
+    CPPUNIT_ASSERT(!cs::read_edge_list("TestGraph.txt", g));
+    CPPUNIT_ASSERT(num_vertices(g) == 8);
+    CPPUNIT_ASSERT(num_edges(g)    == 11);
+    std::remove("TestGraph.txt");
+  }
+
+  void test_read_edge_list6 () {
+    // the largest vertex_descriptor itself, n = largest + 1 would wrap
+    std::ostringstream out;
+    out << static_cast<unsigned long>(std::numeric_limits<vertex_descriptor>::max()) << " 0\n";
+    write_file("TestGraph.txt", out.str().c_str());
+    CPPUNIT_ASSERT(!cs::read_edge_list("TestGraph.txt", g));
+    CPPUNIT_ASSERT(num_vertices(g) == 8);
+    CPPUNIT_ASSERT(num_edges(g)    == 11);
+    std::remove("TestGraph.txt");
+  }
+
   // -----
   // suite
   // -----
@@ -458,6 +974,9 @@ struct TestGraph : CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(TestGraph);
   CPPUNIT_TEST(test_add_edge1);
   CPPUNIT_TEST(test_add_edge2);
+  CPPUNIT_TEST(test_add_edge3);
+  CPPUNIT_TEST(test_add_edges);
+  CPPUNIT_TEST(test_add_edges2);
   CPPUNIT_TEST(test_vertex1);
   CPPUNIT_TEST(test_vertex2);
   CPPUNIT_TEST(test_vertex3);
@@ -478,8 +997,10 @@ struct TestGraph : CppUnit::TestFixture {
   CPPUNIT_TEST(test_edge10);
   CPPUNIT_TEST(test_edge11);
   CPPUNIT_TEST(test_edge12);
+  CPPUNIT_TEST(test_out_degree);
   CPPUNIT_TEST(test_num_vertices);
   CPPUNIT_TEST(test_num_edges);
+  CPPUNIT_TEST(test_num_edges2);
   CPPUNIT_TEST(test_source1);
   CPPUNIT_TEST(test_source2);
   CPPUNIT_TEST(test_source3);
@@ -504,10 +1025,38 @@ struct TestGraph : CppUnit::TestFixture {
   CPPUNIT_TEST(test_target11);
   CPPUNIT_TEST(test_vertices);
   CPPUNIT_TEST(test_edges);
+  CPPUNIT_TEST(test_edges2);
+  CPPUNIT_TEST(test_parallel_for_each_edge);
   CPPUNIT_TEST(test_adjacent_vertices);
   CPPUNIT_TEST(test_has_cycle1);
   CPPUNIT_TEST(test_has_cycle2);
+  CPPUNIT_TEST(test_has_cycle3);
   CPPUNIT_TEST(test_topological_sort);
+  CPPUNIT_TEST(test_topological_sort2);
+  CPPUNIT_TEST(test_parallel_topological_sort1);
+  CPPUNIT_TEST(test_parallel_topological_sort2);
+  CPPUNIT_TEST(test_parallel_topological_sort3);
+  CPPUNIT_TEST(test_longest_paths1);
+  CPPUNIT_TEST(test_longest_paths2);
+  CPPUNIT_TEST(test_longest_paths3);
+  CPPUNIT_TEST(test_strongly_connected_components1);
+  CPPUNIT_TEST(test_strongly_connected_components2);
+  CPPUNIT_TEST(test_parallel_strongly_connected_components1);
+  CPPUNIT_TEST(test_parallel_strongly_connected_components2);
+  CPPUNIT_TEST(test_condensation);
+  CPPUNIT_TEST(test_to_csr1);
+  CPPUNIT_TEST(test_to_csr2);
+  CPPUNIT_TEST(test_to_csr3);
+  CPPUNIT_TEST(test_mapped_graph1);
+  CPPUNIT_TEST(test_mapped_graph2);
+  CPPUNIT_TEST(test_mapped_graph3);
+  CPPUNIT_TEST(test_mapped_graph4);
+  CPPUNIT_TEST(test_read_edge_list1);
+  CPPUNIT_TEST(test_read_edge_list2);
+  CPPUNIT_TEST(test_read_edge_list3);
+  CPPUNIT_TEST(test_read_edge_list4);
+  CPPUNIT_TEST(test_read_edge_list5);
+  CPPUNIT_TEST(test_read_edge_list6);
   CPPUNIT_TEST_SUITE_END();
 };
 
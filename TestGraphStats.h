@@ -0,0 +1,175 @@
+// -----------------------------------
+// projects/c++/graph/TestGraphStats.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// -----------------------------------
+
+#ifndef TestGraphStats_h
+#define TestGraphStats_h
+
+// --------
+// includes
+// --------
+
+#include <iterator> // back_inserter
+#include <sstream>  // ostringstream
+#include <string>   // string
+#include <utility>  // make_pair, pair
+#include <vector>   // vector
+
+#include "cppunit/TestFixture.h"             // TestFixture
+#include "cppunit/extensions/HelperMacros.h" // CPPUNIT_TEST, CPPUNIT_TEST_SUITE, CPPUNIT_TEST_SUITE
+
+#include "Graph.h"
+#include "GraphAlgorithms.h"
+#include "GraphStats.h"
+
+// --------------
+// TestGraphStats
+// --------------
+
+/**
+ * built either way: with CS_GRAPH_STATS the counts must be exact,
+ * without it they must stay zero
+ */
+struct TestGraphStats : CppUnit::TestFixture {
+  // --------
+  // typedefs
+  // --------
+
+  typedef cs::Graph                     graph_type;
+  typedef graph_type::vertex_descriptor vertex_descriptor;
+
+  // n if the stats are compiled in, 0 otherwise
+  static unsigned long expected (unsigned long n) {
+    return cs::stats::enabled ? n : 0;
+  }
+
+  // the chain 0 -> 1 -> ... -> n - 1
+  static void chain (graph_type& g, vertex_descriptor n) {
+    for (vertex_descriptor v = 0; v != n; ++v)
+      add_vertex(g);
+    for (vertex_descriptor v = 1; v != n; ++v)
+      add_edge(v - 1, v, g);
+  }
+
+  // -----
+  // setUp
+  // -----
+
+  void setUp () {
+    cs::stats::reset();
+  }
+
+  // -------------------
+  // test_graph_counters
+  // -------------------
+
+  void test_graph_counters () {
+    graph_type g;
+    const vertex_descriptor a = add_vertex(g);
+    const vertex_descriptor b = add_vertex(g);
+    add_edge(a, b, g);
+    add_edge(a, b, g);
+    add_edge(b, a, g);
+    remove_edge(b, a, g);
+    remove_edge(b, a, g);
+    edge(a, b, g);
+    std::vector< std::pair<vertex_descriptor, vertex_descriptor> > es;
+    es.push_back(std::make_pair(a, b));
+    es.push_back(std::make_pair(b, a));
+    es.push_back(std::make_pair(b, a));
+    add_edges(es.begin(), es.end(), g);
+    const cs::stats::Counters& c = cs::stats::counters();
+    CPPUNIT_ASSERT(c.add_vertex      == expected(2));
+    CPPUNIT_ASSERT(c.add_edge        == expected(6));
+    CPPUNIT_ASSERT(c.duplicate_edges == expected(3));
+    CPPUNIT_ASSERT(c.remove_edge     == expected(2));
+    CPPUNIT_ASSERT(c.missing_edges   == expected(1));
+    CPPUNIT_ASSERT(c.edge_lookups    == expected(1));
+    CPPUNIT_ASSERT(cs::stats::phase("add_edges").calls == expected(1));
+    cs::stats::reset();
+    CPPUNIT_ASSERT(cs::stats::counters().add_edge == 0);
+  }
+
+  // -----------------------
+  // test_algorithm_counters
+  // -----------------------
+
+  // a chain is one path, as deep as it is long
+  void test_algorithm_counters () {
+    graph_type g;
+    chain(g, 1000);
+    cs::stats::reset();
+    CPPUNIT_ASSERT(!cs::has_cycle(g));
+    const cs::stats::Counters& c = cs::stats::counters();
+    CPPUNIT_ASSERT(c.algorithm_calls  == expected(1));
+    CPPUNIT_ASSERT(c.vertices_visited == expected(1000));
+    CPPUNIT_ASSERT(c.edges_examined   == expected(999));
+    CPPUNIT_ASSERT(c.max_depth        == expected(1000));
+    std::vector<vertex_descriptor> x;
+    cs::topological_sort(g, std::back_inserter(x));
+    CPPUNIT_ASSERT(c.algorithm_calls  == expected(2));
+    CPPUNIT_ASSERT(c.vertices_visited == expected(2000));
+    CPPUNIT_ASSERT(cs::stats::phase("topological_sort").calls == expected(1));
+    CPPUNIT_ASSERT(cs::stats::phase("has_cycle").seconds >= 0);
+    CPPUNIT_ASSERT(cs::stats::phase("never").calls == 0);
+  }
+
+  // 2000 sources into one sink, a level wide enough to run in parallel
+  void test_parallel_counters () {
+    graph_type h;
+    for (vertex_descriptor v = 0; v != 2001; ++v)
+      add_vertex(h);
+    for (vertex_descriptor v = 0; v != 2000; ++v)
+      add_edge(v, 2000, h);
+    cs::stats::reset();
+    std::vector<vertex_descriptor> x;
+    CPPUNIT_ASSERT(cs::parallel_topological_sort(h, std::back_inserter(x)));
+    const cs::stats::Counters& c = cs::stats::counters();
+    CPPUNIT_ASSERT(c.algorithm_calls  == expected(1));
+    CPPUNIT_ASSERT(c.vertices_visited == expected(2001));
+    CPPUNIT_ASSERT(c.edges_examined   == expected(2000));
+  }
+
+  // ----------
+  // test_trace
+  // ----------
+
+  void test_trace () {
+    graph_type g;
+    chain(g, 100);
+    cs::stats::trace(true);
+    std::vector<vertex_descriptor> x;
+    CPPUNIT_ASSERT(cs::parallel_topological_sort(g, std::back_inserter(x)));
+    cs::stats::trace(false);
+    CPPUNIT_ASSERT(cs::stats::counters().vertices_visited == expected(100));
+    CPPUNIT_ASSERT(cs::stats::counters().edges_examined   == expected(99));
+    CPPUNIT_ASSERT(cs::has_cycle(g) == false);
+    CPPUNIT_ASSERT(cs::stats::phase("parallel_topological_sort.levels").calls == expected(1));
+    std::ostringstream out;
+    cs::stats::write_trace(out);
+    const std::string s = out.str();
+    CPPUNIT_ASSERT(s.find("{\"traceEvents\": [") == 0);
+    CPPUNIT_ASSERT((s.find("\"name\": \"parallel_topological_sort.indegree\"") != std::string::npos) ==
+		   cs::stats::enabled);
+    CPPUNIT_ASSERT((s.find("\"ph\": \"X\"") != std::string::npos) == cs::stats::enabled);
+    CPPUNIT_ASSERT(s.find("\"name\": \"has_cycle\", \"cat\"") == std::string::npos);
+    std::ostringstream stats;
+    cs::stats::write_stats(stats);
+    CPPUNIT_ASSERT(stats.str().find(cs::stats::enabled ? "\"enabled\": true" : "\"enabled\": false") == 1);
+  }
+
+  // -----
+  // suite
+  // -----
+
+  CPPUNIT_TEST_SUITE(TestGraphStats);
+  CPPUNIT_TEST(test_graph_counters);
+  CPPUNIT_TEST(test_algorithm_counters);
+  CPPUNIT_TEST(test_parallel_counters);
+  CPPUNIT_TEST(test_trace);
+  CPPUNIT_TEST_SUITE_END();
+};
+
+#endif // TestGraphStats_h
@@ -0,0 +1,147 @@
+// ------------------------------------------
+// projects/c++/graph/TestReachabilityIndex.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// ------------------------------------------
+
+#ifndef TestReachabilityIndex_h
+#define TestReachabilityIndex_h
+
+// --------
+// includes
+// --------
+
+#include <cstddef>   // size_t
+#include <utility>   // pair
+#include <vector>    // vector
+
+#include "cppunit/TestFixture.h"             // TestFixture
+#include "cppunit/extensions/HelperMacros.h" // CPPUNIT_TEST, CPPUNIT_TEST_SUITE, CPPUNIT_TEST_SUITE
+
+#include "Benchmark.h"
+#include "Graph.h"
+#include "ReachabilityIndex.h"
+
+// ---------------------
+// TestReachabilityIndex
+// ---------------------
+
+struct TestReachabilityIndex : CppUnit::TestFixture {
+  // --------
+  // typedefs
+  // --------
+
+  typedef cs::Graph                     graph_type;
+  typedef graph_type::vertex_descriptor vertex_descriptor;
+  typedef graph_type::adjacency_iterator adjacency_iterator;
+
+  // the vertices reachable from u, by breadth-first search
+  static std::vector<bool> closure (const graph_type& g, vertex_descriptor u) {
+    std::vector<bool>              seen(num_vertices(g), false);
+    std::vector<vertex_descriptor> queue(1, u);
+    seen[u] = true;
+    for (std::size_t i = 0; i != queue.size(); ++i) {
+      std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(queue[i], g);
+      for (; p.first != p.second; ++p.first)
+	if (!seen[*p.first]) {
+	  seen[*p.first] = true;
+	  queue.push_back(*p.first);
+	}
+    }
+    return seen;
+  }
+
+  // every pair from the first k sources against closure
+  static bool agrees (const graph_type& g, const cs::ReachabilityIndex& r, vertex_descriptor k) {
+    for (vertex_descriptor u = 0; (u != k) && (u != num_vertices(g)); ++u) {
+      const std::vector<bool> c = closure(g, u);
+      for (vertex_descriptor v = 0; v != num_vertices(g); ++v)
+	if (reachable(u, v, r) != c[v])
+	  return false;
+    }
+    return true;
+  }
+
+  // ----------
+  // test_small
+  // ----------
+
+  // 0 -> {1 -> 2 -> 3 -> 1} -> 4, 5 -> 4, 6 alone
+  void test_small () {
+    graph_type g;
+    for (int i = 0; i != 7; ++i)
+      add_vertex(g);
+    add_edge(0, 1, g);
+    add_edge(1, 2, g);
+    add_edge(2, 3, g);
+    add_edge(3, 1, g);
+    add_edge(3, 4, g);
+    add_edge(5, 4, g);
+    const cs::ReachabilityIndex r(g);
+    CPPUNIT_ASSERT(num_vertices(r) == 7);
+    CPPUNIT_ASSERT(num_components(r) == 5);
+    CPPUNIT_ASSERT(reachable(0, 4, r));
+    CPPUNIT_ASSERT(reachable(3, 2, r));
+    CPPUNIT_ASSERT(reachable(6, 6, r));
+    CPPUNIT_ASSERT(!reachable(4, 0, r));
+    CPPUNIT_ASSERT(!reachable(5, 1, r));
+    CPPUNIT_ASSERT(!reachable(0, 6, r));
+    CPPUNIT_ASSERT(agrees(g, r, 7));
+    CPPUNIT_ASSERT(num_vertices(cs::ReachabilityIndex(graph_type())) == 0);
+  }
+
+  // ----------
+  // test_chain
+  // ----------
+
+  // 100000 levels, more than any search could afford per query
+  void test_chain () {
+    graph_type g;
+    const vertex_descriptor n = 100000;
+    for (vertex_descriptor v = 0; v != n; ++v)
+      add_vertex(g);
+    for (vertex_descriptor v = 1; v != n; ++v)
+      add_edge(v - 1, v, g);
+    const cs::ReachabilityIndex r(g);
+    CPPUNIT_ASSERT(num_components(r) == n);
+    for (vertex_descriptor v = 0; v < n; v += 997) {
+      CPPUNIT_ASSERT(reachable(0, v, r));
+      CPPUNIT_ASSERT(reachable(v, n - 1, r));
+      CPPUNIT_ASSERT(reachable(v, 1, r) == (v <= 1));
+    }
+    CPPUNIT_ASSERT(memory_use(r) < n * 100);
+  }
+
+  // -----------
+  // test_random
+  // -----------
+
+  // from sparse (mostly unreachable, so the searches run) to dense,
+  // with and without cycles, all with far more than 64 components
+  void test_random () {
+    const std::size_t m[] = {300, 700, 1500, 4000};
+    for (std::size_t i = 0; i != sizeof(m) / sizeof(m[0]); ++i)
+      for (int acyclic = 0; acyclic != 2; ++acyclic) {
+	const cs::bench::edge_list  es = cs::bench::erdos_renyi(600, m[i], acyclic != 0, 2463534242u + i);
+	const graph_type            g(600, es.begin(), es.end());
+	const cs::ReachabilityIndex r(g);
+	CPPUNIT_ASSERT(agrees(g, r, 600));
+      }
+    const cs::bench::edge_list  es = cs::bench::erdos_renyi(20000, 30000, true, 88172645u);
+    const graph_type            g(20000, es.begin(), es.end());
+    const cs::ReachabilityIndex r(g);
+    CPPUNIT_ASSERT(agrees(g, r, 40));
+  }
+
+  // -----
+  // suite
+  // -----
+
+  CPPUNIT_TEST_SUITE(TestReachabilityIndex);
+  CPPUNIT_TEST(test_small);
+  CPPUNIT_TEST(test_chain);
+  CPPUNIT_TEST(test_random);
+  CPPUNIT_TEST_SUITE_END();
+};
+
+#endif // TestReachabilityIndex_h
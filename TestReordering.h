@@ -0,0 +1,210 @@
+// -----------------------------------
+// projects/c++/graph/TestReordering.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// -----------------------------------
+
+#ifndef TestReordering_h
+#define TestReordering_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // max
+#include <cstddef>   // size_t
+#include <iterator>  // back_inserter
+#include <utility>   // pair
+#include <vector>    // vector
+
+#include "cppunit/TestFixture.h"             // TestFixture
+#include "cppunit/extensions/HelperMacros.h" // CPPUNIT_TEST, CPPUNIT_TEST_SUITE, CPPUNIT_TEST_SUITE
+
+#include "Graph.h"
+#include "GraphAlgorithms.h"
+#include "Reordering.h"
+#include "TestSampleGraph.h"
+
+// --------------
+// TestReordering
+// --------------
+
+struct TestReordering : CppUnit::TestFixture {
+  // --------
+  // typedefs
+  // --------
+
+  typedef cs::Graph                         graph_type;
+
+  typedef graph_type::vertex_descriptor     vertex_descriptor;
+  typedef graph_type::edge_iterator         edge_iterator;
+
+  // -----
+  // tests
+  // -----
+
+  graph_type g;
+
+  vertex_descriptor vdA;
+  vertex_descriptor vdB;
+  vertex_descriptor vdC;
+  vertex_descriptor vdD;
+  vertex_descriptor vdE;
+  vertex_descriptor vdF;
+  vertex_descriptor vdG;
+  vertex_descriptor vdH;
+
+  // -----
+  // setUp
+  // -----
+
+  // the graph of TestGraph
+  void setUp () {
+    build_sample_graph(g, vdA, vdB, vdC, vdD, vdE, vdF, vdG, vdH);
+  }
+
+  // the original vertices of r in their new order
+  static std::vector<std::size_t> order (const cs::Relabeling& r) {
+    std::vector<std::size_t> x;
+    for (std::size_t i = 0; i != num_vertices(r); ++i)
+      x.push_back(old_vertex(i, r));
+    return x;
+  }
+
+  // an order written out as a vector
+  static std::vector<std::size_t> make (const std::size_t* a, std::size_t n) {
+    return std::vector<std::size_t>(a, a + n);
+  }
+
+  // the largest |new u - new v| over the edges u -> v
+  static std::size_t bandwidth (const graph_type& h) {
+    std::size_t w = 0;
+    std::pair<edge_iterator, edge_iterator> p = edges(h);
+    for (edge_iterator b = p.first; b != p.second; ++b) {
+      const std::size_t u = source(*b, h);
+      const std::size_t v = target(*b, h);
+      w = std::max(w, (u < v) ? v - u : u - v);
+    }
+    return w;
+  }
+
+  // ---------------
+  // test_relabeling
+  // ---------------
+
+  void test_relabeling () {
+    const std::size_t a[] = {2, 0, 3, 1};
+    const cs::Relabeling r(make(a, 4));
+    CPPUNIT_ASSERT(num_vertices(r) == 4);
+    CPPUNIT_ASSERT(old_vertex(0, r) == 2);
+    CPPUNIT_ASSERT(new_vertex(2, r) == 0);
+    for (std::size_t v = 0; v != 4; ++v)
+      CPPUNIT_ASSERT(old_vertex(new_vertex(v, r), r) == v);
+    CPPUNIT_ASSERT(num_vertices(cs::Relabeling()) == 0);
+  }
+
+  // --------------------
+  // test_degree_ordering
+  // --------------------
+
+  // total degrees A 3, B 3, C 2, D 5, E 3, F 3, G 1, H 2
+  void test_degree_ordering () {
+    const std::size_t a[] = {3, 0, 1, 4, 5, 2, 7, 6};
+    CPPUNIT_ASSERT(order(cs::degree_ordering(g)) == make(a, 8));
+  }
+
+  // -------------------------
+  // test_bfs_and_dfs_ordering
+  // -------------------------
+
+  void test_bfs_and_dfs_ordering () {
+    const std::size_t a[] = {0, 1, 2, 4, 3, 5, 7, 6};
+    CPPUNIT_ASSERT(order(cs::bfs_ordering(g)) == make(a, 8));
+    const std::size_t b[] = {0, 1, 3, 4, 5, 7, 2, 6};
+    CPPUNIT_ASSERT(order(cs::dfs_ordering(g)) == make(b, 8));
+    graph_type h;
+    CPPUNIT_ASSERT(num_vertices(cs::bfs_ordering(h)) == 0);
+  }
+
+  // -----------------
+  // test_rcm_ordering
+  // -----------------
+
+  // a path with scrambled names, and a star next to it, are numbered
+  // back into a band: the path of width 1, the star of width 3 (its
+  // centre goes second, right after one leaf)
+  void test_rcm_ordering () {
+    const std::size_t path[] = {3, 7, 1, 9, 0, 5, 8, 2, 6, 4};
+    graph_type h;
+    for (std::size_t i = 0; i != 15; ++i)
+      add_vertex(h);
+    for (std::size_t i = 0; i != 9; ++i)
+      add_edge(path[i + 1], path[i], h);
+    for (std::size_t i = 10; i != 14; ++i)
+      add_edge(14, i, h);
+    CPPUNIT_ASSERT(bandwidth(h) == 9);
+    const cs::Relabeling r = cs::rcm_ordering(h);
+    graph_type k;
+    cs::relabel(h, r, k);
+    CPPUNIT_ASSERT(num_edges(k) == 13);
+    CPPUNIT_ASSERT(bandwidth(k) == 3);
+    for (std::size_t i = 0; i != 9; ++i) {
+      const std::size_t u = new_vertex(path[i], r);
+      const std::size_t v = new_vertex(path[i + 1], r);
+      CPPUNIT_ASSERT((u < v) ? (v - u == 1) : (u - v == 1));
+    }
+  }
+
+  // ------------
+  // test_relabel
+  // ------------
+
+  // the algorithms answer the same on a relabeled graph, once their
+  // results are translated back
+  void test_relabel () {
+    const cs::Relabeling r = cs::rcm_ordering(g);
+    graph_type h;
+    cs::relabel(g, r, h);
+    CPPUNIT_ASSERT(num_vertices(h) == 8);
+    CPPUNIT_ASSERT(num_edges(h) == 11);
+    std::pair<edge_iterator, edge_iterator> p = edges(g);
+    for (edge_iterator b = p.first; b != p.second; ++b)
+      CPPUNIT_ASSERT(edge(new_vertex(source(*b, g), r), new_vertex(target(*b, g), r), h).second);
+
+    std::vector<std::size_t> c;
+    std::vector<std::size_t> d;
+    CPPUNIT_ASSERT(cs::strongly_connected_components(g, c) == 7);
+    CPPUNIT_ASSERT(cs::strongly_connected_components(h, d) == 7);
+    cs::original_order(r, d);
+    for (vertex_descriptor u = 0; u != 8; ++u)
+      for (vertex_descriptor v = 0; v != 8; ++v)
+	CPPUNIT_ASSERT((c[u] == c[v]) == (d[u] == d[v]));
+
+    remove_edge(vdF, vdD, g);
+    remove_edge(new_vertex(vdF, r), new_vertex(vdD, r), h);
+    CPPUNIT_ASSERT(!cs::has_cycle(h));
+    std::vector<vertex_descriptor> x;
+    cs::topological_sort(h, cs::original_vertices(r, std::back_inserter(x)));
+    CPPUNIT_ASSERT(x.size() == 8);
+    std::vector<std::size_t> written(8);
+    for (std::size_t i = 0; i != 8; ++i)
+      written[x[i]] = i;
+    p = edges(g);
+    for (edge_iterator b = p.first; b != p.second; ++b)
+      CPPUNIT_ASSERT(written[target(*b, g)] < written[source(*b, g)]);
+  }
+
+  // -----
+  // suite
+  // -----
+
+  CPPUNIT_TEST_SUITE(TestReordering);
+  CPPUNIT_TEST(test_relabeling);
+  CPPUNIT_TEST(test_degree_ordering);
+  CPPUNIT_TEST(test_bfs_and_dfs_ordering);
+  CPPUNIT_TEST(test_rcm_ordering);
+  CPPUNIT_TEST(test_relabel);
+  CPPUNIT_TEST_SUITE_END();
+};
+
+#endif // TestReordering_h
@@ -0,0 +1,99 @@
+// ------------------------------------
+// projects/c++/graph/TestSampleGraph.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// ------------------------------------
+
+#ifndef TestSampleGraph_h
+#define TestSampleGraph_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // equal
+#include <cstddef>   // size_t
+#include <iterator>  // back_inserter
+#include <utility>   // pair
+#include <vector>    // vector
+
+#include "Graph.h"
+#include "GraphAlgorithms.h"
+
+// ----------------
+// build_sample_dag
+// ----------------
+
+/**
+ * the graph of TestGraph without the edge (F, D): vertices A to H and
+ * the edges A -> B, C, E; B -> D, E; C -> D; D -> E, F; F -> H; G -> H
+ */
+template <typename G, typename V>
+void build_sample_dag (G& g, V& vdA, V& vdB, V& vdC, V& vdD, V& vdE, V& vdF, V& vdG, V& vdH) {
+  vdA = add_vertex(g);
+  vdB = add_vertex(g);
+  vdC = add_vertex(g);
+  vdD = add_vertex(g);
+  vdE = add_vertex(g);
+  vdF = add_vertex(g);
+  vdG = add_vertex(g);
+  vdH = add_vertex(g);
+  add_edge(vdA, vdB, g);
+  add_edge(vdA, vdC, g);
+  add_edge(vdA, vdE, g);
+  add_edge(vdB, vdD, g);
+  add_edge(vdB, vdE, g);
+  add_edge(vdC, vdD, g);
+  add_edge(vdD, vdE, g);
+  add_edge(vdD, vdF, g);
+  add_edge(vdF, vdH, g);
+  add_edge(vdG, vdH, g);
+}
+
+// ------------------
+// build_sample_graph
+// ------------------
+
+/**
+ * the graph of TestGraph: the sample DAG plus F -> D, 11 edges and the
+ * one cycle D -> F -> D, 7 strongly connected components
+ */
+template <typename G, typename V>
+void build_sample_graph (G& g, V& vdA, V& vdB, V& vdC, V& vdD, V& vdE, V& vdF, V& vdG, V& vdH) {
+  build_sample_dag(g, vdA, vdB, vdC, vdD, vdE, vdF, vdG, vdH);
+  add_edge(vdF, vdD, g);
+}
+
+// -----------------
+// agrees_with_graph
+// -----------------
+
+/**
+ * the templates of GraphAlgorithms.h give g the same answers as a
+ * cs::Graph with the same edges: has_cycle, the number of strongly
+ * connected components and, if acyclic, the topological order
+ */
+template <typename G>
+bool agrees_with_graph (const G& g) {
+  typedef typename G::edge_iterator edge_iterator;
+  cs::Graph h;
+  for (std::size_t v = 0; v != num_vertices(g); ++v)
+    add_vertex(h);
+  std::pair<edge_iterator, edge_iterator> p = edges(g);
+  for (; p.first != p.second; ++p.first)
+    add_edge(source(*p.first, g), target(*p.first, g), h);
+  std::vector<std::size_t> c;
+  std::vector<std::size_t> d;
+  if ((cs::has_cycle(g) != cs::has_cycle(h)) ||
+      (cs::strongly_connected_components(g, c) != cs::strongly_connected_components(h, d)))
+    return false;
+  if (cs::has_cycle(h))
+    return true;
+  std::vector<typename G::vertex_descriptor> x;
+  std::vector<cs::Graph::vertex_descriptor>  y;
+  cs::topological_sort(g, std::back_inserter(x));
+  cs::topological_sort(h, std::back_inserter(y));
+  return (x.size() == y.size()) && std::equal(x.begin(), x.end(), y.begin());
+}
+
+#endif // TestSampleGraph_h
@@ -0,0 +1,161 @@
+// -----------------------------------------
+// projects/c++/graph/TestTopologicalOrder.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// -----------------------------------------
+
+#ifndef TestTopologicalOrder_h
+#define TestTopologicalOrder_h
+
+// --------
+// includes
+// --------
+
+#include <cstddef>   // size_t
+#include <utility>   // pair
+#include <vector>    // vector
+
+#include "cppunit/TestFixture.h"             // TestFixture
+#include "cppunit/extensions/HelperMacros.h" // CPPUNIT_TEST, CPPUNIT_TEST_SUITE, CPPUNIT_TEST_SUITE
+
+#include "Benchmark.h"
+#include "BidirectionalGraph.h"
+#include "Graph.h"
+#include "GraphAlgorithms.h"
+#include "TopologicalOrder.h"
+
+// --------------------
+// TestTopologicalOrder
+// --------------------
+
+struct TestTopologicalOrder : CppUnit::TestFixture {
+  // --------
+  // typedefs
+  // --------
+
+  typedef cs::BidirectionalGraph        graph_type;
+  typedef graph_type::vertex_descriptor vertex_descriptor;
+
+  // drains o, marking each vertex done at once
+  // true if every edge goes from an earlier vertex to a later one
+  template <typename G>
+  static bool drains (const G& g, cs::TopologicalOrder<G>& o) {
+    typedef typename G::edge_iterator edge_iterator;
+    std::vector<std::size_t> position(num_vertices(g), num_vertices(g));
+    std::size_t              k = 0;
+    vertex_descriptor        v;
+    while (o.next(v)) {
+      if (position[v] != num_vertices(g))
+	return false;
+      position[v] = k++;
+      o.done(v);
+    }
+    if (!o.finished() || (o.pending() != 0) || (k != num_vertices(g)))
+      return false;
+    std::pair<edge_iterator, edge_iterator> p = edges(g);
+    for (; p.first != p.second; ++p.first)
+      if (position[source(*p.first, g)] >= position[target(*p.first, g)])
+	return false;
+    return true;
+  }
+
+  // -----------
+  // test_lazily
+  // -----------
+
+  // 0 -> 2, 1 -> 2, 2 -> 3, 4 alone
+  void test_lazily () {
+    graph_type g;
+    for (int i = 0; i != 5; ++i)
+      add_vertex(g);
+    add_edge(0, 2, g);
+    add_edge(1, 2, g);
+    add_edge(2, 3, g);
+    cs::TopologicalOrder<graph_type> o(g);
+    vertex_descriptor v;
+    CPPUNIT_ASSERT(o.next(v) && (v == 0));
+    CPPUNIT_ASSERT(o.next(v) && (v == 1));
+    CPPUNIT_ASSERT(o.next(v) && (v == 4));
+    CPPUNIT_ASSERT(!o.next(v));
+    CPPUNIT_ASSERT(o.pending() == 3);
+    o.done(1);
+    CPPUNIT_ASSERT(!o.next(v));
+    o.done(0);
+    CPPUNIT_ASSERT(o.next(v) && (v == 2));
+    CPPUNIT_ASSERT(!o.next(v));
+    o.done(2);
+    o.done(4);
+    CPPUNIT_ASSERT(!o.finished());
+    CPPUNIT_ASSERT(o.next(v) && (v == 3));
+    o.done(3);
+    CPPUNIT_ASSERT(!o.next(v));
+    CPPUNIT_ASSERT(o.finished());
+    CPPUNIT_ASSERT(o.pending() == 0);
+  }
+
+  // -----------
+  // test_random
+  // -----------
+
+  void test_random () {
+    const cs::bench::edge_list es = cs::bench::erdos_renyi(2000, 8000, true, 2463534242u);
+    const graph_type           g(2000, es.begin(), es.end());
+    cs::TopologicalOrder<graph_type> o(g);
+    CPPUNIT_ASSERT(drains(g, o));
+  }
+
+  // -----------
+  // test_counted
+  // -----------
+
+  // a graph without in edges, with the counts of in_degrees
+  void test_counted () {
+    const cs::bench::edge_list es = cs::bench::erdos_renyi(2000, 8000, true, 88172645u);
+    const cs::Graph            g(2000, es.begin(), es.end());
+    std::vector<unsigned int> indegree;
+    cs::in_degrees(g, indegree);
+    cs::TopologicalOrder<cs::Graph> o(g, indegree);
+    CPPUNIT_ASSERT(drains(g, o));
+    const cs::Graph empty;
+    cs::in_degrees(empty, indegree);
+    cs::TopologicalOrder<cs::Graph> p(empty, indegree);
+    vertex_descriptor v;
+    CPPUNIT_ASSERT(!p.next(v));
+    CPPUNIT_ASSERT(p.finished());
+  }
+
+  // ----------
+  // test_cycle
+  // ----------
+
+  // 0 -> 1 -> 2 -> 1, 2 -> 3: only 0 is ever ready
+  void test_cycle () {
+    graph_type g;
+    for (int i = 0; i != 4; ++i)
+      add_vertex(g);
+    add_edge(0, 1, g);
+    add_edge(1, 2, g);
+    add_edge(2, 1, g);
+    add_edge(2, 3, g);
+    cs::TopologicalOrder<graph_type> o(g);
+    vertex_descriptor v;
+    CPPUNIT_ASSERT(o.next(v) && (v == 0));
+    o.done(0);
+    CPPUNIT_ASSERT(!o.next(v));
+    CPPUNIT_ASSERT(o.pending() == 0);
+    CPPUNIT_ASSERT(!o.finished());
+  }
+
+  // -----
+  // suite
+  // -----
+
+  CPPUNIT_TEST_SUITE(TestTopologicalOrder);
+  CPPUNIT_TEST(test_lazily);
+  CPPUNIT_TEST(test_random);
+  CPPUNIT_TEST(test_counted);
+  CPPUNIT_TEST(test_cycle);
+  CPPUNIT_TEST_SUITE_END();
+};
+
+#endif // TestTopologicalOrder_h
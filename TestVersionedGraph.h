@@ -0,0 +1,193 @@
+// ---------------------------------------
+// projects/c++/graph/TestVersionedGraph.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// ---------------------------------------
+
+#ifndef TestVersionedGraph_h
+#define TestVersionedGraph_h
+
+// --------
+// includes
+// --------
+
+#include <cstddef>  // ptrdiff_t, size_t
+#include <iterator> // distance
+#include <utility>  // pair
+#include <vector>   // vector
+
+#include "cppunit/TestFixture.h"             // TestFixture
+#include "cppunit/extensions/HelperMacros.h" // CPPUNIT_TEST, CPPUNIT_TEST_SUITE, CPPUNIT_TEST_SUITE
+
+#include "GraphAlgorithms.h"
+#include "TestSampleGraph.h"
+#include "VersionedGraph.h"
+
+// ------------------
+// TestVersionedGraph
+// ------------------
+
+struct TestVersionedGraph : CppUnit::TestFixture {
+  // --------
+  // typedefs
+  // --------
+
+  typedef cs::VersionedGraph                graph_type;
+
+  typedef graph_type::vertex_descriptor     vertex_descriptor;
+  typedef cs::Snapshot::edge_iterator       edge_iterator;
+
+  // -----
+  // tests
+  // -----
+
+  graph_type g;
+
+  vertex_descriptor vdA;
+  vertex_descriptor vdB;
+  vertex_descriptor vdC;
+  vertex_descriptor vdD;
+  vertex_descriptor vdE;
+  vertex_descriptor vdF;
+  vertex_descriptor vdG;
+  vertex_descriptor vdH;
+
+  // -----
+  // setUp
+  // -----
+
+  // the graph of TestGraph
+  void setUp () {
+    build_sample_graph(g, vdA, vdB, vdC, vdD, vdE, vdF, vdG, vdH);
+  }
+
+  // the edges of a snapshot, counted one by one
+  static std::ptrdiff_t count (const cs::Snapshot& s) {
+    std::pair<edge_iterator, edge_iterator> p = edges(s);
+    return std::distance(p.first, p.second);
+  }
+
+  // -------------
+  // test_snapshot
+  // -------------
+
+  void test_snapshot1 () {
+    const cs::Snapshot s = snapshot(g);
+    CPPUNIT_ASSERT(num_vertices(s) == 8);
+    CPPUNIT_ASSERT(num_edges(s) == 11);
+    CPPUNIT_ASSERT(count(s) == 11);
+    CPPUNIT_ASSERT(out_degree(vdA, s) == 3);
+    CPPUNIT_ASSERT(edge(vdF, vdD, s).second);
+    CPPUNIT_ASSERT(!edge(vdD, vdA, s).second);
+  }
+
+  // later writes do not show through
+  void test_snapshot2 () {
+    const cs::Snapshot s = snapshot(g);
+    remove_edge(vdF, vdD, g);
+    add_edge(vdH, vdA, g);
+    const vertex_descriptor v = add_vertex(g);
+    add_edge(v, vdA, g);
+    CPPUNIT_ASSERT(num_edges(g) == 12);
+    CPPUNIT_ASSERT(num_vertices(s) == 8);
+    CPPUNIT_ASSERT(count(s) == 11);
+    CPPUNIT_ASSERT(edge(vdF, vdD, s).second);
+    CPPUNIT_ASSERT(!edge(vdH, vdA, s).second);
+    const cs::Snapshot t = snapshot(g);
+    CPPUNIT_ASSERT(version(t) > version(s));
+    CPPUNIT_ASSERT(num_vertices(t) == 9);
+    CPPUNIT_ASSERT(count(t) == 12);
+    CPPUNIT_ASSERT(!edge(vdF, vdD, t).second);
+    CPPUNIT_ASSERT(edge(v, vdA, t).second);
+  }
+
+  // ---------------
+  // test_algorithms
+  // ---------------
+
+  void test_algorithms () {
+    const cs::Snapshot s = snapshot(g);
+    remove_edge(vdF, vdD, g);
+    const cs::Snapshot t = snapshot(g);
+    CPPUNIT_ASSERT(cs::has_cycle(s));
+    CPPUNIT_ASSERT(!cs::has_cycle(t));
+    std::vector<std::size_t> c;
+    CPPUNIT_ASSERT(cs::strongly_connected_components(s, c) == 7);
+    CPPUNIT_ASSERT(agrees_with_graph(s));
+    CPPUNIT_ASSERT(agrees_with_graph(t));
+  }
+
+  // ----------------
+  // test_reclamation
+  // ----------------
+
+  void test_reclamation () {
+    add_edge(vdH, vdA, g);
+    CPPUNIT_ASSERT(retained(g) == 0);
+    {
+      cs::Snapshot s = snapshot(g);
+      add_edge(vdH, vdB, g);
+      add_edge(vdH, vdC, g);
+      CPPUNIT_ASSERT(retained(g) == 3);
+      {
+	cs::Snapshot t = s;
+	s = snapshot(g);
+	add_edge(vdG, vdA, g);
+	CPPUNIT_ASSERT(retained(g) == 6);
+	CPPUNIT_ASSERT(out_degree(vdH, t) == 1);
+      }
+      CPPUNIT_ASSERT(retained(g) == 3);
+      CPPUNIT_ASSERT(out_degree(vdH, s) == 3);
+    }
+    CPPUNIT_ASSERT(retained(g) == 0);
+    add_edge(vdG, vdB, g);
+    CPPUNIT_ASSERT(retained(g) == 0);
+  }
+
+  // ---------------
+  // test_concurrent
+  // ---------------
+
+  // a writer grows a chain while a reader keeps taking snapshots, each
+  // of which must be a whole prefix of the chain
+  void test_concurrent () {
+    const vertex_descriptor n = 20000;
+    graph_type              h;
+    for (vertex_descriptor v = 0; v != n; ++v)
+      add_vertex(h);
+    bool consistent = true;
+    #pragma omp parallel sections num_threads(2)
+    {
+      #pragma omp section
+      for (vertex_descriptor v = 1; v != n; ++v)
+	add_edge(v - 1, v, h);
+
+      #pragma omp section
+      for (int i = 0; i != 50; ++i) {
+	const cs::Snapshot s = snapshot(h);
+	const std::size_t  m = num_edges(s);
+	if ((count(s) != static_cast<std::ptrdiff_t>(m)) ||
+	    ((m != 0) && !edge(vertex_descriptor(m - 1), vertex_descriptor(m), s).second) ||
+	    ((m + 1 < n) && edge(vertex_descriptor(m), vertex_descriptor(m + 1), s).second))
+	  consistent = false;
+      }
+    }
+    CPPUNIT_ASSERT(consistent);
+    CPPUNIT_ASSERT(num_edges(h) == n - 1);
+    CPPUNIT_ASSERT(retained(h) == 0);
+  }
+
+  // -----
+  // suite
+  // -----
+
+  CPPUNIT_TEST_SUITE(TestVersionedGraph);
+  CPPUNIT_TEST(test_snapshot1);
+  CPPUNIT_TEST(test_snapshot2);
+  CPPUNIT_TEST(test_algorithms);
+  CPPUNIT_TEST(test_reclamation);
+  CPPUNIT_TEST(test_concurrent);
+  CPPUNIT_TEST_SUITE_END();
+};
+
+#endif // TestVersionedGraph_h
@@ -0,0 +1,240 @@
+// --------------------------------------
+// projects/c++/graph/TestWeightedGraph.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// --------------------------------------
+
+#ifndef TestWeightedGraph_h
+#define TestWeightedGraph_h
+
+// --------
+// includes
+// --------
+
+#include <cstddef>  // size_t
+#include <limits>   // numeric_limits
+#include <utility>  // make_pair, pair
+#include <vector>   // vector
+
+#include "boost/graph/adjacency_list.hpp"          // adjacency_list, property
+#include "boost/graph/dijkstra_shortest_paths.hpp" // dijkstra_shortest_paths
+
+#include "cppunit/TestFixture.h"             // TestFixture
+#include "cppunit/extensions/HelperMacros.h" // CPPUNIT_TEST, CPPUNIT_TEST_SUITE, CPPUNIT_TEST_SUITE
+
+#include "GraphAlgorithms.h"
+#include "ShortestPaths.h"
+#include "WeightedGraph.h"
+
+// -----------------
+// TestWeightedGraph
+// -----------------
+
+/**
+ * the free functions of the graph itself are in TestGraph<cs::WeightedGraph>
+ */
+struct TestWeightedGraph : CppUnit::TestFixture {
+  // --------
+  // typedefs
+  // --------
+
+  typedef cs::WeightedGraph             graph_type;
+  typedef graph_type::vertex_descriptor vertex_descriptor;
+  typedef graph_type::edge_descriptor   edge_descriptor;
+  typedef graph_type::arc_iterator      arc_iterator;
+
+  typedef std::vector<unsigned long>     distances;
+  typedef std::vector<vertex_descriptor> predecessors;
+
+  // -----
+  // tests
+  // -----
+
+  graph_type g;
+
+  // -----
+  // setUp
+  // -----
+
+  // CLRS, 3rd, pg. 659, s = 0, t = 1, x = 2, y = 3, z = 4, plus an
+  // unreachable 5 that reaches 0
+  void setUp () {
+    for (int i = 0; i != 6; ++i)
+      add_vertex(g);
+    add_edge(0, 1, 10, g);
+    add_edge(0, 3,  5, g);
+    add_edge(1, 2,  1, g);
+    add_edge(1, 3,  2, g);
+    add_edge(2, 4,  4, g);
+    add_edge(3, 1,  3, g);
+    add_edge(3, 2,  9, g);
+    add_edge(3, 4,  2, g);
+    add_edge(4, 0,  7, g);
+    add_edge(4, 2,  6, g);
+    add_edge(5, 0,  1, g);
+  }
+
+  // the tree of predecessors is made of shortest edges
+  static bool consistent (const graph_type& h, vertex_descriptor s,
+			  const distances& d, const predecessors& p) {
+    for (vertex_descriptor v = 0; v != num_vertices(h); ++v) {
+      if ((v == s) || (d[v] == std::numeric_limits<unsigned long>::max())) {
+	if (p[v] != v)
+	  return false;
+	continue;
+      }
+      if (!edge(p[v], v, h).second || (d[p[v]] + weight(edge_descriptor(p[v], v), h) != d[v]))
+	return false;
+    }
+    return true;
+  }
+
+  // ------------
+  // test_weights
+  // ------------
+
+  void test_weights () {
+    CPPUNIT_ASSERT(num_edges(g) == 11);
+    CPPUNIT_ASSERT(weight(edge_descriptor(3, 2), g) == 9);
+    CPPUNIT_ASSERT(!add_edge(3, 2, 1, g).second);
+    CPPUNIT_ASSERT(weight(edge_descriptor(3, 2), g) == 9);
+    weight(edge_descriptor(3, 2), g) = 1;
+    CPPUNIT_ASSERT(weight(edge_descriptor(3, 2), static_cast<const graph_type&>(g)) == 1);
+    std::pair<arc_iterator, arc_iterator> p = out_arcs(3, g);
+    CPPUNIT_ASSERT(p.second - p.first == 3);
+    CPPUNIT_ASSERT((p.first[0].target == 1) && (p.first[0].weight == 3));
+    CPPUNIT_ASSERT((p.first[1].target == 2) && (p.first[1].weight == 1));
+    CPPUNIT_ASSERT((p.first[2].target == 4) && (p.first[2].weight == 2));
+    remove_edge(3, 2, g);
+    CPPUNIT_ASSERT(out_degree(3, g) == 2);
+    CPPUNIT_ASSERT(add_edge(3, 2, g).second);
+    CPPUNIT_ASSERT(weight(edge_descriptor(3, 2), g) == 1);
+    CPPUNIT_ASSERT(cs::has_cycle(g));
+  }
+
+  // ---------------------
+  // test_edge_constructor
+  // ---------------------
+
+  void test_edge_constructor () {
+    std::vector< std::pair<vertex_descriptor, vertex_descriptor> > es;
+    std::vector<unsigned int>                                      ws;
+    es.push_back(std::make_pair(2, 0)); ws.push_back(4);
+    es.push_back(std::make_pair(0, 1)); ws.push_back(7);
+    es.push_back(std::make_pair(2, 0)); ws.push_back(1);
+    es.push_back(std::make_pair(0, 9)); ws.push_back(3);
+    const graph_type h(3, es.begin(), es.end(), ws.begin());
+    CPPUNIT_ASSERT(num_vertices(h) == 10);
+    CPPUNIT_ASSERT(num_edges(h) == 3);
+    CPPUNIT_ASSERT(weight(edge_descriptor(2, 0), h) == 4);
+    CPPUNIT_ASSERT(weight(edge_descriptor(0, 9), h) == 3);
+    CPPUNIT_ASSERT(*adjacent_vertices(0, h).first == 1);
+  }
+
+  // -------------
+  // test_dijkstra
+  // -------------
+
+  void test_dijkstra () {
+    const unsigned long inf = std::numeric_limits<unsigned long>::max();
+    const unsigned long a[] = {0, 8, 9, 5, 7, inf};
+    const distances     expected(a, a + 6);
+    distances    d;
+    predecessors p;
+    CPPUNIT_ASSERT(cs::dijkstra_shortest_paths(g, 0, d, p) == 5);
+    CPPUNIT_ASSERT(d == expected);
+    CPPUNIT_ASSERT(p[1] == 3);
+    CPPUNIT_ASSERT(p[2] == 1);
+    CPPUNIT_ASSERT(consistent(g, 0, d, p));
+    CPPUNIT_ASSERT(cs::radix_dijkstra_shortest_paths(g, 0, d, p) == 5);
+    CPPUNIT_ASSERT(d == expected);
+    CPPUNIT_ASSERT(consistent(g, 0, d, p));
+    for (unsigned long delta = 1; delta != 12; ++delta) {
+      CPPUNIT_ASSERT(cs::delta_stepping_shortest_paths(g, 0, delta, d, p) == 5);
+      CPPUNIT_ASSERT(d == expected);
+      CPPUNIT_ASSERT(consistent(g, 0, d, p));
+    }
+    CPPUNIT_ASSERT(cs::dijkstra_shortest_paths(g, 5, d, p) == 6);
+    CPPUNIT_ASSERT(d[2] == 10);
+  }
+
+  // -------------------
+  // test_double_weights
+  // -------------------
+
+  void test_double_weights () {
+    cs::BasicWeightedGraph<double> h;
+    for (int i = 0; i != 4; ++i)
+      add_vertex(h);
+    add_edge(0, 1, 0.5,  h);
+    add_edge(1, 2, 0.25, h);
+    add_edge(0, 2, 1.0,  h);
+    add_edge(2, 3, 0.0,  h);
+    std::vector<double>                                             d;
+    std::vector<cs::BasicWeightedGraph<double>::vertex_descriptor> p;
+    CPPUNIT_ASSERT(cs::dijkstra_shortest_paths(h, 0, d, p) == 4);
+    CPPUNIT_ASSERT((d[2] == 0.75) && (d[3] == 0.75) && (p[3] == 2));
+    CPPUNIT_ASSERT(cs::delta_stepping_shortest_paths(h, 0, 0.1, d, p) == 4);
+    CPPUNIT_ASSERT((d[2] == 0.75) && (d[3] == 0.75) && (p[2] == 1));
+  }
+
+  // ----------
+  // test_boost
+  // ----------
+
+  // a random graph with a wide range of weights, every algorithm against
+  // boost's dijkstra_shortest_paths on the adjacency_list of main.cpp
+  void test_boost () {
+    typedef boost::adjacency_list<boost::setS, boost::vecS, boost::directedS, boost::no_property,
+				  boost::property<boost::edge_weight_t, unsigned int> > boost_graph;
+    const vertex_descriptor n = 2000;
+    std::vector< std::pair<vertex_descriptor, vertex_descriptor> > es;
+    std::vector<unsigned int>                                      ws;
+    unsigned int x = 2463534242u;
+    for (int i = 0; i != 12000; ++i) {
+      x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+      const vertex_descriptor u = x % n;
+      x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+      const vertex_descriptor v = x % n;
+      x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+      es.push_back(std::make_pair(u, v));
+      ws.push_back((i % 5 == 0) ? x % 1000000 : x % 100);
+    }
+    const graph_type h(n, es.begin(), es.end(), ws.begin());
+    boost_graph      b(n);
+    for (std::size_t i = 0; i != es.size(); ++i)
+      add_edge(es[i].first, es[i].second, ws[i], b);
+    CPPUNIT_ASSERT(num_edges(h) == num_edges(b));
+    distances     expected(n);
+    std::vector<std::size_t> q(n);
+    boost::dijkstra_shortest_paths(b, 7, boost::predecessor_map(&q[0]).distance_map(&expected[0]));
+    distances    d;
+    predecessors p;
+    const std::size_t reached = cs::dijkstra_shortest_paths(h, 7, d, p);
+    CPPUNIT_ASSERT(reached > n / 2);
+    CPPUNIT_ASSERT(d == expected);
+    CPPUNIT_ASSERT(consistent(h, 7, d, p));
+    CPPUNIT_ASSERT(cs::radix_dijkstra_shortest_paths(h, 7, d, p) == reached);
+    CPPUNIT_ASSERT(d == expected);
+    CPPUNIT_ASSERT(consistent(h, 7, d, p));
+    CPPUNIT_ASSERT(cs::delta_stepping_shortest_paths(h, 7, d, p) == reached);
+    CPPUNIT_ASSERT(d == expected);
+    CPPUNIT_ASSERT(consistent(h, 7, d, p));
+    CPPUNIT_ASSERT(cs::delta_stepping_shortest_paths(h, 7, 1000000ul, d, p) == reached);
+    CPPUNIT_ASSERT(d == expected);
+  }
+
+  // -----
+  // suite
+  // -----
+
+  CPPUNIT_TEST_SUITE(TestWeightedGraph);
+  CPPUNIT_TEST(test_weights);
+  CPPUNIT_TEST(test_edge_constructor);
+  CPPUNIT_TEST(test_dijkstra);
+  CPPUNIT_TEST(test_double_weights);
+  CPPUNIT_TEST(test_boost);
+  CPPUNIT_TEST_SUITE_END();
+};
+
+#endif // TestWeightedGraph_h
@@ -0,0 +1,211 @@
+// -------------------------------------
+// projects/c++/graph/TopologicalOrder.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// -------------------------------------
+
+#ifndef TopologicalOrder_h
+#define TopologicalOrder_h
+
+// --------
+// includes
+// --------
+
+#include <cassert> // assert
+#include <cstddef> // size_t
+#include <utility> // pair
+#include <vector>  // vector
+
+// ----------
+// namespaces
+// ----------
+
+namespace cs {
+
+  // ----------------
+  // TopologicalOrder
+  // ----------------
+
+  /**
+   * Kahn's algorithm, one vertex at a time, for a scheduler that only
+   * wants the next few vertices it can run
+   * a vertex is ready once every vertex with an edge into it is done (the
+   * order of topological_sort read backwards); next() hands out a ready
+   * vertex, done(v) releases the children of v
+   * nothing is computed up front: the in-degree of a vertex is looked up
+   * the first time it is reached, by done() on a parent or by next()
+   * scanning forward for the next source, so the work is proportional to
+   * the vertices handed out, their out edges and the vertices skipped
+   * the graph must not change while the order is in use; start a new one
+   * after a change
+   *
+   * TopologicalOrder o(g);
+   * while (o.next(v)) {
+   *   run(v);
+   *   o.done(v);
+   * }
+   * if (!o.finished()) the rest of the graph is on or behind a cycle
+   */
+  template <typename G>
+  class TopologicalOrder {
+  public:
+    // --------
+    // typedefs
+    // --------
+
+    typedef typename G::vertex_descriptor  vertex_descriptor;
+    typedef typename G::adjacency_iterator adjacency_iterator;
+
+  private:
+    // ----
+    // data
+    // ----
+
+    typedef std::size_t (*degree_function) (vertex_descriptor, const G&);
+
+    static const unsigned int untouched = 0;
+    static const unsigned int handed    = static_cast<unsigned int>(-1);
+
+    const G*                       graph;
+    degree_function                degree;    // 0 when every count was given
+    std::vector<unsigned int>      remaining; // 1 + parents not yet done, or untouched, or handed
+    std::vector<vertex_descriptor> released;  // ready, in the order they became ready
+    std::size_t                    head;      // the next of released to hand out
+    std::size_t                    scanned;   // the vertices before it were checked for a source
+    std::size_t                    out;       // handed out
+    std::size_t                    finished_count;
+
+    /**
+     * the in-degree from the graph's own in edges
+     */
+    static std::size_t graph_in_degree (vertex_descriptor v, const G& myG) {
+      return in_degree(v, myG);
+    }
+
+    /**
+     * O(1): looks up the in-degree of v the first time it is asked for
+     */
+    unsigned int& count (vertex_descriptor v) {
+      unsigned int& r = remaining[v];
+      if (r == untouched)
+	r = static_cast<unsigned int>(degree(v, *graph)) + 1;
+      return r;
+    }
+
+    bool valid () const {
+      return (head <= released.size()) && (scanned <= remaining.size()) &&
+	(finished_count <= out) && (out <= remaining.size());
+    }
+
+  public:
+    // ------------
+    // constructors
+    // ------------
+
+    /**
+     * time: O(1), plus zeroing one counter per vertex
+     * for graphs with in_degree (BidirectionalGraph, AcyclicGraph)
+     */
+    explicit TopologicalOrder (const G& myG) :
+	graph(&myG), degree(&TopologicalOrder::graph_in_degree), remaining(num_vertices(myG)),
+	head(0), scanned(0), out(0), finished_count(0) {
+      assert(valid());
+    }
+
+    /**
+     * time: O(V)
+     * for graphs without in edges, with the counts of in_degrees
+     */
+    TopologicalOrder (const G& myG, const std::vector<unsigned int>& indegree) :
+	graph(&myG), degree(0), remaining(indegree.size()),
+	head(0), scanned(0), out(0), finished_count(0) {
+      assert(indegree.size() == num_vertices(myG));
+      for (std::size_t v = 0; v != indegree.size(); ++v)
+	remaining[v] = indegree[v] + 1;
+      assert(valid());
+    }
+
+    // Default copy, destructor, and copy assignment
+
+    // ----
+    // next
+    // ----
+
+    /**
+     * time: O(1) for a released vertex, otherwise O(the vertices skipped
+     * looking for the next source), O(V) over the life of the order
+     * hands out the vertex released first, or else the next source
+     * @return false if no vertex is ready until more are done (or ever)
+     */
+    bool next (vertex_descriptor& v) {
+      if (head != released.size()) {
+	v = released[head++];
+	if (head == released.size()) {
+	  released.clear();
+	  head = 0;
+	}
+      }
+      else {
+	while ((scanned != remaining.size()) && (count(static_cast<vertex_descriptor>(scanned)) != 1))
+	  ++scanned;
+	if (scanned == remaining.size())
+	  return false;
+	v = static_cast<vertex_descriptor>(scanned++);
+      }
+      remaining[v] = handed;
+      ++out;
+      assert(valid());
+      return true;
+    }
+
+    // ----
+    // done
+    // ----
+
+    /**
+     * time: O(out degree of v)
+     * releases every child of v whose parents are now all done
+     * Precondition: v was handed out by next() and is not done yet
+     */
+    void done (vertex_descriptor v) {
+      assert(remaining[v] == handed);
+      std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(v, *graph);
+      for (; p.first != p.second; ++p.first) {
+	const vertex_descriptor c = *p.first;
+	unsigned int&           r = count(c);
+	assert((r != handed) && (r > 1));
+	if (--r == 1)
+	  released.push_back(c);
+      }
+      ++finished_count;
+      assert(valid());
+    }
+
+    // -------
+    // pending
+    // -------
+
+    /**
+     * time: O(1)
+     * @return the vertices handed out and not yet done
+     */
+    std::size_t pending () const {
+      return out - finished_count;
+    }
+
+    // --------
+    // finished
+    // --------
+
+    /**
+     * time: O(1)
+     * @return true once every vertex is done
+     */
+    bool finished () const {
+      return finished_count == remaining.size();
+    }
+  };
+
+} // cs
+
+#endif // TopologicalOrder_h
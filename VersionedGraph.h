@@ -0,0 +1,625 @@
+// -----------------------------------
+// projects/c++/graph/VersionedGraph.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// -----------------------------------
+
+#ifndef VersionedGraph_h
+#define VersionedGraph_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // binary_search, fill, lower_bound, swap
+#include <cassert>   // assert
+#include <cstddef>   // ptrdiff_t, size_t
+#include <iterator>  // forward_iterator_tag, iterator
+#include <sched.h>   // sched_yield
+#include <set>       // multiset
+#include <utility>   // make_pair, pair
+#include <vector>    // vector
+
+#include "CsrGraph.h"
+
+// ----------
+// namespaces
+// ----------
+
+namespace cs {
+
+  class Snapshot;
+
+  // --------------
+  // VersionedGraph
+  // --------------
+
+  /**
+   * a directed graph whose readers work on snapshots while writers go on
+   * the state is a tree of three levels: a table of chunks, each chunk
+   * holding the rows of chunk_size vertices, each row the sorted targets
+   * of one vertex; every node is stamped with the version that built it
+   * snapshot() is O(log readers): it pins the current tree and bumps the
+   * version, after which a writer copies a node before changing it (a
+   * row, its chunk and the table, so O(d + chunk_size + V / chunk_size)
+   * for the first write to a vertex) and changes nodes of the new
+   * version in place; with no snapshot in between, writes cost O(d)
+   * replaced nodes are retired with the version that replaced them and
+   * freed once no snapshot older than that version is left (at once,
+   * when there are no snapshots)
+   * mutators and snapshot() serialize on a spin lock; reading a
+   * snapshot takes no lock at all
+   * every Snapshot must be destroyed before its graph
+   */
+  class VersionedGraph {
+  public:
+    // --------
+    // typedefs
+    // --------
+
+    typedef unsigned int vertex_descriptor;
+    typedef std::pair<vertex_descriptor, vertex_descriptor>
+    edge_descriptor;
+
+    typedef std::size_t vertices_size_type;
+    typedef std::size_t edges_size_type;
+    typedef std::size_t degree_size_type;
+    typedef std::size_t version_type;
+
+  private:
+    friend class Snapshot;
+
+    enum {chunk_size = 1024};
+
+    struct row {
+      version_type                   version;
+      std::vector<vertex_descriptor> targets; // sorted
+
+      explicit row (version_type version) : version(version) {}
+    };
+
+    struct chunk {
+      version_type version;
+      row*         rows[chunk_size];          // 0 for no targets
+
+      explicit chunk (version_type version) : version(version) {
+	std::fill(rows, rows + chunk_size, static_cast<row*>(0));
+      }
+    };
+
+    struct table {
+      version_type        version;
+      std::vector<chunk*> chunks;
+
+      explicit table (version_type version) : version(version) {}
+    };
+
+    /**
+     * what a snapshot pins, shared by its copies
+     */
+    struct view {
+      VersionedGraph*    owner;
+      const table*       t;
+      vertices_size_type n;
+      edges_size_type    ne;
+      version_type       version;
+      long               refs;
+    };
+
+    // ----
+    // data
+    // ----
+
+    table*                                         current;  // the writers' tree
+    version_type                                   building; // the version of new nodes
+    vertices_size_type                             n;
+    edges_size_type                                ne;
+    std::multiset<version_type>                    active;   // the versions of live snapshots
+    std::vector< std::pair<version_type, row*> >   old_rows;
+    std::vector< std::pair<version_type, chunk*> > old_chunks;
+    std::vector< std::pair<version_type, table*> > old_tables;
+    volatile int                                   busy;
+
+    void lock () {
+      for (int spins = 0; __sync_lock_test_and_set(&busy, 1); )
+	while (busy)
+	  if (++spins % 64 == 0)
+	    sched_yield();
+    }
+
+    void unlock () {
+      __sync_lock_release(&busy);
+    }
+
+    // ------
+    // retire
+    // ------
+
+    /**
+     * a node replaced while building is visible to the snapshots older
+     * than building, so it is freed at once if there are none
+     */
+    template <typename T>
+    void retire (T* p, std::vector< std::pair<version_type, T*> >& old) {
+      if (active.empty() || (*active.begin() >= building))
+	delete p;
+      else
+	old.push_back(std::make_pair(building, p));
+    }
+
+    template <typename T>
+    void collect (std::vector< std::pair<version_type, T*> >& old) {
+      std::size_t j = 0;
+      for (std::size_t i = 0; i != old.size(); ++i)
+	if (active.empty() || (*active.begin() >= old[i].first))
+	  delete old[i].second;
+	else
+	  old[j++] = old[i];
+      old.resize(j);
+    }
+
+    // --------
+    // writable
+    // --------
+
+    /**
+     * the row of x, copied first (with its chunk and the table) if a
+     * snapshot may see it
+     */
+    row& writable (vertex_descriptor x) {
+      if (current->version != building) {
+	table* t = new table(*current);
+	t->version = building;
+	retire(current, old_tables);
+	current = t;
+      }
+      chunk*& c = current->chunks[x / chunk_size];
+      if (c->version != building) {
+	chunk* d = new chunk(*c);
+	d->version = building;
+	retire(c, old_chunks);
+	c = d;
+      }
+      row*& r = c->rows[x % chunk_size];
+      if (r == 0)
+	r = new row(building);
+      else if (r->version != building) {
+	row* s = new row(*r);
+	s->version = building;
+	retire(r, old_rows);
+	r = s;
+      }
+      return *r;
+    }
+
+    const row* find (vertex_descriptor x) const {
+      return current->chunks[x / chunk_size]->rows[x % chunk_size];
+    }
+
+    // -------
+    // release
+    // -------
+
+    /**
+     * the last copy of a snapshot is gone
+     */
+    void release (view* v) {
+      lock();
+      active.erase(active.find(v->version));
+      collect(old_rows);
+      collect(old_chunks);
+      collect(old_tables);
+      unlock();
+      delete v;
+    }
+
+    // no copies, snapshots point back to their graph
+    VersionedGraph (const VersionedGraph&);
+    VersionedGraph& operator = (const VersionedGraph&);
+
+  public:
+    // -----------
+    // remove_edge
+    // -----------
+
+    /**
+     * time: O(d), plus the copies described above
+     * removing an edge that does not exist leaves the graph unchanged
+     */
+    friend void remove_edge
+    (vertex_descriptor u, vertex_descriptor v, VersionedGraph& myG) {
+      assert((u < myG.n) && (v < myG.n));
+      myG.lock();
+      const row* r = myG.find(u);
+      if (r && std::binary_search(r->targets.begin(), r->targets.end(), v)) {
+	std::vector<vertex_descriptor>& ts = myG.writable(u).targets;
+	ts.erase(std::lower_bound(ts.begin(), ts.end(), v));
+	--myG.ne;
+      }
+      myG.unlock();
+    }
+
+    // --------
+    // add_edge
+    // --------
+
+    /**
+     * time: O(d), plus the copies described above
+     * @return std::pair<edge_descriptor, bool>
+     * bool = false, if the edge already exist inside the graph
+     */
+    friend std::pair<edge_descriptor, bool>
+    add_edge (vertex_descriptor x, vertex_descriptor y, VersionedGraph& myG) {
+      assert((x < myG.n) && (y < myG.n));
+      myG.lock();
+      const row* r      = myG.find(x);
+      const bool exists = r && std::binary_search(r->targets.begin(), r->targets.end(), y);
+      if (!exists) {
+	std::vector<vertex_descriptor>& ts = myG.writable(x).targets;
+	ts.insert(std::lower_bound(ts.begin(), ts.end(), y), y);
+	++myG.ne;
+      }
+      myG.unlock();
+      return std::make_pair(edge_descriptor(x, y), !exists);
+    }
+
+    // ----------
+    // add_vertex
+    // ----------
+
+    /**
+     * time:O(1) amortized, plus a copy of the table after a snapshot
+     */
+    friend vertex_descriptor
+    add_vertex (VersionedGraph& myG) {
+      myG.lock();
+      if (myG.n % chunk_size == 0) {
+	if (myG.current->version != myG.building) {
+	  table* t = new table(*myG.current);
+	  t->version = myG.building;
+	  myG.retire(myG.current, myG.old_tables);
+	  myG.current = t;
+	}
+	myG.current->chunks.push_back(new chunk(myG.building));
+      }
+      const vertex_descriptor v = static_cast<vertex_descriptor>(myG.n++);
+      myG.unlock();
+      return v;
+    }
+
+    // ----
+    // edge
+    // ----
+
+    /**
+     * time:O(log d)
+     * the writers' view; readers should use a snapshot
+     */
+    friend std::pair<edge_descriptor, bool>
+    edge (vertex_descriptor x, vertex_descriptor y, VersionedGraph& myG) {
+      assert((x < myG.n) && (y < myG.n));
+      myG.lock();
+      const row* r = myG.find(x);
+      const bool b = r && std::binary_search(r->targets.begin(), r->targets.end(), y);
+      myG.unlock();
+      return std::make_pair(edge_descriptor(x, y), b);
+    }
+
+    // ---------
+    // num_edges
+    // ---------
+
+    friend edges_size_type
+    num_edges (const VersionedGraph& myG) {
+      return myG.ne;
+    }
+
+    // ------------
+    // num_vertices
+    // ------------
+
+    friend vertices_size_type
+    num_vertices (const VersionedGraph& myG) {
+      return myG.n;
+    }
+
+    // --------
+    // retained
+    // --------
+
+    /**
+     * @return the replaced nodes still kept for some snapshot
+     */
+    friend std::size_t
+    retained (const VersionedGraph& myG) {
+      return myG.old_rows.size() + myG.old_chunks.size() + myG.old_tables.size();
+    }
+
+    friend Snapshot snapshot (VersionedGraph& myG);
+
+    // ------------
+    // constructors
+    // ------------
+
+    VersionedGraph () : current(new table(0)), building(0), n(0), ne(0), busy(0) {}
+
+    ~VersionedGraph () {
+      assert(active.empty());
+      collect(old_rows);
+      collect(old_chunks);
+      collect(old_tables);
+      for (std::size_t i = 0; i != current->chunks.size(); ++i) {
+	for (std::size_t j = 0; j != chunk_size; ++j)
+	  delete current->chunks[i]->rows[j];
+	delete current->chunks[i];
+      }
+      delete current;
+    }
+  };
+
+  // --------
+  // Snapshot
+  // --------
+
+  /**
+   * an immutable view of a VersionedGraph at one version
+   * it exposes the read-only free functions of cs::Graph, so the
+   * templates in GraphAlgorithms.h run on it while writers change the
+   * graph; copies are cheap and share the view, which is released
+   * (and the nodes only it kept, reclaimed) with the last of them
+   */
+  class Snapshot {
+  public:
+    // --------
+    // typedefs
+    // --------
+
+    typedef VersionedGraph::vertex_descriptor  vertex_descriptor;
+    typedef VersionedGraph::edge_descriptor    edge_descriptor;
+    typedef VersionedGraph::vertices_size_type vertices_size_type;
+    typedef VersionedGraph::edges_size_type    edges_size_type;
+    typedef VersionedGraph::degree_size_type   degree_size_type;
+    typedef VersionedGraph::version_type       version_type;
+
+    typedef const vertex_descriptor* adjacency_iterator;
+
+    typedef CsrGraph::vertex_iterator vertex_iterator;
+
+  private:
+    typedef VersionedGraph::view view;
+    typedef VersionedGraph::row  row;
+
+    view* v;
+
+    std::pair<adjacency_iterator, adjacency_iterator> targets (vertex_descriptor x) const {
+      const row* r = v->t->chunks[x / VersionedGraph::chunk_size]->rows[x % VersionedGraph::chunk_size];
+      if ((r == 0) || r->targets.empty())
+	return std::make_pair(adjacency_iterator(0), adjacency_iterator(0));
+      return std::make_pair(&r->targets[0], &r->targets[0] + r->targets.size());
+    }
+
+  public:
+    // -------------
+    // edge_iterator
+    // -------------
+
+    /**
+     * the rows one after another, skipping the empty ones
+     */
+    class edge_iterator :
+      public std::iterator<std::forward_iterator_tag, edge_descriptor,
+			   std::ptrdiff_t, const edge_descriptor*, edge_descriptor> {
+    private:
+      const Snapshot*    s;
+      vertex_descriptor  u;
+      adjacency_iterator pos;
+      adjacency_iterator end;
+
+      void skip_exhausted () {
+	while ((pos == end) && (u != s->v->n)) {
+	  std::pair<adjacency_iterator, adjacency_iterator> p(0, 0);
+	  if (++u != s->v->n)
+	    p = s->targets(u);
+	  pos = p.first;
+	  end = p.second;
+	}
+      }
+    public:
+      edge_iterator (const Snapshot* s, vertex_descriptor u) : s(s), u(u), pos(0), end(0) {
+	if (u != s->v->n) {
+	  std::pair<adjacency_iterator, adjacency_iterator> p = s->targets(u);
+	  pos = p.first;
+	  end = p.second;
+	  skip_exhausted();
+	}
+      }
+
+      edge_iterator& operator ++ () {
+	++pos;
+	skip_exhausted();
+	return *this;
+      }
+
+      edge_iterator operator ++ (int) {
+	edge_iterator tmp(*this);
+	++(*this);
+	return tmp;
+      }
+
+      edge_descriptor operator * () const {
+	return edge_descriptor(u, *pos);
+      }
+
+      bool operator == (const edge_iterator& rhs) const {
+	return (u == rhs.u) && (pos == rhs.pos);
+      }
+
+      bool operator != (const edge_iterator& rhs) const {
+	return !(*this == rhs);
+      }
+    };
+
+    // -----------------
+    // adjacent_vertices
+    // -----------------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     * @return the sorted targets of x at the version of the snapshot
+     */
+    friend std::pair<adjacency_iterator, adjacency_iterator>
+    adjacent_vertices (vertex_descriptor x, const Snapshot& s) {
+      assert(x < s.v->n);
+      return s.targets(x);
+    }
+
+    // ----------
+    // out_degree
+    // ----------
+
+    friend degree_size_type
+    out_degree (vertex_descriptor x, const Snapshot& s) {
+      std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(x, s);
+      return p.second - p.first;
+    }
+
+    // ----
+    // edge
+    // ----
+
+    /**
+     * time:O(log d)
+     */
+    friend std::pair<edge_descriptor, bool>
+    edge (vertex_descriptor x, vertex_descriptor y, const Snapshot& s) {
+      std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(x, s);
+      return std::make_pair(edge_descriptor(x, y), std::binary_search(p.first, p.second, y));
+    }
+
+    // -----
+    // edges
+    // -----
+
+    friend std::pair<edge_iterator, edge_iterator>
+    edges (const Snapshot& s) {
+      const vertex_descriptor n = static_cast<vertex_descriptor>(s.v->n);
+      return std::make_pair(edge_iterator(&s, 0), edge_iterator(&s, n));
+    }
+
+    // ------
+    // vertex
+    // ------
+
+    friend vertex_descriptor
+    vertex (vertices_size_type n, const Snapshot& s) {
+      assert(n < s.v->n);
+      return static_cast<vertex_descriptor>(n);
+    }
+
+    // --------
+    // vertices
+    // --------
+
+    friend std::pair<vertex_iterator, vertex_iterator>
+    vertices (const Snapshot& s) {
+      return std::make_pair(vertex_iterator(0),
+			    vertex_iterator(static_cast<vertex_descriptor>(s.v->n)));
+    }
+
+    // ------
+    // source
+    // ------
+
+    friend vertex_descriptor
+    source (edge_descriptor x, const Snapshot& s) {
+      assert(x.first < s.v->n);
+      return x.first;
+    }
+
+    // ------
+    // target
+    // ------
+
+    friend vertex_descriptor
+    target (edge_descriptor x, const Snapshot& s) {
+      assert(x.second < s.v->n);
+      return x.second;
+    }
+
+    // ---------
+    // num_edges
+    // ---------
+
+    friend edges_size_type
+    num_edges (const Snapshot& s) {
+      return s.v->ne;
+    }
+
+    // ------------
+    // num_vertices
+    // ------------
+
+    friend vertices_size_type
+    num_vertices (const Snapshot& s) {
+      return s.v->n;
+    }
+
+    // -------
+    // version
+    // -------
+
+    friend version_type
+    version (const Snapshot& s) {
+      return s.v->version;
+    }
+
+    // ------------
+    // constructors
+    // ------------
+
+    explicit Snapshot (view* v) : v(v) {}
+
+    Snapshot (const Snapshot& that) : v(that.v) {
+      __sync_fetch_and_add(&v->refs, 1);
+    }
+
+    ~Snapshot () {
+      if (__sync_sub_and_fetch(&v->refs, 1) == 0)
+	v->owner->release(v);
+    }
+
+    Snapshot& operator = (const Snapshot& that) {
+      Snapshot tmp(that);
+      std::swap(v, tmp.v);
+      return *this;
+    }
+  };
+
+  // --------
+  // snapshot
+  // --------
+
+  /**
+   * time: O(log snapshots)
+   * space: O(1) now; later writes copy what they change
+   * @return the graph as it is now, unaffected by later writes
+   */
+  inline Snapshot snapshot (VersionedGraph& myG) {
+    VersionedGraph::view* v = new VersionedGraph::view;
+    myG.lock();
+    v->owner   = &myG;
+    v->t       = myG.current;
+    v->n       = myG.n;
+    v->ne      = myG.ne;
+    v->version = myG.building;
+    v->refs    = 1;
+    myG.active.insert(myG.building);
+    ++myG.building;
+    myG.unlock();
+    return Snapshot(v);
+  }
+
+} // cs
+
+#endif // VersionedGraph_h
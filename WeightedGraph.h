@@ -0,0 +1,527 @@
+// ----------------------------------
+// projects/c++/graph/WeightedGraph.h
+// Copyright (C) 2009
+// Glenn P. Downing
+// ----------------------------------
+
+#ifndef WeightedGraph_h
+#define WeightedGraph_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // lower_bound, max, stable_sort
+#include <cassert>   // assert
+#include <cstddef>   // ptrdiff_t, size_t
+#include <iterator>  // forward_iterator_tag, iterator
+#include <utility>   // make_pair, pair
+#include <vector>    // vector
+
+#include "CsrGraph.h"
+#include "GraphStats.h"
+
+// ----------
+// namespaces
+// ----------
+
+namespace cs {
+
+  namespace weighted {
+
+    // ---
+    // Arc
+    // ---
+
+    /**
+     * one out edge: the target and its weight, side by side, so a
+     * relaxation reads both from the same cache line
+     */
+    template <typename V, typename W>
+    struct Arc {
+      V target;
+      W weight;
+    };
+
+    template <typename V, typename W>
+    bool operator < (const Arc<V, W>& lhs, const Arc<V, W>& rhs) {
+      return lhs.target < rhs.target;
+    }
+
+    // -----------------
+    // AdjacencyIterator
+    // -----------------
+
+    /**
+     * the targets of a row of arcs, without the weights
+     */
+    template <typename V, typename W>
+    class AdjacencyIterator :
+      public std::iterator<std::forward_iterator_tag, V, std::ptrdiff_t, const V*, V> {
+    private:
+      const Arc<V, W>* p;
+
+    public:
+      explicit AdjacencyIterator (const Arc<V, W>* p = 0) : p(p) {}
+
+      AdjacencyIterator& operator ++ () {
+	++p;
+	return *this;
+      }
+
+      AdjacencyIterator operator ++ (int) {
+	AdjacencyIterator tmp(*this);
+	++p;
+	return tmp;
+      }
+
+      V operator * () const {
+	return p->target;
+      }
+
+      bool operator == (const AdjacencyIterator& rhs) const {
+	return p == rhs.p;
+      }
+
+      bool operator != (const AdjacencyIterator& rhs) const {
+	return p != rhs.p;
+      }
+    };
+
+  } // weighted
+
+  // ------------------
+  // BasicWeightedGraph
+  // ------------------
+
+  /**
+   * a directed graph with a weight of type W on every edge
+   * each vertex owns a vector of arcs sorted by target, the weight
+   * stored next to the target, so there is no side table keyed by
+   * edge to look up during a traversal (see ShortestPaths.h)
+   * it exposes the same free functions as cs::Graph, so the templates
+   * in GraphAlgorithms.h run on it unmodified; add_edge without a
+   * weight adds an edge of weight 1
+   */
+  template <typename W>
+  class BasicWeightedGraph {
+  public:
+    // --------
+    // typedefs
+    // --------
+
+    typedef unsigned int vertex_descriptor;
+    typedef std::pair<vertex_descriptor, vertex_descriptor>
+    edge_descriptor;
+
+    typedef W                                     weight_type;
+    typedef weighted::Arc<vertex_descriptor, W>   arc_type;
+    typedef const arc_type*                       arc_iterator;
+
+    typedef weighted::AdjacencyIterator<vertex_descriptor, W> adjacency_iterator;
+    typedef CsrGraph::vertex_iterator                         vertex_iterator;
+
+    typedef std::size_t vertices_size_type;
+    typedef std::size_t edges_size_type;
+    typedef std::size_t degree_size_type;
+
+  private:
+    typedef std::vector<arc_type> row_type;
+
+  public:
+    // -------------
+    // edge_iterator
+    // -------------
+
+    /**
+     * the rows one after another, skipping the empty ones
+     */
+    class edge_iterator :
+      public std::iterator<std::forward_iterator_tag, edge_descriptor,
+			   std::ptrdiff_t, const edge_descriptor*, edge_descriptor> {
+    private:
+      const BasicWeightedGraph* g;
+      vertex_descriptor         u;
+      std::size_t               i;
+
+      void skip_exhausted () {
+	while ((u != g->rows.size()) && (i == g->rows[u].size())) {
+	  ++u;
+	  i = 0;
+	}
+      }
+    public:
+      edge_iterator (const BasicWeightedGraph* g, vertex_descriptor u) : g(g), u(u), i(0) {
+	skip_exhausted();
+      }
+
+      edge_iterator& operator ++ () {
+	++i;
+	skip_exhausted();
+	return *this;
+      }
+
+      edge_iterator operator ++ (int) {
+	edge_iterator tmp(*this);
+	++(*this);
+	return tmp;
+      }
+
+      edge_descriptor operator * () const {
+	return edge_descriptor(u, g->rows[u][i].target);
+      }
+
+      bool operator == (const edge_iterator& rhs) const {
+	return (u == rhs.u) && (i == rhs.i);
+      }
+
+      bool operator != (const edge_iterator& rhs) const {
+	return !(*this == rhs);
+      }
+    };
+
+    // ----------
+    // add_vertex
+    // ----------
+
+    /**
+     * time:O(1) amortized
+     * space: O(1)
+     */
+    friend vertex_descriptor
+    add_vertex (BasicWeightedGraph& myG) {
+      CS_GRAPH_COUNT(add_vertex, 1);
+      myG.rows.push_back(row_type());
+      return static_cast<vertex_descriptor>(myG.rows.size() - 1);
+    }
+
+    // --------
+    // add_edge
+    // --------
+
+    /**
+     * time:O(out degree of x)
+     * space: O(1)
+     * vertices are added as needed to cover x and y, as in boost
+     * an edge that is already there keeps its weight, see weight()
+     * @return the edge and false if it was already there
+     */
+    friend std::pair<edge_descriptor, bool>
+    add_edge (vertex_descriptor x, vertex_descriptor y, const weight_type& w, BasicWeightedGraph& myG) {
+      if (std::max(x, y) >= myG.rows.size())
+	myG.rows.resize(std::size_t(std::max(x, y)) + 1);
+      row_type&                   row = myG.rows[x];
+      const arc_type              a   = {y, w};
+      typename row_type::iterator i   = std::lower_bound(row.begin(), row.end(), a);
+      const bool                  b   = (i == row.end()) || (i->target != y);
+      if (b) {
+	row.insert(i, a);
+	++myG.ne;
+      }
+      CS_GRAPH_COUNT(add_edge, 1);
+      CS_GRAPH_COUNT(duplicate_edges, !b);
+      return std::make_pair(edge_descriptor(x, y), b);
+    }
+
+    /**
+     * an edge of weight 1
+     */
+    friend std::pair<edge_descriptor, bool>
+    add_edge (vertex_descriptor x, vertex_descriptor y, BasicWeightedGraph& myG) {
+      return add_edge(x, y, weight_type(1), myG);
+    }
+
+    // -----------
+    // remove_edge
+    // -----------
+
+    /**
+     * time:O(out degree of x)
+     * space: O(1)
+     * removing an edge that does not exist leaves the graph unchanged
+     */
+    friend void
+    remove_edge (vertex_descriptor x, vertex_descriptor y, BasicWeightedGraph& myG) {
+      typename row_type::iterator i = myG.find(x, y);
+      const bool                  b = (i != myG.rows[x].end());
+      if (b) {
+	myG.rows[x].erase(i);
+	--myG.ne;
+      }
+      CS_GRAPH_COUNT(remove_edge, 1);
+      CS_GRAPH_COUNT(missing_edges, !b);
+    }
+
+    // ------
+    // weight
+    // ------
+
+    /**
+     * time:O(log(out degree of x))
+     * space: O(1)
+     * Precondition: edge(source(e), target(e), myG).second
+     */
+    friend weight_type
+    weight (edge_descriptor e, const BasicWeightedGraph& myG) {
+      typename row_type::const_iterator i = myG.find(e.first, e.second);
+      assert(i != myG.rows[e.first].end());
+      return i->weight;
+    }
+
+    /**
+     * the weight, for assignment: weight(e, g) = w
+     */
+    friend weight_type&
+    weight (edge_descriptor e, BasicWeightedGraph& myG) {
+      typename row_type::iterator i = myG.find(e.first, e.second);
+      assert(i != myG.rows[e.first].end());
+      return i->weight;
+    }
+
+    // --------
+    // out_arcs
+    // --------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     * @return pointers to the first and one past the last arc of x,
+     * sorted by target
+     */
+    friend std::pair<arc_iterator, arc_iterator>
+    out_arcs (vertex_descriptor x, const BasicWeightedGraph& myG) {
+      assert(x < myG.rows.size());
+      const row_type& row = myG.rows[x];
+      const arc_type* p   = row.empty() ? 0 : &row[0];
+      return std::make_pair(p, p + row.size());
+    }
+
+    // -----------------
+    // adjacent_vertices
+    // -----------------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     */
+    friend std::pair<adjacency_iterator, adjacency_iterator>
+    adjacent_vertices (vertex_descriptor x, const BasicWeightedGraph& myG) {
+      std::pair<arc_iterator, arc_iterator> p = out_arcs(x, myG);
+      return std::make_pair(adjacency_iterator(p.first), adjacency_iterator(p.second));
+    }
+
+    // ----------
+    // out_degree
+    // ----------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     */
+    friend degree_size_type
+    out_degree (vertex_descriptor x, const BasicWeightedGraph& myG) {
+      assert(x < myG.rows.size());
+      return myG.rows[x].size();
+    }
+
+    // ----
+    // edge
+    // ----
+
+    /**
+     * time:O(log(out degree of x))
+     * space:  O(1)
+     * binary search inside the sorted row of x
+     */
+    friend std::pair<edge_descriptor, bool>
+    edge (vertex_descriptor x, vertex_descriptor y, const BasicWeightedGraph& myG) {
+      CS_GRAPH_COUNT(edge_lookups, 1);
+      const bool b = (myG.find(x, y) != myG.rows[x].end());
+      return std::make_pair(edge_descriptor(x, y), b);
+    }
+
+    // -----
+    // edges
+    // -----
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     */
+    friend std::pair<edge_iterator, edge_iterator>
+    edges (const BasicWeightedGraph& myG) {
+      const vertex_descriptor n = static_cast<vertex_descriptor>(myG.rows.size());
+      return std::make_pair(edge_iterator(&myG, 0), edge_iterator(&myG, n));
+    }
+
+    // ------
+    // vertex
+    // ------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     */
+    friend vertex_descriptor
+    vertex (vertices_size_type n, const BasicWeightedGraph& myG) {
+      assert(n < myG.rows.size());
+      return static_cast<vertex_descriptor>(n);
+    }
+
+    // --------
+    // vertices
+    // --------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     */
+    friend std::pair<vertex_iterator, vertex_iterator>
+    vertices (const BasicWeightedGraph& myG) {
+      return std::make_pair(vertex_iterator(0),
+			    vertex_iterator(static_cast<vertex_descriptor>(myG.rows.size())));
+    }
+
+    // ------
+    // source
+    // ------
+
+    friend vertex_descriptor
+    source (edge_descriptor x, const BasicWeightedGraph& myG) {
+      assert(x.first < myG.rows.size());
+      return x.first;
+    }
+
+    // ------
+    // target
+    // ------
+
+    friend vertex_descriptor
+    target (edge_descriptor x, const BasicWeightedGraph&) {
+      return x.second;
+    }
+
+    // ---------
+    // num_edges
+    // ---------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     */
+    friend edges_size_type
+    num_edges (const BasicWeightedGraph& myG) {
+      return myG.ne;
+    }
+
+    // ------------
+    // num_vertices
+    // ------------
+
+    /**
+     * time:O(1)
+     * space:  O(1)
+     */
+    friend vertices_size_type
+    num_vertices (const BasicWeightedGraph& myG) {
+      return myG.rows.size();
+    }
+
+  private:
+    // ----
+    // data
+    // ----
+
+    std::vector<row_type> rows;
+    edges_size_type       ne;
+
+    typename row_type::iterator find (vertex_descriptor x, vertex_descriptor y) {
+      assert(x < rows.size());
+      const arc_type              a = {y, weight_type()};
+      typename row_type::iterator i = std::lower_bound(rows[x].begin(), rows[x].end(), a);
+      return ((i != rows[x].end()) && (i->target == y)) ? i : rows[x].end();
+    }
+
+    typename row_type::const_iterator find (vertex_descriptor x, vertex_descriptor y) const {
+      return const_cast<BasicWeightedGraph*>(this)->find(x, y);
+    }
+
+    // -----
+    // valid
+    // -----
+
+    /**
+     * every row strictly ascending by target, the targets in range and
+     * the edge count the total length of the rows
+     */
+    bool valid () const {
+      edges_size_type n = 0;
+      for (std::size_t u = 0; u != rows.size(); ++u) {
+	for (std::size_t i = 0; i != rows[u].size(); ++i)
+	  if ((rows[u][i].target >= rows.size()) ||
+	      ((i != 0) && !(rows[u][i - 1].target < rows[u][i].target)))
+	    return false;
+	n += rows[u].size();
+      }
+      return n == ne;
+    }
+
+  public:
+    // ------------
+    // constructors
+    // ------------
+
+    /**
+     * an empty graph
+     */
+    BasicWeightedGraph () : ne(0) {
+      assert(valid());
+    }
+
+    /**
+     * time: O(V + E log(max out degree))
+     * space: O(V + E)
+     * n vertices plus the edges of [first, last), the weight of the i-th
+     * edge the i-th element of the range at weights (as boost's
+     * adjacency_list constructor takes them)
+     * vertices are added as needed to cover every endpoint; of parallel
+     * edges the first one wins, as with add_edge
+     */
+    template <typename FI, typename WI>
+    BasicWeightedGraph (vertices_size_type n, FI first, FI last, WI weights) : rows(n), ne(0) {
+      for (; first != last; ++first, ++weights) {
+	const vertex_descriptor m = std::max(first->first, first->second);
+	if (m >= rows.size())
+	  rows.resize(std::size_t(m) + 1);
+	const arc_type a = {static_cast<vertex_descriptor>(first->second), *weights};
+	rows[first->first].push_back(a);
+      }
+      for (std::size_t u = 0; u != rows.size(); ++u) {
+	row_type& row = rows[u];
+	std::stable_sort(row.begin(), row.end());
+	std::size_t k = 0;
+	for (std::size_t i = 0; i != row.size(); ++i)
+	  if ((k == 0) || (row[k - 1].target != row[i].target))
+	    row[k++] = row[i];
+	row_type(row.begin(), row.begin() + k).swap(row);
+	ne += k;
+      }
+      assert(valid());
+    }
+
+    // Default copy, destructor, and copy assignment
+  };
+
+  // -------------
+  // WeightedGraph
+  // -------------
+
+  /**
+   * integer weights, which is what the radix heap of ShortestPaths.h
+   * wants
+   */
+  typedef BasicWeightedGraph<unsigned int> WeightedGraph;
+
+} // cs
+
+#endif // WeightedGraph_h
@@ -0,0 +1,1106 @@
+// ----------------------------
+// projects/c++/graph/bench.c++
+// Copyright (C) 2009
+// Glenn P. Downing
+// ----------------------------
+
+/*
+  To run the benchmark:
+  make bench.app
+  bench.app [vertices] [edges] [repetitions]
+  bench.app chain [vertices]
+  bench.app longest [scale] [degree]
+
+  make trace builds it with CS_GRAPH_STATS, which also writes the
+  counters and a Chrome trace of every timed phase to bench.trace.json
+*/
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // fill, min, swap
+#include <cstddef>   // size_t
+#include <cstdio>    // remove
+#include <cstdlib>   // atoi
+#include <fstream>   // ifstream, ofstream
+#include <cstring>   // strcmp
+#include <iostream>  // cout, endl
+#include <iterator>  // back_inserter
+#include <vector>    // vector
+
+#ifdef _OPENMP
+#include <omp.h> // omp_get_max_threads
+#endif
+
+#include "boost/graph/adjacency_list.hpp"          // adjacency_list, property
+#include "boost/graph/dijkstra_shortest_paths.hpp" // dijkstra_shortest_paths
+
+#include "AcyclicGraph.h"
+#include "Benchmark.h"
+#include "BidirectionalGraph.h"
+#include "CompressedGraph.h"
+#include "ConcurrentGraph.h"
+#include "CsrGraph.h"
+#include "DagExecutor.h"
+#include "DenseGraph.h"
+#include "EdgeListReader.h"
+#include "Graph.h"
+#include "GraphAlgorithms.h"
+#include "GraphStats.h"
+#include "MappedGraph.h"
+#include "ReachabilityIndex.h"
+#include "Reordering.h"
+#include "ShortestPaths.h"
+#include "TopologicalOrder.h"
+#include "VersionedGraph.h"
+#include "WeightedGraph.h"
+
+namespace {
+
+  using cs::bench::edge_list;
+  using cs::bench::seconds;
+
+  // ----------
+  // random_dag
+  // ----------
+
+  /**
+   * m random forward edges u -> v with u < v over n vertices
+   */
+  void random_dag (cs::Graph& g, unsigned int n, unsigned int m) {
+    const edge_list es = cs::bench::erdos_renyi(n, m, true, 2463534242u);
+    for (unsigned int i = 0; i != n; ++i)
+      add_vertex(g);
+    for (std::size_t i = 0; i != es.size(); ++i)
+      add_edge(es[i].first, es[i].second, g);
+  }
+
+  // ---------
+  // time_load
+  // ---------
+
+  /**
+   * one add_edge per edge versus a single add_edges
+   */
+  template <typename G>
+  void time_load (const char* what, unsigned int n, const edge_list& es) {
+    double t = seconds();
+    {
+      G g;
+      for (unsigned int i = 0; i != n; ++i)
+	add_vertex(g);
+      for (std::size_t i = 0; i != es.size(); ++i)
+	add_edge(es[i].first, es[i].second, g);
+    }
+    const double one = seconds() - t;
+    t = seconds();
+    {
+      G g(n, es.begin(), es.end());
+    }
+    const double bulk = seconds() - t;
+    std::cout << what << " load: add_edge " << one * 1e3 << " ms, add_edges "
+	      << bulk * 1e3 << " ms, speedup " << one / bulk << "x" << std::endl;
+  }
+
+  // --------------
+  // time_edge_list
+  // --------------
+
+  /**
+   * writes es as a SNAP style text file and reads it back
+   */
+  void time_edge_list (unsigned int n, const edge_list& es) {
+    {
+      std::ofstream out("bench.txt");
+      out << "# random edges\n# FromNodeId\tToNodeId\n";
+      for (std::size_t i = 0; i != es.size(); ++i)
+	out << es[i].first << '\t' << es[i].second << '\n';
+    }
+    std::ifstream in("bench.txt", std::ios::binary | std::ios::ate);
+    const double mb = static_cast<double>(in.tellg()) / (1 << 20);
+    double t = seconds();
+    cs::FlatGraph g;
+    reserve_vertices(n, g);
+    const bool ok = cs::read_edge_list("bench.txt", g);
+    t = seconds() - t;
+    std::cout << "read_edge_list: " << mb << " MB in " << t * 1e3 << " ms, "
+	      << mb / t << " MB/s" << (ok ? "" : " (FAILED)") << std::endl;
+    std::remove("bench.txt");
+  }
+
+  // ------------
+  // stress_chain
+  // ------------
+
+  /**
+   * the DFS depth equals n, far beyond what a recursive traversal survives
+   */
+  int stress_chain (unsigned int n) {
+    cs::Graph g;
+    double t = seconds();
+    const edge_list es = cs::bench::chain(n);
+    for (unsigned int i = 0; i != n; ++i)
+      add_vertex(g);
+    for (std::size_t i = 0; i != es.size(); ++i)
+      add_edge(es[i].first, es[i].second, g);
+    std::cout << "chain of " << n << " vertices built in " << (seconds() - t) << " s" << std::endl;
+    t = seconds();
+    const bool cyclic = cs::has_cycle(g);
+    std::cout << "has_cycle " << (seconds() - t) << " s" << std::endl;
+    std::vector<cs::Graph::vertex_descriptor> order;
+    order.reserve(n);
+    t = seconds();
+    cs::topological_sort(g, std::back_inserter(order));
+    std::cout << "topological_sort " << (seconds() - t) << " s" << std::endl;
+    bool ok = !cyclic && (order.size() == n) && ((n == 0) || (order.front() == n - 1));
+    std::cout << (ok ? "chain ok" : "chain FAILED") << std::endl;
+    if (n == 0)
+      return ok ? 0 : 1;
+
+    // closed into a ring, the whole graph is one component
+    add_edge(n - 1, 0, g);
+    std::vector<std::size_t> component;
+    t = seconds();
+    ok = (cs::strongly_connected_components(g, component) == 1) && ok;
+    std::cout << "strongly_connected_components " << (seconds() - t) << " s" << std::endl;
+    t = seconds();
+    ok = (cs::parallel_strongly_connected_components(g, component) == 1) && ok;
+    std::cout << "parallel_strongly_connected_components " << (seconds() - t) << " s" << std::endl;
+    std::cout << (ok ? "ring ok" : "ring FAILED") << std::endl;
+    return ok ? 0 : 1;
+  }
+
+  // --------------
+  // time_has_cycle
+  // --------------
+
+  template <typename G>
+  double time_has_cycle (const G& g, int reps) {
+    const double t = seconds();
+    for (int i = 0; i != reps; ++i)
+      if (cs::has_cycle(g))
+	std::cout << "unexpected cycle" << std::endl;
+    return (seconds() - t) / reps;
+  }
+
+  // ---------------------
+  // time_topological_sort
+  // ---------------------
+
+  template <typename G>
+  double time_topological_sort (const G& g, int reps) {
+    std::vector<typename G::vertex_descriptor> order;
+    order.reserve(num_vertices(g));
+    const double t = seconds();
+    for (int i = 0; i != reps; ++i) {
+      order.clear();
+      cs::topological_sort(g, std::back_inserter(order));
+    }
+    return (seconds() - t) / reps;
+  }
+
+  // ------------------------------
+  // time_parallel_topological_sort
+  // ------------------------------
+
+  template <typename G>
+  double time_parallel_topological_sort (const G& g, int reps) {
+    std::vector<typename G::vertex_descriptor> order;
+    std::vector<std::size_t>                   levels;
+    order.reserve(num_vertices(g));
+    const double t = seconds();
+    for (int i = 0; i != reps; ++i) {
+      order.clear();
+      if (!cs::parallel_topological_sort(g, std::back_inserter(order), &levels))
+	std::cout << "unexpected cycle" << std::endl;
+    }
+    return (seconds() - t) / reps;
+  }
+
+  // --------
+  // time_scc
+  // --------
+
+  /**
+   * serial versus parallel components of a random graph with cycles,
+   * then its condensation
+   */
+  void time_scc (unsigned int n, const edge_list& es, int reps) {
+    const cs::FlatGraph      g(n, es.begin(), es.end());
+    std::vector<std::size_t> component;
+    std::size_t              k = 0;
+    double t = seconds();
+    for (int r = 0; r != reps; ++r)
+      k = cs::strongly_connected_components(g, component);
+    const double serial = (seconds() - t) / reps;
+    t = seconds();
+    for (int r = 0; r != reps; ++r)
+      if (cs::parallel_strongly_connected_components(g, component) != k)
+	std::cout << "component counts differ" << std::endl;
+    const double parallel = (seconds() - t) / reps;
+    std::cout << "strongly_connected_components: " << k << " components, serial "
+	      << serial * 1e3 << " ms, parallel " << parallel * 1e3 << " ms, speedup "
+	      << serial / parallel << "x" << std::endl;
+    cs::FlatGraph dag;
+    t = seconds();
+    cs::condensation(g, component, k, dag);
+    std::cout << "condensation: " << num_edges(dag) << " edges in " << (seconds() - t) * 1e3
+	      << " ms" << (cs::has_cycle(dag) ? " (CYCLIC)" : "") << std::endl;
+  }
+
+  // --------------
+  // time_edge_scan
+  // --------------
+
+  /**
+   * a pass over every edge of a cs::Graph: one edges(g), then the
+   * sources split into chunks of edges(first, last, g) across the threads
+   * @return the serial time
+   */
+  double time_edge_scan (const cs::Graph& g, int reps) {
+    typedef cs::Graph::edge_iterator edgeit;
+    const long  n      = static_cast<long>(num_vertices(g));
+    const long  chunks = 64;
+    std::size_t serial_sum = 0;
+    double t = seconds();
+    for (int r = 0; r != reps; ++r) {
+      std::pair<edgeit, edgeit> p = edges(g);
+      for (; p.first != p.second; ++p.first)
+	serial_sum += (*p.first).second;
+    }
+    const double serial = (seconds() - t) / reps;
+    std::size_t split_sum = 0;
+    t = seconds();
+    for (int r = 0; r != reps; ++r) {
+      #pragma omp parallel for schedule(dynamic, 1) reduction(+:split_sum)
+      for (long c = 0; c < chunks; ++c) {
+	std::pair<edgeit, edgeit> p = edges(static_cast<unsigned int>(n * c / chunks),
+					    static_cast<unsigned int>(n * (c + 1) / chunks), g);
+	for (; p.first != p.second; ++p.first)
+	  split_sum += (*p.first).second;
+      }
+    }
+    const double split = (seconds() - t) / reps;
+    std::cout << "edge scan: " << num_edges(g) << " edges, edges(g) " << serial * 1e3
+	      << " ms, " << chunks << " ranges of sources " << split * 1e3 << " ms"
+	      << ((serial_sum == split_sum) ? "" : " MISMATCH") << std::endl;
+    return serial;
+  }
+
+  // ------
+  // report
+  // ------
+
+  void report (const char* what, double set_time, double other_time, const char* other = "CsrGraph") {
+    std::cout << what << ": Graph " << set_time * 1e3 << " ms, " << other << " "
+	      << other_time * 1e3 << " ms, speedup " << set_time / other_time << "x" << std::endl;
+  }
+
+  // -------------------
+  // time_build_teardown
+  // -------------------
+
+  /**
+   * one add_edge per edge, then the destruction of the graph
+   */
+  template <typename G>
+  void time_build_teardown (const edge_list& es, unsigned int n, double& build, double& teardown) {
+    double t = seconds();
+    G* g = new G;
+    reserve_vertices(n, *g);
+    for (unsigned int i = 0; i != n; ++i)
+      add_vertex(*g);
+    for (std::size_t i = 0; i != es.size(); ++i)
+      add_edge(es[i].first, es[i].second, *g);
+    build = seconds() - t;
+    t = seconds();
+    delete g;
+    teardown = seconds() - t;
+  }
+
+  // ----------
+  // time_arena
+  // ----------
+
+  /**
+   * std::allocator versus ArenaAllocator for the set nodes of cs::Graph
+   */
+  void time_arena (unsigned int n, const edge_list& es) {
+    double build;
+    double teardown;
+    double arena_build;
+    double arena_teardown;
+    time_build_teardown<cs::Graph>(es, n, build, teardown);
+    time_build_teardown<cs::ArenaGraph>(es, n, arena_build, arena_teardown);
+    report("build",    build,    arena_build,    "ArenaGraph");
+    report("teardown", teardown, arena_teardown, "ArenaGraph");
+  }
+
+
+  // ---------
+  // ancestors
+  // ---------
+
+  /**
+   * the number of vertices that can reach v, by a search over inv_adjacent_vertices
+   */
+  std::size_t ancestors (const cs::BidirectionalGraph& g, unsigned int v) {
+    typedef cs::BidirectionalGraph::inv_adjacency_iterator invit;
+    std::vector<bool>         seen(num_vertices(g), false);
+    std::vector<unsigned int> stack(1, v);
+    std::size_t               k = 0;
+    seen[v] = true;
+    while (!stack.empty()) {
+      const unsigned int u = stack.back();
+      stack.pop_back();
+      std::pair<invit, invit> p = inv_adjacent_vertices(u, g);
+      for (invit b = p.first; b != p.second; ++b)
+	if (!seen[*b]) {
+	  seen[*b] = true;
+	  stack.push_back(*b);
+	  ++k;
+	}
+    }
+    return k;
+  }
+
+  /**
+   * the same, when the predecessors have to be collected first, O(E)
+   */
+  std::size_t ancestors (const cs::Graph& g, unsigned int v) {
+    typedef cs::Graph::edge_iterator edgeit;
+    std::vector< std::vector<unsigned int> > in(num_vertices(g));
+    std::pair<edgeit, edgeit> p = edges(g);
+    for (edgeit b = p.first; b != p.second; ++b)
+      in[(*b).second].push_back((*b).first);
+    std::vector<bool>         seen(num_vertices(g), false);
+    std::vector<unsigned int> stack(1, v);
+    std::size_t               k = 0;
+    seen[v] = true;
+    while (!stack.empty()) {
+      const unsigned int u = stack.back();
+      stack.pop_back();
+      for (std::size_t i = 0; i != in[u].size(); ++i)
+	if (!seen[in[u][i]]) {
+	  seen[in[u][i]] = true;
+	  stack.push_back(in[u][i]);
+	  ++k;
+	}
+    }
+    return k;
+  }
+
+  // ------------
+  // time_reverse
+  // ------------
+
+  /**
+   * reverse traversal queries, scanning cs::Graph versus the in edges
+   * kept by cs::BidirectionalGraph
+   */
+  void time_reverse (unsigned int n, const edge_list& es, int reps) {
+    typedef cs::Graph::edge_iterator edgeit;
+    double t = seconds();
+    cs::Graph g(n, es.begin(), es.end());
+    const double build = seconds() - t;
+    t = seconds();
+    cs::BidirectionalGraph b(n, es.begin(), es.end());
+    report("bidirectional build", build, seconds() - t, "BidirectionalGraph");
+
+    std::vector<std::size_t> degrees(n);
+    t = seconds();
+    for (int r = 0; r != reps; ++r) {
+      std::fill(degrees.begin(), degrees.end(), 0);
+      std::pair<edgeit, edgeit> p = edges(g);
+      for (edgeit i = p.first; i != p.second; ++i)
+	++degrees[(*i).second];
+    }
+    const double scan = (seconds() - t) / reps;
+    t = seconds();
+    for (int r = 0; r != reps; ++r)
+      for (unsigned int v = 0; v != n; ++v)
+	degrees[v] = in_degree(v, b);
+    report("all in_degrees", scan, (seconds() - t) / reps, "BidirectionalGraph");
+
+    cs::bench::Random random(7);
+    std::size_t       found = 0;
+    t = seconds();
+    for (int r = 0; r != reps; ++r)
+      found += ancestors(g, random.below(n));
+    const double slow = (seconds() - t) / reps;
+    t = seconds();
+    for (int r = 0; r != reps; ++r)
+      found -= ancestors(b, random.below(n));
+    report("ancestors of one vertex", slow, (seconds() - t) / reps, "BidirectionalGraph");
+  }
+
+  // ------------
+  // time_acyclic
+  // ------------
+
+  /**
+   * inserting edges one at a time while refusing those that close a
+   * cycle: add_edge plus a full has_cycle (and a remove_edge on failure)
+   * on cs::Graph, versus add_edge_acyclic on cs::AcyclicGraph
+   * the full check is timed on the first few thousand edges only;
+   * both are reported per insertion
+   */
+  void time_acyclic (unsigned int n, const edge_list& es) {
+    const std::size_t checked = std::min<std::size_t>(es.size(), 2000);
+    cs::Graph         g;
+    for (unsigned int i = 0; i != n; ++i)
+      add_vertex(g);
+    std::size_t accepted = 0;
+    double      t        = seconds();
+    for (std::size_t i = 0; i != checked; ++i) {
+      if (!add_edge(es[i].first, es[i].second, g).second)
+	continue;
+      if (cs::has_cycle(g))
+	remove_edge(es[i].first, es[i].second, g);
+      else
+	++accepted;
+    }
+    const double full = (seconds() - t) / checked;
+
+    cs::AcyclicGraph a;
+    reserve_vertices(n, a);
+    for (unsigned int i = 0; i != n; ++i)
+      add_vertex(a);
+    t = seconds();
+    for (std::size_t i = 0; i != es.size(); ++i)
+      add_edge_acyclic(es[i].first, es[i].second, a);
+    const double incremental = (seconds() - t) / es.size();
+    report("acyclic insertion, per edge", full, incremental, "AcyclicGraph");
+    std::cout << "AcyclicGraph kept " << num_edges(a) << " of " << es.size() << " edges" << std::endl;
+  }
+
+  // ----------
+  // time_dense
+  // ----------
+
+  /**
+   * a dense DAG (every forward pair with probability 1/4) in cs::Graph
+   * and in cs::DenseGraph: the build, random edge lookups, a traversal,
+   * and counting the common successors of pairs of vertices, a merge of
+   * two std::sets versus a popcount of two ANDed rows
+   */
+  void time_dense (unsigned int n, int reps) {
+    const edge_list es = cs::bench::dense_dag(n, 0.25, 521288629u);
+    double t = seconds();
+    cs::Graph g(n, es.begin(), es.end());
+    const double build = seconds() - t;
+    t = seconds();
+    cs::DenseGraph d(n);
+    for (std::size_t i = 0; i != es.size(); ++i)
+      add_edge(es[i].first, es[i].second, d);
+    report("dense build", build, seconds() - t, "DenseGraph");
+    std::cout << num_edges(d) << " edges, DenseGraph matrix "
+	      << num_vertices(d) * row_words(d) * sizeof(cs::bits::word) / 1024 << " KB" << std::endl;
+
+    cs::bench::Random random(11);
+    std::size_t       found = 0;
+    t = seconds();
+    for (int i = 0; i != 1000000; ++i)
+      found += edge(random.below(n), random.below(n), g).second;
+    const double lookup = seconds() - t;
+    random = cs::bench::Random(11);
+    t = seconds();
+    for (int i = 0; i != 1000000; ++i)
+      found -= edge(random.below(n), random.below(n), d).second;
+    report("1M random edge()", lookup, seconds() - t, "DenseGraph");
+
+    report("dense topological_sort", time_topological_sort(g, reps), time_topological_sort(d, reps),
+	   "DenseGraph");
+
+    typedef cs::Graph::adjacency_iterator adjit;
+    const unsigned int pairs = 20000;
+    t = seconds();
+    for (unsigned int i = 0; i != pairs; ++i) {
+      std::pair<adjit, adjit> a = adjacent_vertices(i % n, g);
+      std::pair<adjit, adjit> b = adjacent_vertices((i * 7 + 1) % n, g);
+      while ((a.first != a.second) && (b.first != b.second))
+	if (*a.first < *b.first)
+	  ++a.first;
+	else if (*b.first < *a.first)
+	  ++b.first;
+	else {
+	  ++found;
+	  ++a.first;
+	  ++b.first;
+	}
+    }
+    const double merge = seconds() - t;
+    t = seconds();
+    for (unsigned int i = 0; i != pairs; ++i)
+      found -= common_successors(i % n, (i * 7 + 1) % n, d);
+    report("common successors of 20000 pairs", merge, seconds() - t, "DenseGraph");
+
+    t = seconds();
+    transitive_closure(d);
+    std::cout << "DenseGraph transitive_closure: " << (seconds() - t) * 1e3 << " ms, "
+	      << num_edges(d) << " edges" << (found ? " (MISMATCH)" : "") << std::endl;
+  }
+
+  // ---------------
+  // time_concurrent
+  // ---------------
+
+  /**
+   * parallel ingestion with 1 to 64 writer threads: every writer calls
+   * add_edge on cs::Graph behind a single critical section, versus on
+   * cs::ConcurrentGraph with its striped locks
+   */
+  void time_concurrent (unsigned int n, const edge_list& es) {
+    const long m = static_cast<long>(es.size());
+    for (int threads = 1; threads <= 64; threads *= 2) {
+      cs::Graph g;
+      reserve_vertices(n, g);
+      for (unsigned int i = 0; i != n; ++i)
+	add_vertex(g);
+      double t = seconds();
+      #pragma omp parallel for num_threads(threads) schedule(static)
+      for (long i = 0; i < m; ++i) {
+	#pragma omp critical (time_concurrent)
+	add_edge(es[i].first, es[i].second, g);
+      }
+      const double serialized = seconds() - t;
+
+      cs::ConcurrentGraph c;
+      reserve_vertices(n, c);
+      for (unsigned int i = 0; i != n; ++i)
+	add_vertex(c);
+      t = seconds();
+      #pragma omp parallel for num_threads(threads) schedule(static)
+      for (long i = 0; i < m; ++i)
+	add_edge(es[i].first, es[i].second, c);
+      const double concurrent = seconds() - t;
+      std::cout << threads << " writers, ";
+      report("concurrent add_edge", serialized, concurrent, "ConcurrentGraph");
+      if (num_edges(c) != num_edges(g))
+	std::cout << "MISMATCH " << num_edges(c) << " " << num_edges(g) << std::endl;
+    }
+  }
+
+  // ------------
+  // random_names
+  // ------------
+
+  /**
+   * an R-MAT DAG with 2^scale vertices and degree * 2^scale edges whose
+   * vertices are named in a random order, as insertion order usually is
+   * (R-MAT itself gives the hubs the lowest ids)
+   */
+  edge_list random_names (unsigned int scale, unsigned int degree) {
+    const unsigned int n  = 1u << scale;
+    edge_list          es = cs::bench::rmat(scale, static_cast<std::size_t>(degree) * n, true, 1442695040u);
+    std::vector<unsigned int> name(n);
+    for (unsigned int v = 0; v != n; ++v)
+      name[v] = v;
+    cs::bench::Random random(13);
+    for (unsigned int v = n - 1; v != 0; --v)
+      std::swap(name[v], name[random.below(v + 1)]);
+    for (std::size_t i = 0; i != es.size(); ++i)
+      es[i] = cs::bench::edge_type(name[es[i].first], name[es[i].second]);
+    return es;
+  }
+
+  // ------------
+  // time_reorder
+  // ------------
+
+  /**
+   * traversals of a power-law (R-MAT) DAG with randomly named vertices
+   * versus the same graph renumbered by each of the orderings of
+   * Reordering.h; both as a cs::Graph and as a CsrGraph
+   */
+  void time_reorder (unsigned int scale, unsigned int degree, int reps) {
+    const unsigned int n  = 1u << scale;
+    const edge_list    es = random_names(scale, degree);
+    const cs::Graph    g(n, es.begin(), es.end());
+    const cs::CsrGraph c(g);
+    const double       graph = time_has_cycle(g, reps) + time_topological_sort(g, reps);
+    const double       csr   = time_has_cycle(c, reps) + time_topological_sort(c, reps);
+    std::cout << "R-MAT scale " << scale << ", " << num_edges(g) << " edges, random names" << std::endl;
+
+    const char* names[] = {"degree", "rcm", "bfs", "dfs"};
+    for (int k = 0; k != 4; ++k) {
+      double t = seconds();
+      const cs::Relabeling r = (k == 0) ? cs::degree_ordering(g) :
+			       (k == 1) ? cs::rcm_ordering(g)    :
+			       (k == 2) ? cs::bfs_ordering(g)    : cs::dfs_ordering(g);
+      const double ordering = seconds() - t;
+      cs::Graph h;
+      t = seconds();
+      cs::relabel(g, r, h);
+      const double relabeling = seconds() - t;
+      const cs::CsrGraph d(h);
+      std::cout << names[k] << " ordering " << ordering * 1e3 << " ms, relabel "
+		<< relabeling * 1e3 << " ms" << std::endl;
+      const double relabeled_graph = time_has_cycle(h, reps) + time_topological_sort(h, reps);
+      const double relabeled_csr   = time_has_cycle(d, reps) + time_topological_sort(d, reps);
+      std::cout << "  has_cycle + topological_sort: Graph " << graph * 1e3 << " -> "
+		<< relabeled_graph * 1e3 << " ms, speedup " << graph / relabeled_graph << "x; CsrGraph "
+		<< csr * 1e3 << " -> " << relabeled_csr * 1e3 << " ms, speedup " << csr / relabeled_csr
+		<< "x" << std::endl;
+    }
+  }
+
+  // ---------------
+  // time_compressed
+  // ---------------
+
+  /**
+   * the memory and traversal time of CsrGraph, CompressedGraph and
+   * GroupCompressedGraph on a power-law (R-MAT) DAG, with randomly named
+   * vertices and renumbered by dfs_ordering
+   */
+  void time_compressed (unsigned int scale, unsigned int degree, int reps) {
+    const unsigned int n  = 1u << scale;
+    const edge_list    es = random_names(scale, degree);
+    cs::Graph          g(n, es.begin(), es.end());
+    std::cout << "R-MAT scale " << scale << ", " << num_edges(g) << " edges" << std::endl;
+    for (int k = 0; k != 2; ++k) {
+      if (k == 1) {
+	cs::Graph h;
+	cs::relabel(g, cs::dfs_ordering(g), h);
+	std::swap(g, h);
+      }
+      const cs::CsrGraph             c(g);
+      const cs::CompressedGraph      z(g);
+      const cs::GroupCompressedGraph w(g);
+      const double e   = static_cast<double>(num_edges(g));
+      const double csr = time_has_cycle(c, reps) + time_topological_sort(c, reps);
+      std::cout << ((k == 0) ? "random names" : "dfs_ordering") << ": bytes per edge CsrGraph "
+		<< ((n + 1) * sizeof(cs::CsrGraph::edges_size_type) + num_edges(c) * 4) / e
+		<< ", CompressedGraph " << memory_use(z) / e
+		<< ", GroupCompressedGraph " << memory_use(w) / e << std::endl;
+      const double varint = time_has_cycle(z, reps) + time_topological_sort(z, reps);
+      const double group  = time_has_cycle(w, reps) + time_topological_sort(w, reps);
+      std::cout << "  has_cycle + topological_sort: CsrGraph " << csr * 1e3 << " ms, CompressedGraph "
+		<< varint * 1e3 << " ms, GroupCompressedGraph " << group * 1e3 << " ms" << std::endl;
+    }
+  }
+
+  // --------------
+  // time_versioned
+  // --------------
+
+  /**
+   * a consistent read view of a graph under writes: a deep copy of
+   * cs::Graph versus a cs::Snapshot, then m more writes with and without
+   * a snapshot held (the held one makes the writes copy on write), and a
+   * has_cycle over the snapshot versus over the copy
+   */
+  void time_versioned (unsigned int n, std::size_t m, int reps) {
+    const edge_list   es   = cs::bench::erdos_renyi(n, m, true, 362436069u);
+    const std::size_t half = es.size() / 2;
+    cs::Graph          g;
+    cs::VersionedGraph v;
+    for (unsigned int i = 0; i != n; ++i) {
+      add_vertex(g);
+      add_vertex(v);
+    }
+    for (std::size_t i = 0; i != half; ++i) {
+      add_edge(es[i].first, es[i].second, g);
+      add_edge(es[i].first, es[i].second, v);
+    }
+
+    double t = seconds();
+    for (int i = 0; i != reps; ++i)
+      cs::Graph copy(g);
+    const double copying = (seconds() - t) / reps;
+    t = seconds();
+    for (int i = 0; i != reps; ++i)
+      const cs::Snapshot s = snapshot(v);
+    report("read view (copy vs snapshot)", copying, (seconds() - t) / reps, "Snapshot");
+
+    cs::Graph          copy(g);
+    const cs::Snapshot s = snapshot(v);
+    cs::VersionedGraph w;
+    for (unsigned int i = 0; i != n; ++i)
+      add_vertex(w);
+    t = seconds();
+    for (std::size_t i = half; i != es.size(); ++i)
+      add_edge(es[i].first, es[i].second, w);
+    const double plain = seconds() - t;
+    t = seconds();
+    for (std::size_t i = half; i != es.size(); ++i)
+      add_edge(es[i].first, es[i].second, v);
+    std::cout << "VersionedGraph writes: " << plain * 1e3 << " ms alone, " << (seconds() - t) * 1e3
+	      << " ms with a snapshot held, " << retained(v) << " nodes retained" << std::endl;
+    report("has_cycle (copy vs snapshot)", time_has_cycle(copy, reps), time_has_cycle(s, reps),
+	   "Snapshot");
+    if (num_edges(s) != num_edges(copy))
+      std::cout << "MISMATCH " << num_edges(s) << " " << num_edges(copy) << std::endl;
+  }
+
+  // ---------
+  // time_sssp
+  // ---------
+
+  /**
+   * shortest paths from vertex 0 with weights uniform in [1, 1000],
+   * boost's dijkstra_shortest_paths on the adjacency_list of main.cpp
+   * (the weights an edge property) against ShortestPaths.h on a
+   * WeightedGraph of the same edges
+   */
+  void time_sssp (unsigned int n, const edge_list& es, int reps) {
+    typedef boost::adjacency_list<boost::setS, boost::vecS, boost::directedS, boost::no_property,
+				  boost::property<boost::edge_weight_t, unsigned int> > boost_graph;
+    cs::bench::Random         r(521288629u);
+    std::vector<unsigned int> ws(es.size());
+    for (std::size_t i = 0; i != ws.size(); ++i)
+      ws[i] = 1 + r.below(1000);
+    const cs::WeightedGraph g(n, es.begin(), es.end(), ws.begin());
+    boost_graph             b(n);
+    for (std::size_t i = 0; i != es.size(); ++i)
+      add_edge(es[i].first, es[i].second, ws[i], b);
+
+    std::vector<unsigned long> expected(n);
+    std::vector<std::size_t>   q(n);
+    double t = seconds();
+    for (int i = 0; i != reps; ++i)
+      boost::dijkstra_shortest_paths(b, 0, boost::predecessor_map(&q[0]).distance_map(&expected[0]));
+    const double boost_time = (seconds() - t) / reps;
+
+    std::vector<unsigned long> d;
+    std::vector<unsigned int>  p;
+    bool                       same = true;
+    t = seconds();
+    for (int i = 0; i != reps; ++i)
+      cs::dijkstra_shortest_paths(g, 0, d, p);
+    const double dary = (seconds() - t) / reps;
+    same = same && (d == expected);
+    t = seconds();
+    for (int i = 0; i != reps; ++i)
+      cs::radix_dijkstra_shortest_paths(g, 0, d, p);
+    const double radix = (seconds() - t) / reps;
+    same = same && (d == expected);
+    t = seconds();
+    for (int i = 0; i != reps; ++i)
+      cs::delta_stepping_shortest_paths(g, 0, d, p);
+    const double delta = (seconds() - t) / reps;
+    same = same && (d == expected);
+
+    std::cout << "shortest paths: boost " << boost_time * 1e3 << " ms, 4-ary heap " << dary * 1e3
+	      << " ms (" << boost_time / dary << "x), radix heap " << radix * 1e3 << " ms ("
+	      << boost_time / radix << "x), delta-stepping " << delta * 1e3 << " ms ("
+	      << boost_time / delta << "x)" << (same ? "" : " MISMATCH") << std::endl;
+  }
+
+  // -----------------
+  // time_reachability
+  // -----------------
+
+  /**
+   * "does u reach v" for random pairs of vertices: ReachabilityIndex
+   * against a depth-first search of a CsrGraph per query
+   */
+  void time_reachability (const char* what, unsigned int n, const edge_list& es, int queries) {
+    typedef cs::CsrGraph::adjacency_iterator adjit;
+    cs::Graph g;
+    for (unsigned int i = 0; i != n; ++i)
+      add_vertex(g);
+    for (std::size_t i = 0; i != es.size(); ++i)
+      add_edge(es[i].first, es[i].second, g);
+    const cs::CsrGraph c = cs::to_csr(g);
+    double t = seconds();
+    const cs::ReachabilityIndex r(g);
+    const double build = seconds() - t;
+
+    cs::bench::Random         rnd(5783321u);
+    std::vector<unsigned int> us(queries);
+    std::vector<unsigned int> vs(queries);
+    for (int i = 0; i != queries; ++i) {
+      us[i] = rnd.below(n);
+      vs[i] = rnd.below(n);
+    }
+    std::vector<bool> answers(queries);
+    std::size_t       positive = 0;
+    t = seconds();
+    for (int i = 0; i != queries; ++i)
+      positive += (answers[i] = reachable(us[i], vs[i], r));
+    const double indexed = (seconds() - t) / queries;
+
+    const int         searches = queries / 1000; // a search of R-MAT takes milliseconds
+    bool              same     = true;
+    std::vector<bool> seen(n);
+    t = seconds();
+    for (int i = 0; i != searches; ++i) {
+      std::fill(seen.begin(), seen.end(), false);
+      std::vector<unsigned int> stack(1, us[i]);
+      bool                      found = (us[i] == vs[i]);
+      seen[us[i]] = true;
+      while (!found && !stack.empty()) {
+	std::pair<adjit, adjit> p = adjacent_vertices(stack.back(), c);
+	stack.pop_back();
+	for (; p.first != p.second; ++p.first)
+	  if (!seen[*p.first]) {
+	    seen[*p.first] = true;
+	    found          = found || (*p.first == vs[i]);
+	    stack.push_back(*p.first);
+	  }
+      }
+      same = same && (found == answers[i]);
+    }
+    const double searched = (seconds() - t) / searches;
+
+    std::cout << "reachability, " << what << " (" << n << " vertices, " << num_edges(g) << " edges, "
+	      << num_components(r) << " components): index " << build * 1e3 << " ms to build, "
+	      << double(memory_use(r)) / n << " bytes per vertex, query " << indexed * 1e9 << " ns, depth-first search " << searched * 1e9 << " ns ("
+	      << searched / indexed << "x), " << 100.0 * positive / queries << "% reachable"
+	      << (same ? "" : " MISMATCH") << std::endl;
+  }
+
+  // ----------------------
+  // time_topological_order
+  // ----------------------
+
+  /**
+   * the first few ready vertices from a TopologicalOrder against a whole
+   * topological_sort, then a whole drain of the order
+   */
+  void time_topological_order (unsigned int n, const edge_list& es, int reps) {
+    typedef cs::BidirectionalGraph::vertex_descriptor vertex_descriptor;
+    cs::BidirectionalGraph g;
+    for (unsigned int i = 0; i != n; ++i)
+      add_vertex(g);
+    for (std::size_t i = 0; i != es.size(); ++i)
+      add_edge(es[i].first, es[i].second, g);
+    const double eager = time_topological_sort(g, reps);
+
+    const int   first = 10;
+    std::size_t got   = 0;
+    double      t     = seconds();
+    for (int i = 0; i != reps; ++i) {
+      cs::TopologicalOrder<cs::BidirectionalGraph> o(g);
+      vertex_descriptor                            v;
+      for (int j = 0; (j != first) && o.next(v); ++j) {
+	o.done(v);
+	++got;
+      }
+    }
+    const double lazy = (seconds() - t) / reps;
+
+    bool finished = true;
+    t = seconds();
+    for (int i = 0; i != reps; ++i) {
+      cs::TopologicalOrder<cs::BidirectionalGraph> o(g);
+      vertex_descriptor                            v;
+      while (o.next(v))
+	o.done(v);
+      finished = finished && o.finished();
+    }
+    const double drained = (seconds() - t) / reps;
+
+    std::cout << "TopologicalOrder (" << n << " vertices, " << num_edges(g) << " edges): first "
+	      << got / reps << " vertices " << lazy * 1e6 << " us, all " << drained * 1e3
+	      << " ms, topological_sort " << eager * 1e3 << " ms" << (finished ? "" : " (CYCLE)") << std::endl;
+  }
+
+  // -----------------
+  // time_dag_executor
+  // -----------------
+
+  struct Job {
+    unsigned int* ran;
+
+    bool operator () (unsigned int v) const {
+      ran[v] = 1;
+      return true;
+    }
+  };
+
+  /**
+   * the scheduling overhead per vertex of execute_dag on trivial jobs,
+   * against a topological_sort and a loop over its order
+   */
+  void time_dag_executor (const char* what, const cs::Graph& g, int reps) {
+    const unsigned int        n = static_cast<unsigned int>(num_vertices(g));
+    std::vector<unsigned int> ran(n + 1, 0);
+    const Job                 job = {&ran[0]};
+    std::vector<unsigned int> order;
+    order.reserve(n);
+    double t = seconds();
+    for (int i = 0; i != reps; ++i) {
+      order.clear();
+      cs::topological_sort(g, std::back_inserter(order));
+      for (std::size_t j = order.size(); j != 0; --j)
+	job(order[j - 1]);
+    }
+    const double serial = (seconds() - t) / reps;
+
+    bool ok = true;
+    t = seconds();
+    for (int i = 0; i != reps; ++i)
+      ok = cs::execute_dag(g, job) && ok;
+    const double executed = (seconds() - t) / reps;
+
+    std::cout << "execute_dag, " << what << " (" << n << " vertices, " << num_edges(g) << " edges): "
+	      << executed / n * 1e9 << " ns per vertex, topological_sort and a loop "
+	      << serial / n * 1e9 << " ns" << (ok ? "" : " (FAILED)") << std::endl;
+  }
+
+  /**
+   * a chain of n vertices, then a root with n - 2 children that all lead
+   * to one sink, then the random DAG of es
+   */
+  void time_dag_executor (unsigned int n, const edge_list& es, int reps) {
+    cs::Graph deep;
+    cs::Graph wide;
+    cs::Graph dag;
+    for (unsigned int i = 0; i != n; ++i) {
+      add_vertex(deep);
+      add_vertex(wide);
+      add_vertex(dag);
+    }
+    for (unsigned int i = 1; i != n; ++i)
+      add_edge(i - 1, i, deep);
+    for (unsigned int i = 1; i + 1 < n; ++i) {
+      add_edge(0, i, wide);
+      add_edge(i, n - 1, wide);
+    }
+    for (std::size_t i = 0; i != es.size(); ++i)
+      add_edge(es[i].first, es[i].second, dag);
+#ifdef _OPENMP
+    std::cout << "execute_dag with " << omp_get_max_threads() << " threads" << std::endl;
+#endif
+    time_dag_executor("deep", deep, reps);
+    time_dag_executor("wide", wide, reps);
+    time_dag_executor("random DAG", dag, reps);
+  }
+
+  // ------------------
+  // time_longest_paths
+  // ------------------
+
+  /**
+   * longest_paths against parallel_longest_paths on a CsrGraph of a random
+   * DAG with 2^scale vertices and degree * 2^scale edges, laid out
+   * straight from the edge list, so that 100M edges fit in memory
+   */
+  int time_longest_paths (unsigned int scale, unsigned int degree, int reps) {
+    typedef cs::CsrGraph::edges_size_type   edges_size_type;
+    typedef cs::CsrGraph::vertex_descriptor vertex_descriptor;
+    const unsigned int n = 1u << scale;
+    std::vector<edges_size_type>   offsets(n + 1, 0);
+    std::vector<vertex_descriptor> targets;
+    {
+      const edge_list es = cs::bench::erdos_renyi(n, std::size_t(degree) * n, true, 2463534242u);
+      targets.resize(es.size());
+      for (std::size_t i = 0; i != es.size(); ++i)
+	++offsets[es[i].first + 1];
+      for (unsigned int v = 0; v != n; ++v)
+	offsets[v + 1] += offsets[v];
+      std::vector<edges_size_type> next(offsets.begin(), offsets.end() - 1);
+      for (std::size_t i = 0; i != es.size(); ++i)
+	targets[next[es[i].first]++] = es[i].second;
+    }
+    for (unsigned int v = 0; v != n; ++v)
+      std::sort(targets.begin() + offsets[v], targets.begin() + offsets[v + 1]);
+    const cs::CsrGraph g(offsets, targets);
+
+    std::vector<unsigned int>      length;
+    std::vector<unsigned int>      parallel_length;
+    std::vector<vertex_descriptor> successor;
+    std::vector<vertex_descriptor> parallel_successor;
+    double t = seconds();
+    for (int i = 0; i != reps; ++i)
+      cs::longest_paths(g, length, successor);
+    const double serial = (seconds() - t) / reps;
+    bool ok = true;
+    t = seconds();
+    for (int i = 0; i != reps; ++i)
+      ok = cs::parallel_longest_paths(g, parallel_length, parallel_successor) && ok;
+    const double parallel = (seconds() - t) / reps;
+    ok = ok && (length == parallel_length) && (successor == parallel_successor);
+
+    std::vector<vertex_descriptor> path;
+    const unsigned int             longest = cs::critical_path(length, successor, std::back_inserter(path));
+    std::cout << "longest_paths (" << n << " vertices, " << num_edges(g) << " edges): "
+	      << serial * 1e3 << " ms, parallel_longest_paths " << parallel * 1e3 << " ms, "
+	      << serial / num_edges(g) * 1e9 << " ns per edge, critical path of " << longest
+	      << " vertices" << (ok ? "" : " MISMATCH") << std::endl;
+    return ok ? 0 : 1;
+  }
+
+} // namespace
+
+// ----
+// main
+// ----
+
+int main (int argc, char* argv[]) {
+  using namespace std;
+
+  if ((argc > 1) && (strcmp(argv[1], "chain") == 0))
+    return stress_chain((argc > 2) ? atoi(argv[2]) : 10000000);
+  if ((argc > 1) && (strcmp(argv[1], "longest") == 0))
+    return time_longest_paths((argc > 2) ? atoi(argv[2]) : 23, (argc > 3) ? atoi(argv[3]) : 12, 1);
+
+  const unsigned int n    = (argc > 1) ? atoi(argv[1]) : 20000;
+  const unsigned int m    = (argc > 2) ? atoi(argv[2]) : 400000;
+  const int          reps = (argc > 3) ? atoi(argv[3]) : 5;
+
+  cs::stats::trace(true);
+  cs::Graph g;
+  random_dag(g, n, m);
+  double t = seconds();
+  cs::CsrGraph c = cs::to_csr(g);
+  t = seconds() - t;
+  cout << num_vertices(g) << " vertices, " << num_edges(g) << " edges, to_csr "
+       << t * 1e3 << " ms" << endl;
+
+  report("has_cycle",        time_has_cycle(g, reps),        time_has_cycle(c, reps));
+  report("topological_sort", time_topological_sort(g, reps), time_topological_sort(c, reps));
+  time_edge_scan(g, reps);
+  {
+    t = seconds();
+    cs::write_graph(c, "bench.bin", true);
+    const double w = seconds() - t;
+    t = seconds();
+    cs::MappedGraph mg("bench.bin");
+    const double o = seconds() - t;
+    t = seconds();
+    const bool verified = cs::MappedGraph("bench.bin", true).is_open();
+    const double v = seconds() - t;
+    cout << "graph file: write " << w * 1e3 << " ms, open " << o * 1e3 << " ms, open and verify "
+	 << v * 1e3 << " ms" << (verified ? "" : " (FAILED)") << endl;
+    report("has_cycle", time_has_cycle(g, reps), time_has_cycle(mg, reps), "MappedGraph");
+    remove("bench.bin");
+  }
+
+  const edge_list es = cs::bench::erdos_renyi(n, m, false, 88675123u);
+  time_scc(n, es, reps);
+  time_load<cs::Graph>("Graph", n, es);
+  time_load<cs::FlatGraph>("FlatGraph", n, es);
+  time_load<cs::HashGraph>("HashGraph", n, es);
+  time_edge_list(n, es);
+  time_arena(n, es);
+  time_reverse(n, es, reps);
+  time_acyclic(n, es);
+  time_dense(2048, reps);
+  time_concurrent(n, es);
+  time_versioned(n, m, reps);
+  time_reorder(18, 16, reps);
+  time_compressed(18, 16, reps);
+  time_sssp(n, es, reps);
+  time_reachability("random DAG", 10 * n, cs::bench::erdos_renyi(10 * n, 30 * n, true, 362436069u), 1000000);
+  time_reachability("R-MAT", 1u << 18, cs::bench::rmat(18, 3u << 18, false, 362436069u), 1000000);
+  time_topological_order(n, cs::bench::erdos_renyi(n, m, true, 2463534242u), reps);
+  time_dag_executor(n, cs::bench::erdos_renyi(n, m, true, 2463534242u), reps);
+  time_longest_paths(20, 16, 1);
+
+#ifdef _OPENMP
+  cout << "parallel_topological_sort with " << omp_get_max_threads() << " threads" << endl;
+#endif
+  report("parallel_topological_sort",
+	 time_parallel_topological_sort(g, reps), time_parallel_topological_sort(c, reps));
+  if (cs::stats::enabled) {
+    ofstream out("bench.trace.json");
+    cs::stats::write_trace(out);
+    cs::stats::write_stats(cout);
+  }
+  return 0;
+}
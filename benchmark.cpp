@@ -0,0 +1,199 @@
+// --------------------------------
+// projects/c++/graph/benchmark.c++
+// Copyright (C) 2009
+// Glenn P. Downing
+// --------------------------------
+
+/*
+  The benchmark suite: cs graphs versus boost::adjacency_list on synthetic
+  graphs, one result row per (graph, implementation, operation).
+
+  To run the suite:
+  make benchmark.app
+  benchmark.app [-n vertices] [-m edges] [-r repetitions] [-s seed]
+                [-g er,rmat,chain,dense] [-f csv|json]
+
+  All generated graphs are DAGs (edges point from the lower to the higher
+  id) so that topological_sort is defined on each of them. There must be
+  at least 2 vertices, and every option takes a value.
+*/
+
+// --------
+// includes
+// --------
+
+#include <cmath>    // ceil, log, sqrt
+#include <cstdlib>  // atoi, strtoul
+#include <cstring>  // strcmp
+#include <iostream> // cerr, cout, endl
+#include <iterator> // back_inserter
+#include <string>   // string
+#include <vector>   // vector
+
+#include "boost/graph/adjacency_list.hpp" // adjacency_list
+
+#include "Benchmark.h"
+#include "Graph.h"
+#include "GraphAlgorithms.h"
+
+namespace {
+
+  using cs::bench::edge_list;
+  using cs::bench::seconds;
+
+  typedef boost::adjacency_list<boost::setS, boost::vecS, boost::directedS> boost_graph;
+
+  // keeps the optimizer from dropping the measured loops
+  volatile std::size_t sink;
+
+  // ---
+  // run
+  // ---
+
+  /**
+   * builds the graph one add_vertex / add_edge at a time, then times the
+   * queries and the algorithms on it
+   */
+  template <typename G>
+  void run (const char* impl, const std::string& graph, unsigned int n, const edge_list& es,
+	    const edge_list& probes, int reps, cs::bench::Results& results) {
+    typedef typename G::edge_iterator edgeit;
+    G* p = new G;
+    G& g = *p;
+
+    double t = seconds();
+    for (unsigned int i = 0; i != n; ++i)
+      add_vertex(g);
+    results.add(graph, n, es.size(), impl, "add_vertex", n, seconds() - t);
+
+    t = seconds();
+    for (std::size_t i = 0; i != es.size(); ++i)
+      add_edge(es[i].first, es[i].second, g);
+    results.add(graph, n, es.size(), impl, "add_edge", es.size(), seconds() - t);
+
+    const std::size_t m = num_edges(g);
+    std::size_t       s = 0;
+
+    t = seconds();
+    for (std::size_t i = 0; i != probes.size(); ++i)
+      s += edge(probes[i].first, probes[i].second, g).second;
+    results.add(graph, n, m, impl, "edge", probes.size(), seconds() - t);
+
+    t = seconds();
+    for (int r = 0; r != reps; ++r) {
+      std::pair<edgeit, edgeit> p = edges(g);
+      for (edgeit b = p.first; b != p.second; ++b)
+	s += target(*b, g);
+    }
+    results.add(graph, n, m, impl, "edges", reps * m, seconds() - t);
+
+    t = seconds();
+    for (int r = 0; r != 100 * reps; ++r)
+      s += num_edges(g);
+    results.add(graph, n, m, impl, "num_edges", 100 * reps, seconds() - t);
+
+    t = seconds();
+    for (int r = 0; r != reps; ++r)
+      s += cs::has_cycle(g);
+    results.add(graph, n, m, impl, "has_cycle", reps, seconds() - t);
+
+    std::vector<typename G::vertex_descriptor> order;
+    order.reserve(n);
+    t = seconds();
+    for (int r = 0; r != reps; ++r) {
+      order.clear();
+      cs::topological_sort(g, std::back_inserter(order));
+      s += order.back();
+    }
+    results.add(graph, n, m, impl, "topological_sort", reps, seconds() - t);
+
+    t = seconds();
+    delete p;
+    results.add(graph, n, m, impl, "teardown", 1, seconds() - t);
+
+    sink = s;
+  }
+
+  // --------
+  // workload
+  // --------
+
+  void workload (const std::string& graph, unsigned int n, const edge_list& es, int reps,
+		 unsigned long seed, cs::bench::Results& results) {
+    // half of the probes hit, half are random pairs
+    cs::bench::Random r(seed + 1);
+    edge_list         probes;
+    for (std::size_t i = 0; (i != es.size()) && (probes.size() < 1000000); ++i)
+      probes.push_back((i % 2) ? es[r.below(es.size())] : edge_list::value_type(r.below(n), r.below(n)));
+    std::cerr << graph << ": " << n << " vertices, " << es.size() << " edges" << std::endl;
+    run<boost_graph>  ("boost::adjacency_list", graph, n, es, probes, reps, results);
+    run<cs::Graph>    ("cs::Graph",             graph, n, es, probes, reps, results);
+    run<cs::FlatGraph>("cs::FlatGraph",         graph, n, es, probes, reps, results);
+    run<cs::HashGraph>("cs::HashGraph",         graph, n, es, probes, reps, results);
+    run<cs::ArenaGraph>("cs::ArenaGraph",       graph, n, es, probes, reps, results);
+  }
+
+} // namespace
+
+// ----
+// main
+// ----
+
+int main (int argc, char* argv[]) {
+  using namespace std;
+
+  unsigned int  n      = 100000;
+  std::size_t   m      = 1000000;
+  int           reps   = 3;
+  unsigned long seed   = 2009;
+  string        graphs = "er,rmat,chain,dense";
+  string        format = "csv";
+  for (int i = 1; i < argc; i += 2) {
+    if (i + 1 == argc) {
+      cerr << "option " << argv[i] << " needs a value" << endl;
+      return 1;
+    }
+    if (strcmp(argv[i], "-n") == 0)
+      n = strtoul(argv[i + 1], 0, 10);
+    else if (strcmp(argv[i], "-m") == 0)
+      m = strtoul(argv[i + 1], 0, 10);
+    else if (strcmp(argv[i], "-r") == 0)
+      reps = atoi(argv[i + 1]);
+    else if (strcmp(argv[i], "-s") == 0)
+      seed = strtoul(argv[i + 1], 0, 10);
+    else if (strcmp(argv[i], "-g") == 0)
+      graphs = argv[i + 1];
+    else if (strcmp(argv[i], "-f") == 0)
+      format = argv[i + 1];
+    else {
+      cerr << "unknown option " << argv[i] << endl;
+      return 1;
+    }
+  }
+  if (n < 2) {
+    // erdos_renyi and rmat need two vertices to draw an edge
+    cerr << "-n must be at least 2" << endl;
+    return 1;
+  }
+
+  cs::bench::Results results;
+  if (graphs.find("er") != string::npos)
+    workload("erdos_renyi", n, cs::bench::erdos_renyi(n, m, true, seed), reps, seed, results);
+  if (graphs.find("rmat") != string::npos) {
+    const unsigned int scale = static_cast<unsigned int>(ceil(log(static_cast<double>(n)) / log(2.0)));
+    workload("rmat", 1u << scale, cs::bench::rmat(scale, m, true, seed), reps, seed, results);
+  }
+  if (graphs.find("chain") != string::npos)
+    workload("chain", n, cs::bench::chain(n), reps, seed, results);
+  if (graphs.find("dense") != string::npos) {
+    // p = 1/2, so about sqrt(4 m) vertices give m edges
+    const unsigned int d = static_cast<unsigned int>(sqrt(4.0 * m));
+    workload("dense_dag", d, cs::bench::dense_dag(d, 0.5, seed), reps, seed, results);
+  }
+
+  if (format == "json")
+    results.write_json(cout);
+  else
+    results.write_csv(cout);
+  return 0;
+}
@@ -33,8 +33,30 @@
 #include "cppunit/TestSuite.h"      // TestSuite
 #include "cppunit/TextTestRunner.h" // TestRunner
 
+#include "AcyclicGraph.h"
+#include "BidirectionalGraph.h"
+#include "CompressedGraph.h"
+#include "ConcurrentGraph.h"
+#include "DenseGraph.h"
 #include "Graph.h"
+#include "ReachabilityIndex.h"
+#include "TestAcyclicGraph.h"
+#include "TestArena.h"
+#include "TestBasicGraph.h"
+#include "TestBidirectionalGraph.h"
+#include "TestCompressedGraph.h"
+#include "TestDagExecutor.h"
+#include "TestConcurrentGraph.h"
+#include "TestDenseGraph.h"
 #include "TestGraph.h"
+#include "TestGraphStats.h"
+#include "TestReachabilityIndex.h"
+#include "TestReordering.h"
+#include "TestTopologicalOrder.h"
+#include "TestVersionedGraph.h"
+#include "TestWeightedGraph.h"
+#include "VersionedGraph.h"
+#include "WeightedGraph.h"
 
 // ----
 // main
@@ -53,6 +75,31 @@ int main () {
   CppUnit::TextTestRunner tr;
   tr.addTest(TestGraph< adjacency_list<setS, vecS, directedS> >::suite());
   tr.addTest(TestGraph<cs::Graph>::suite());
+  tr.addTest(TestGraph<cs::FlatGraph>::suite());
+  tr.addTest(TestGraph<cs::HashGraph>::suite());
+  tr.addTest(TestGraph<cs::ArenaGraph>::suite());
+  tr.addTest(TestGraph<cs::BidirectionalGraph>::suite());
+  tr.addTest(TestGraph<cs::ConcurrentGraph>::suite());
+  tr.addTest(TestGraph<cs::WeightedGraph>::suite());
+  tr.addTest(TestBasicGraph<cs::Graph>::suite());
+  tr.addTest(TestBasicGraph<cs::FlatGraph>::suite());
+  tr.addTest(TestBasicGraph<cs::HashGraph>::suite());
+  tr.addTest(TestBasicGraph<cs::ArenaGraph>::suite());
+  tr.addTest(TestBidirectionalGraph< adjacency_list<setS, vecS, bidirectionalS> >::suite());
+  tr.addTest(TestBidirectionalGraph<cs::BidirectionalGraph>::suite());
+  tr.addTest(TestAcyclicGraph::suite());
+  tr.addTest(TestArena::suite());
+  tr.addTest(TestDenseGraph::suite());
+  tr.addTest(TestConcurrentGraph::suite());
+  tr.addTest(TestVersionedGraph::suite());
+  tr.addTest(TestReordering::suite());
+  tr.addTest(TestCompressedGraph<cs::CompressedGraph>::suite());
+  tr.addTest(TestCompressedGraph<cs::GroupCompressedGraph>::suite());
+  tr.addTest(TestGraphStats::suite());
+  tr.addTest(TestWeightedGraph::suite());
+  tr.addTest(TestReachabilityIndex::suite());
+  tr.addTest(TestTopologicalOrder::suite());
+  tr.addTest(TestDagExecutor::suite());
   tr.run();
 
   cout << "Done." << endl;